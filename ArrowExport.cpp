@@ -0,0 +1,159 @@
+#include "ArrowExport.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Column {
+    const char* name;
+    const char* format;
+    const void* data;
+};
+
+// Keeps the exported series alive until the parent and every child are released
+// (consumers may move children out and release them separately).
+using Owner = std::shared_ptr<void>;
+
+struct ChildArrayData {
+    Owner owner;
+    const void* buffers[2];
+};
+
+struct ArrayData {
+    Owner owner;
+    const void* buffers[1];
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> childPointers;
+};
+
+struct SchemaData {
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> childPointers;
+};
+
+void releaseChildArray(ArrowArray* array) {
+    delete static_cast<ChildArrayData*>(array->private_data);
+    array->release = nullptr;
+}
+
+void releaseArray(ArrowArray* array) {
+    ArrayData* data = static_cast<ArrayData*>(array->private_data);
+    for (ArrowArray* child : data->childPointers) {
+        if (child->release) child->release(child);
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+void releaseChildSchema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+
+void releaseSchema(ArrowSchema* schema) {
+    SchemaData* data = static_cast<SchemaData*>(schema->private_data);
+    for (ArrowSchema* child : data->childPointers) {
+        if (child->release) child->release(child);
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+void exportColumns(Owner owner, size_t length, const std::vector<Column>& columns, ArrowArray* array,
+                   ArrowSchema* schema) {
+    const int64_t n = static_cast<int64_t>(columns.size());
+
+    // Names and formats are string literals, so child schemas need no private data.
+    std::unique_ptr<SchemaData> schemaData(new SchemaData);
+    schemaData->children.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        ArrowSchema& c = schemaData->children[i];
+        c.format = columns[i].format;
+        c.name = columns[i].name;
+        c.metadata = nullptr;
+        c.flags = 0;
+        c.n_children = 0;
+        c.children = nullptr;
+        c.dictionary = nullptr;
+        c.release = releaseChildSchema;
+        c.private_data = nullptr;
+        schemaData->childPointers.push_back(&c);
+    }
+
+    std::unique_ptr<ArrayData> arrayData(new ArrayData);
+    arrayData->owner = owner;
+    arrayData->buffers[0] = nullptr; // no validity bitmap
+    arrayData->children.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        ChildArrayData* childData = new ChildArrayData{owner, {nullptr, columns[i].data}};
+        ArrowArray& c = arrayData->children[i];
+        c.length = static_cast<int64_t>(length);
+        c.null_count = 0;
+        c.offset = 0;
+        c.n_buffers = 2;
+        c.n_children = 0;
+        c.buffers = childData->buffers;
+        c.children = nullptr;
+        c.dictionary = nullptr;
+        c.release = releaseChildArray;
+        c.private_data = childData;
+        arrayData->childPointers.push_back(&c);
+    }
+
+    schema->format = "+s";
+    schema->name = "";
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = n;
+    schema->children = schemaData->childPointers.data();
+    schema->dictionary = nullptr;
+    schema->release = releaseSchema;
+    schema->private_data = schemaData.release();
+
+    array->length = static_cast<int64_t>(length);
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = 1;
+    array->n_children = n;
+    array->buffers = arrayData->buffers;
+    array->children = arrayData->childPointers.data();
+    array->dictionary = nullptr;
+    array->release = releaseArray;
+    array->private_data = arrayData.release();
+}
+
+const char* const TIMESTAMP_FORMAT = "tsm:UTC";
+const char* const FLOAT64_FORMAT = "g";
+
+} // namespace
+
+void exportArrow(TickSeries&& ticks, ArrowArray* array, ArrowSchema* schema) {
+    std::shared_ptr<TickSeries> owned = std::make_shared<TickSeries>(std::move(ticks));
+    exportColumns(owned, owned->size(),
+                  {{"timestamp", TIMESTAMP_FORMAT, owned->timestampMs.data()},
+                   {"bid", FLOAT64_FORMAT, owned->bid.data()},
+                   {"ask", FLOAT64_FORMAT, owned->ask.data()},
+                   {"mid", FLOAT64_FORMAT, owned->mid.data()}},
+                  array, schema);
+}
+
+void exportArrow(const TickSeries& ticks, ArrowArray* array, ArrowSchema* schema) {
+    exportArrow(TickSeries(ticks), array, schema);
+}
+
+void exportArrow(BarSeries&& bars, ArrowArray* array, ArrowSchema* schema) {
+    std::shared_ptr<BarSeries> owned = std::make_shared<BarSeries>(std::move(bars));
+    exportColumns(owned, owned->size(),
+                  {{"timestamp", TIMESTAMP_FORMAT, owned->timestampMs.data()},
+                   {"open", FLOAT64_FORMAT, owned->open.data()},
+                   {"high", FLOAT64_FORMAT, owned->high.data()},
+                   {"low", FLOAT64_FORMAT, owned->low.data()},
+                   {"close", FLOAT64_FORMAT, owned->close.data()}},
+                  array, schema);
+}
+
+void exportArrow(const BarSeries& bars, ArrowArray* array, ArrowSchema* schema) {
+    exportArrow(BarSeries(bars), array, schema);
+}
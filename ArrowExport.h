@@ -0,0 +1,69 @@
+#ifndef TRADERMADE_ARROW_EXPORT_H
+#define TRADERMADE_ARROW_EXPORT_H
+
+#include <cstdint>
+#include "TraderMadeTypes.h"
+
+// Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+// The structs are ABI-stable and defined here so no Arrow library is needed; the
+// guard matches the one in Arrow's own abi.h so both can be included together.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+// Exports a TickSeries / BarSeries as an Arrow record batch: a struct array with one
+// non-nullable child per column, "timestamp" as timestamp[ms, UTC] and the prices
+// as float64. pyarrow, polars and DuckDB can import it without copying:
+//
+//   BarSeries bars;
+//   decodeBars(tm.getTimeSeriesData<TimeSeriesInterval::Daily, 1>("EURUSD", "2025-01-01", "2025-12-31"), bars);
+//   ArrowArray array;
+//   ArrowSchema schema;
+//   exportArrow(std::move(bars), &array, &schema);
+//   // Python: pyarrow.RecordBatch._import_from_c(array_address, schema_address)
+//
+// The rvalue overloads take ownership of the columns, and the consumer's buffers are
+// the vectors' own storage, freed by the release callbacks. The const overloads copy
+// the series first. Both fill caller-provided structs that the consumer must release.
+//
+// Tick columns: timestamp, bid, ask, mid. Bar columns: timestamp, open, high, low, close.
+void exportArrow(TickSeries&& ticks, ArrowArray* array, ArrowSchema* schema);
+void exportArrow(const TickSeries& ticks, ArrowArray* array, ArrowSchema* schema);
+void exportArrow(BarSeries&& bars, ArrowArray* array, ArrowSchema* schema);
+void exportArrow(const BarSeries& bars, ArrowArray* array, ArrowSchema* schema);
+
+#endif
@@ -0,0 +1,345 @@
+#include "ArrowIpcWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include "TraderMadeDecode.h"
+
+namespace {
+
+// Minimal FlatBuffers builder. Like the reference implementation it builds back to
+// front, so offsets (which must point forward) refer to objects already written;
+// positions are measured from the end of the buffer.
+class FlatBuilder {
+public:
+    uint32_t size() const { return static_cast<uint32_t>(buf.size() - head); }
+
+    // Pads so that size() is a multiple of alignment once `extra` more bytes are written.
+    void align(size_t alignment, size_t extra = 0) {
+        minAlign = std::max(minAlign, alignment);
+        size_t padding = (alignment - (size() + extra) % alignment) % alignment;
+        if (padding == 0) return;
+        reserve(padding);
+        head -= padding;
+        std::memset(buf.data() + head, 0, padding);
+    }
+
+    template <typename T>
+    void push(T value) {
+        pushBytes(&value, sizeof(value));
+    }
+
+    void pushBytes(const void* data, size_t n) {
+        reserve(n);
+        head -= n;
+        if (n > 0) std::memcpy(buf.data() + head, data, n);
+    }
+
+    void offset(uint32_t target) {
+        align(4);
+        push<uint32_t>(size() + 4 - target);
+    }
+
+    uint32_t string(const std::string& s) {
+        align(4, s.size() + 1);
+        push<uint8_t>(0);
+        pushBytes(s.data(), s.size());
+        push<uint32_t>(static_cast<uint32_t>(s.size()));
+        return size();
+    }
+
+    uint32_t offsetVector(const std::vector<uint32_t>& items) {
+        align(4, items.size() * 4);
+        for (size_t i = items.size(); i-- > 0;) offset(items[i]);
+        push<uint32_t>(static_cast<uint32_t>(items.size()));
+        return size();
+    }
+
+    // Vector of 8-byte aligned structs laid out as in the schema.
+    template <typename Struct>
+    uint32_t structVector(const std::vector<Struct>& items) {
+        align(4, items.size() * sizeof(Struct));
+        align(8, items.size() * sizeof(Struct));
+        for (size_t i = items.size(); i-- > 0;) pushBytes(&items[i], sizeof(Struct));
+        push<uint32_t>(static_cast<uint32_t>(items.size()));
+        return size();
+    }
+
+    // Tables: children (strings, vectors, tables) must be built before startTable().
+    void startTable() {
+        fields.clear();
+        tableStart = size();
+    }
+
+    template <typename T>
+    void field(int id, T value) {
+        align(sizeof(T));
+        push(value);
+        fields.push_back(Field{id, size()});
+    }
+
+    void fieldOffset(int id, uint32_t target) {
+        offset(target);
+        fields.push_back(Field{id, size()});
+    }
+
+    uint32_t endTable() {
+        align(4);
+        push<int32_t>(0); // vtable offset, patched below
+        const uint32_t table = size();
+        int slots = 0;
+        for (const Field& f : fields) slots = std::max(slots, f.id + 1);
+        std::vector<uint16_t> vtable(static_cast<size_t>(slots), 0);
+        for (const Field& f : fields) vtable[static_cast<size_t>(f.id)] = static_cast<uint16_t>(table - f.position);
+        for (size_t i = vtable.size(); i-- > 0;) push<uint16_t>(vtable[i]);
+        push<uint16_t>(static_cast<uint16_t>(table - tableStart));
+        push<uint16_t>(static_cast<uint16_t>(4 + 2 * vtable.size()));
+        const int32_t toVtable = static_cast<int32_t>(size() - table);
+        std::memcpy(buf.data() + (buf.size() - table), &toVtable, sizeof(toVtable));
+        return table;
+    }
+
+    std::vector<uint8_t> finish(uint32_t root) {
+        align(std::max<size_t>(minAlign, 8), 4);
+        offset(root);
+        return std::vector<uint8_t>(buf.begin() + static_cast<std::ptrdiff_t>(head), buf.end());
+    }
+
+private:
+    struct Field {
+        int id;
+        uint32_t position;
+    };
+
+    std::vector<uint8_t> buf;
+    size_t head = 0;
+    size_t minAlign = 1;
+    uint32_t tableStart = 0;
+    std::vector<Field> fields;
+
+    void reserve(size_t n) {
+        if (head >= n) return;
+        const size_t used = buf.size() - head;
+        size_t capacity = std::max<size_t>(buf.size() * 2, 256);
+        while (capacity - used < n) capacity *= 2;
+        std::vector<uint8_t> grown(capacity);
+        if (used > 0) std::memcpy(grown.data() + (capacity - used), buf.data() + head, used);
+        buf.swap(grown);
+        head = capacity - used;
+    }
+};
+
+// Arrow flatbuffer enums and structs (format/Schema.fbs, Message.fbs, File.fbs).
+const int16_t METADATA_V5 = 4;
+const uint8_t TYPE_FLOATING_POINT = 3;
+const uint8_t TYPE_TIMESTAMP = 10;
+const int16_t PRECISION_DOUBLE = 2;
+const int16_t TIME_UNIT_MILLISECOND = 1;
+const uint8_t HEADER_SCHEMA = 1;
+const uint8_t HEADER_RECORD_BATCH = 3;
+
+struct FieldNode {
+    int64_t length;
+    int64_t nullCount;
+};
+
+struct BufferRef {
+    int64_t offset;
+    int64_t length;
+};
+
+struct FooterBlock {
+    int64_t offset;
+    int32_t metaDataLength;
+    int32_t padding;
+    int64_t bodyLength;
+};
+
+const char FILE_MAGIC[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+
+const char* const TICK_COLUMNS[] = {"timestamp", "bid", "ask", "mid"};
+const char* const BAR_COLUMNS[] = {"timestamp", "open", "high", "low", "close"};
+
+uint32_t buildSchema(FlatBuilder& b, ArrowFileWriter::Layout layout) {
+    const bool ticks = layout == ArrowFileWriter::Layout::Ticks;
+    const size_t count = ticks ? 4 : 5;
+    const char* const* names = ticks ? TICK_COLUMNS : BAR_COLUMNS;
+
+    std::vector<uint32_t> fields;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t name = b.string(names[i]);
+        uint32_t type;
+        if (i == 0) {
+            uint32_t timezone = b.string("UTC");
+            b.startTable();
+            b.field<int16_t>(0, TIME_UNIT_MILLISECOND);
+            b.fieldOffset(1, timezone);
+            type = b.endTable();
+        } else {
+            b.startTable();
+            b.field<int16_t>(0, PRECISION_DOUBLE);
+            type = b.endTable();
+        }
+        uint32_t children = b.offsetVector({});
+        b.startTable();
+        b.fieldOffset(0, name);
+        b.field<uint8_t>(1, 0); // not nullable
+        b.field<uint8_t>(2, i == 0 ? TYPE_TIMESTAMP : TYPE_FLOATING_POINT);
+        b.fieldOffset(3, type);
+        b.fieldOffset(5, children);
+        fields.push_back(b.endTable());
+    }
+    uint32_t fieldVector = b.offsetVector(fields);
+    b.startTable();
+    b.field<int16_t>(0, 0); // little endian
+    b.fieldOffset(1, fieldVector);
+    return b.endTable();
+}
+
+std::vector<uint8_t> buildMessage(FlatBuilder& b, uint8_t headerType, uint32_t header, int64_t bodyLength) {
+    b.startTable();
+    b.field<int16_t>(0, METADATA_V5);
+    b.field<uint8_t>(1, headerType);
+    b.fieldOffset(2, header);
+    b.field<int64_t>(3, bodyLength);
+    return b.finish(b.endTable());
+}
+
+} // namespace
+
+ArrowFileWriter::ArrowFileWriter(const std::string& path, Layout layout) : path(path), fileLayout(layout) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot create " + path + ": " + std::strerror(errno));
+    }
+    writeBytes(FILE_MAGIC, sizeof(FILE_MAGIC));
+    FlatBuilder b;
+    uint32_t schema = buildSchema(b, fileLayout);
+    writeMessage(buildMessage(b, HEADER_SCHEMA, schema, 0));
+}
+
+ArrowFileWriter::~ArrowFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void ArrowFileWriter::write(const TickSeries& ticks) {
+    if (fileLayout != Layout::Ticks) {
+        throw std::invalid_argument("ArrowFileWriter: tick series written to a bar file.");
+    }
+    writeBatch(ticks.size(), {ticks.timestampMs.data(), ticks.bid.data(), ticks.ask.data(), ticks.mid.data()});
+}
+
+void ArrowFileWriter::write(const BarSeries& bars) {
+    if (fileLayout != Layout::Bars) {
+        throw std::invalid_argument("ArrowFileWriter: bar series written to a tick file.");
+    }
+    writeBatch(bars.size(),
+               {bars.timestampMs.data(), bars.open.data(), bars.high.data(), bars.low.data(), bars.close.data()});
+}
+
+size_t ArrowFileWriter::writeResponse(const nlohmann::json& body) {
+    if (fileLayout == Layout::Ticks) {
+        TickSeries ticks;
+        decodeTicks(body, ticks);
+        write(ticks);
+        return ticks.size();
+    }
+    BarSeries bars;
+    decodeBars(body, bars);
+    write(bars);
+    return bars.size();
+}
+
+void ArrowFileWriter::close() {
+    if (!file) {
+        return;
+    }
+    const uint32_t endOfStream[2] = {0xFFFFFFFFu, 0};
+    writeBytes(endOfStream, sizeof(endOfStream));
+
+    std::vector<FooterBlock> batchBlocks;
+    for (const Block& block : blocks) {
+        batchBlocks.push_back(FooterBlock{block.offset, block.metaDataLength, 0, block.bodyLength});
+    }
+    FlatBuilder b;
+    uint32_t schema = buildSchema(b, fileLayout);
+    uint32_t dictionaries = b.structVector(std::vector<FooterBlock>());
+    uint32_t recordBatches = b.structVector(batchBlocks);
+    b.startTable();
+    b.field<int16_t>(0, METADATA_V5);
+    b.fieldOffset(1, schema);
+    b.fieldOffset(2, dictionaries);
+    b.fieldOffset(3, recordBatches);
+    std::vector<uint8_t> footer = b.finish(b.endTable());
+
+    writeBytes(footer.data(), footer.size());
+    const int32_t footerLength = static_cast<int32_t>(footer.size());
+    writeBytes(&footerLength, sizeof(footerLength));
+    writeBytes(FILE_MAGIC, 6);
+
+    std::FILE* f = file;
+    file = nullptr;
+    if (std::fclose(f) != 0) {
+        throw std::runtime_error("Cannot close " + path + ": " + std::strerror(errno));
+    }
+}
+
+void ArrowFileWriter::writeBatch(size_t length, const std::vector<const void*>& columns) {
+    if (!file) {
+        throw std::logic_error("ArrowFileWriter: write after close().");
+    }
+    if (length == 0) {
+        return;
+    }
+    // Body: one 8-byte column after another (already 8-byte multiples); no validity bitmaps.
+    const int64_t columnBytes = static_cast<int64_t>(length) * 8;
+    std::vector<FieldNode> nodes;
+    std::vector<BufferRef> buffers;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        nodes.push_back(FieldNode{static_cast<int64_t>(length), 0});
+        buffers.push_back(BufferRef{static_cast<int64_t>(i) * columnBytes, 0});
+        buffers.push_back(BufferRef{static_cast<int64_t>(i) * columnBytes, columnBytes});
+    }
+    const int64_t bodyLength = columnBytes * static_cast<int64_t>(columns.size());
+
+    FlatBuilder b;
+    uint32_t nodeVector = b.structVector(nodes);
+    uint32_t bufferVector = b.structVector(buffers);
+    b.startTable();
+    b.field<int64_t>(0, static_cast<int64_t>(length));
+    b.fieldOffset(1, nodeVector);
+    b.fieldOffset(2, bufferVector);
+    uint32_t batch = b.endTable();
+
+    Block block;
+    block.offset = static_cast<int64_t>(position);
+    writeMessage(buildMessage(b, HEADER_RECORD_BATCH, batch, bodyLength));
+    block.metaDataLength = static_cast<int32_t>(static_cast<int64_t>(position) - block.offset);
+    block.bodyLength = bodyLength;
+    for (const void* column : columns) {
+        writeBytes(column, static_cast<size_t>(columnBytes));
+    }
+    blocks.push_back(block);
+    rowCount += length;
+}
+
+// Encapsulated message: continuation marker, metadata length, flatbuffer padded to 8.
+void ArrowFileWriter::writeMessage(const std::vector<uint8_t>& metadata) {
+    const size_t padded = (metadata.size() + 7) / 8 * 8;
+    const uint32_t prefix[2] = {0xFFFFFFFFu, static_cast<uint32_t>(padded)};
+    const uint8_t zeros[8] = {0};
+    writeBytes(prefix, sizeof(prefix));
+    writeBytes(metadata.data(), metadata.size());
+    writeBytes(zeros, padded - metadata.size());
+}
+
+void ArrowFileWriter::writeBytes(const void* data, size_t size) {
+    if (size > 0 && std::fwrite(data, 1, size, file) != size) {
+        throw std::runtime_error("Write failed: " + path);
+    }
+    position += size;
+}
@@ -0,0 +1,72 @@
+#ifndef TRADERMADE_ARROW_IPC_WRITER_H
+#define TRADERMADE_ARROW_IPC_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "TraderMadeTypes.h"
+
+// Writes tick or bar series to an Arrow IPC file (Feather v2), one record batch per
+// write(), so a long download can be streamed to disk chunk by chunk:
+//
+//   ArrowFileWriter file("eurusd_ticks.arrow", ArrowFileWriter::Layout::Ticks);
+//   for (each hour) file.writeResponse(tm.getTickHistoricalData("EURUSD", from, to, "json"));
+//   file.close();
+//   // Python: pyarrow.feather.read_table("eurusd_ticks.arrow"), or polars.read_ipc(...)
+//
+// Columns are the same as exportArrow() (ArrowExport.h): "timestamp" as
+// timestamp[ms, UTC], then bid/ask/mid or open/high/low/close as float64. The
+// writer is self-contained (the FlatBuffers metadata is encoded by hand) and
+// writes uncompressed little-endian buffers. The file is readable only after
+// close(), which writes the footer; the destructor closes too.
+class ArrowFileWriter {
+public:
+    enum class Layout {
+        Ticks,
+        Bars
+    };
+
+    // Creates (truncates) path and writes the schema. Throws std::runtime_error on I/O errors.
+    ArrowFileWriter(const std::string& path, Layout layout);
+    ~ArrowFileWriter();
+
+    ArrowFileWriter(const ArrowFileWriter&) = delete;
+    ArrowFileWriter& operator=(const ArrowFileWriter&) = delete;
+
+    // Appends one record batch; empty series are skipped. Throws std::invalid_argument
+    // if the series does not match the layout.
+    void write(const TickSeries& ticks);
+    void write(const BarSeries& bars);
+    // Decodes a /tick_historical (format=json) or /timeseries (format=records)
+    // response, depending on the layout, and writes it. Returns the rows written.
+    size_t writeResponse(const nlohmann::json& body);
+
+    void close();
+
+    Layout layout() const { return fileLayout; }
+    size_t batches() const { return blocks.size(); }
+    uint64_t rows() const { return rowCount; }
+    uint64_t bytesWritten() const { return position; }
+
+private:
+    struct Block {
+        int64_t offset;
+        int32_t metaDataLength;
+        int64_t bodyLength;
+    };
+
+    std::FILE* file = nullptr;
+    std::string path;
+    Layout fileLayout;
+    std::vector<Block> blocks;
+    uint64_t rowCount = 0;
+    uint64_t position = 0;
+
+    void writeBatch(size_t length, const std::vector<const void*>& columns);
+    void writeBytes(const void* data, size_t size);
+    void writeMessage(const std::vector<uint8_t>& metadata);
+};
+
+#endif
@@ -0,0 +1,418 @@
+#include "BackfillEngine.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "MarketCalendar.h"
+#include "Resample.h"
+#include "TimeSeriesStore.h"
+#include "TraderMadeDecode.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// GCRA limiter: requests are spaced 1/rate apart, with up to `burst` allowed early.
+class RateLimiter {
+public:
+    RateLimiter(double perSecond, double burst) {
+        if (perSecond > 0) {
+            interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / perSecond));
+            tolerance = std::chrono::duration_cast<Clock::duration>(interval * std::max(0.0, burst - 1.0));
+        }
+    }
+
+    // Returns false if the token was cancelled while waiting.
+    bool acquire(const CancellationToken& token) {
+        if (interval == Clock::duration::zero()) {
+            return true;
+        }
+        Clock::time_point at;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Clock::time_point now = Clock::now();
+            if (tat < now) tat = now;
+            at = tat - tolerance;
+            tat += interval;
+        }
+        Clock::time_point now = Clock::now();
+        return at <= now || !token.waitFor(at - now);
+    }
+
+private:
+    std::mutex mutex;
+    Clock::duration interval = Clock::duration::zero();
+    Clock::duration tolerance = Clock::duration::zero();
+    Clock::time_point tat;
+};
+
+struct Task {
+    size_t symbol;
+    size_t chunk;
+};
+
+// One queue per worker. Workers take from the front of their own queue and, when it
+// is empty, from the front of another's, so chunks are processed roughly in time
+// order and few finished chunks wait for an earlier one of the same symbol.
+class WorkQueues {
+public:
+    explicit WorkQueues(size_t workers) : queues(workers) {}
+
+    void push(size_t worker, const Task& task) { queues[worker].tasks.push_back(task); }
+
+    bool pop(size_t worker, Task& task, bool& stolen) {
+        for (size_t i = 0; i < queues.size(); ++i) {
+            Queue& q = queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                stolen = i != 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<Queue> queues;
+};
+
+// "tradermade-backfill 1 <job key>" followed by "<SYMBOL> <delivered until ms>" lines.
+class Checkpoint {
+public:
+    Checkpoint(const std::string& path, const std::string& key) : path(path), key(key) {
+        std::ifstream in(path);
+        std::string magic, version, fileKey;
+        if (!in || !(in >> magic >> version >> fileKey) || magic != "tradermade-backfill" || version != "1" ||
+            fileKey != key) {
+            return;
+        }
+        std::string symbol;
+        int64_t until;
+        while (in >> symbol >> until) {
+            done[symbol] = until;
+        }
+    }
+
+    int64_t deliveredUntil(const std::string& symbol) const {
+        auto it = done.find(symbol);
+        return it == done.end() ? INT64_MIN : it->second;
+    }
+
+    void set(const std::string& symbol, int64_t until) { done[symbol] = until; }
+
+    void save() const {
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << "tradermade-backfill 1 " << key << '\n';
+            for (const auto& kv : done) {
+                out << kv.first << ' ' << kv.second << '\n';
+            }
+            out.flush();
+            if (!out) {
+                throw std::runtime_error("Cannot write checkpoint " + tmp);
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(path.c_str()); // Windows does not replace on rename
+            if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+                throw std::runtime_error("Cannot replace checkpoint " + path);
+            }
+        }
+    }
+
+private:
+    std::string path;
+    std::string key;
+    std::map<std::string, int64_t> done;
+};
+
+bool retryable(const RequestError& e) {
+    return e.code == ErrorCode::Transport || e.code == ErrorCode::CircuitOpen ||
+           (e.code == ErrorCode::HttpStatus && (e.status == 429 || e.status >= 500));
+}
+
+void decodeInto(const ArenaJson& body, TickSeries& out) {
+    decodeTicks(body, out);
+}
+
+void decodeInto(const ArenaJson& body, BarSeries& out) {
+    decodeBars(body, out);
+}
+
+// Drops rows outside [from, to) (chunk edges can overlap the neighbouring chunk).
+void keepRange(TickSeries& s, int64_t from, int64_t to) {
+    TickSeries kept;
+    kept.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s.timestampMs[i] >= from && s.timestampMs[i] < to) {
+            kept.push_back(s.timestampMs[i], s.bid[i], s.ask[i], s.mid[i]);
+        }
+    }
+    if (kept.size() != s.size()) s = std::move(kept);
+}
+
+void keepRange(BarSeries& s, int64_t from, int64_t to) {
+    BarSeries kept;
+    kept.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s.timestampMs[i] >= from && s.timestampMs[i] < to) {
+            kept.push_back(s.timestampMs[i], s.open[i], s.high[i], s.low[i], s.close[i]);
+        }
+    }
+    if (kept.size() != s.size()) s = std::move(kept);
+}
+
+} // namespace
+
+BackfillEngine::BackfillEngine(TraderMade& tm) : BackfillEngine(tm, Options()) {}
+
+BackfillEngine::BackfillEngine(TraderMade& tm, const Options& options) : tm(tm), options(options) {
+    if (options.threads == 0 || options.maxAttempts < 1 || options.tickChunkMs <= 0 || options.dailyChunkMs <= 0 ||
+        options.hourlyChunkMs <= 0 || options.minuteChunkMs <= 0) {
+        throw std::invalid_argument("BackfillEngine needs threads, maxAttempts and chunk sizes above zero.");
+    }
+}
+
+void BackfillEngine::cancel() {
+    std::lock_guard<std::mutex> lock(runMutex);
+    runToken.cancel();
+}
+
+BackfillEngine::Report BackfillEngine::runTicks(const Job& job, const TickSink& sink, const CancellationToken& token) {
+    auto fetch = [this](JsonArena& arena, const std::string& symbol, int64_t from, int64_t to) {
+        return tm.tryGetTickHistoricalData(arena, symbol, formatApiTime(from, true), formatApiTime(to, true), "json");
+    };
+    std::ostringstream key;
+    key << "ticks/" << job.startMs << '/' << job.endMs << '/' << options.tickChunkMs;
+    return run<TickSeries>(job, options.tickChunkMs, 60000, key.str(), fetch, sink, token);
+}
+
+BackfillEngine::Report BackfillEngine::runBars(const Job& job, const BarSink& sink, const CancellationToken& token) {
+    if (!isValidTimeSeriesPeriod(job.interval, job.period)) {
+        throw std::invalid_argument("Invalid period for this interval.");
+    }
+    const int64_t width = TimeSeriesStore::barWidthMs(job.interval, job.period);
+    const bool intraday = job.interval != TimeSeriesInterval::Daily;
+    const std::string interval = toApiString(job.interval);
+    const std::string period = std::to_string(job.period);
+    auto fetch = [=](JsonArena& arena, const std::string& symbol, int64_t from, int64_t to) {
+        // end_date is inclusive: ask up to the open of the chunk's last bar
+        return tm.tryGetTimeSeriesData(arena, symbol, formatApiTime(from, intraday),
+                                       formatApiTime(to - width, intraday), interval, period, "records");
+    };
+    const int64_t chunkMs = job.interval == TimeSeriesInterval::Daily  ? options.dailyChunkMs
+                          : job.interval == TimeSeriesInterval::Hourly ? options.hourlyChunkMs
+                          :                                              options.minuteChunkMs;
+    std::ostringstream key;
+    key << "bars/" << interval << '/' << period << '/' << job.startMs << '/' << job.endMs << '/' << chunkMs;
+    return run<BarSeries>(job, chunkMs, width, key.str(), fetch, sink, token);
+}
+
+template <typename Series, typename Fetch>
+BackfillEngine::Report BackfillEngine::run(const Job& job, int64_t chunkMs, int64_t width, const std::string& jobKey,
+                                           Fetch fetch,
+                                           const std::function<void(const std::string&, const Series&)>& sink,
+                                           const CancellationToken& external) {
+    if (job.symbols.empty() || job.endMs <= job.startMs || !sink) {
+        throw std::invalid_argument("Backfill job needs symbols, startMs < endMs and a sink.");
+    }
+    // A fresh token per run, cancelled by cancel() or by the caller's token.
+    CancellationToken cancelled;
+    {
+        std::lock_guard<std::mutex> lock(runMutex);
+        runToken = cancelled;
+    }
+    struct Link {
+        const CancellationToken& from;
+        size_t id;
+        ~Link() { from.unsubscribe(id); }
+    } link{external, external.subscribe([cancelled] { cancelled.cancel(); })};
+    const Clock::time_point started = Clock::now();
+    Report report;
+
+    // Chunk boundaries are a pure function of the job, so a resumed run lines up.
+    chunkMs = std::max(width, chunkMs / width * width);
+    std::vector<std::pair<int64_t, int64_t>> chunks;
+    const int64_t end = bucketStart(job.endMs - 1, width) + width;
+    for (int64_t a = bucketStart(job.startMs, width); a < end; a += chunkMs) {
+        chunks.emplace_back(a, std::min(a + chunkMs, end));
+    }
+
+    struct Ready {
+        Series data;
+        bool closed;
+    };
+    struct SymbolState {
+        size_t next = 0; // next chunk to hand to the sink
+        std::map<size_t, Ready> ready;
+        bool failed = false;
+    };
+    const std::vector<std::string>& symbols = job.symbols;
+    std::vector<SymbolState> states(symbols.size());
+    std::unique_ptr<Checkpoint> checkpoint;
+    if (!options.checkpointPath.empty()) {
+        checkpoint.reset(new Checkpoint(options.checkpointPath, jobKey));
+    }
+
+    const size_t workers = std::min(options.threads, symbols.size() * chunks.size());
+    WorkQueues queues(std::max<size_t>(workers, 1));
+    size_t scheduled = 0;
+    for (size_t k = 0; k < chunks.size(); ++k) {
+        for (size_t s = 0; s < symbols.size(); ++s) {
+            if (checkpoint && chunks[k].second <= checkpoint->deliveredUntil(symbols[s])) {
+                states[s].next = k + 1;
+                ++report.resumed;
+                continue;
+            }
+            queues.push(scheduled++ % std::max<size_t>(workers, 1), Task{s, k});
+        }
+    }
+    report.tasks = scheduled;
+
+    RateLimiter limiter(options.requestsPerSecond, options.burst);
+    std::mutex deliveryMutex; // guards states, report, checkpoint and sink calls
+    size_t sinceCheckpoint = 0;
+
+    auto saveCheckpoint = [&] {
+        if (!checkpoint) return;
+        if (options.beforeCheckpoint) options.beforeCheckpoint();
+        checkpoint->save();
+        sinceCheckpoint = 0;
+    };
+
+    auto failSymbol = [&](size_t s, const std::string& message) {
+        SymbolState& st = states[s];
+        if (!st.failed) {
+            st.failed = true;
+            st.ready.clear();
+            report.failedSymbols.push_back(symbols[s]);
+        }
+        report.errors.push_back(message);
+    };
+
+    // Hands chunk k of symbol s to the sink once every earlier chunk has been delivered.
+    auto deliver = [&](size_t s, size_t k, Series&& data, bool closed) {
+        std::lock_guard<std::mutex> lock(deliveryMutex);
+        SymbolState& st = states[s];
+        if (st.failed) return;
+        st.ready.emplace(k, Ready{std::move(data), closed});
+        while (!st.ready.empty() && st.ready.begin()->first == st.next) {
+            auto it = st.ready.begin();
+            const Series& chunk = it->second.data;
+            if (!chunk.empty()) {
+                try {
+                    sink(symbols[s], chunk);
+                } catch (const std::exception& e) {
+                    failSymbol(s, symbols[s] + " " + formatApiTime(chunks[st.next].first, true) + ": sink: " + e.what());
+                    return;
+                }
+                report.rows += chunk.size();
+            }
+            ++(it->second.closed ? report.skippedClosed : report.completed);
+            if (checkpoint) checkpoint->set(symbols[s], chunks[st.next].second);
+            st.ready.erase(it);
+            ++st.next;
+            if (checkpoint && ++sinceCheckpoint >= options.checkpointEvery) {
+                try {
+                    saveCheckpoint();
+                } catch (const std::exception& e) {
+                    report.errors.push_back(std::string("checkpoint: ") + e.what());
+                }
+            }
+        }
+    };
+
+    auto worker = [&](size_t w) {
+        Task task;
+        bool stolen = false;
+        std::vector<double> latencies;
+        size_t retries = 0;
+        size_t steals = 0;
+        CancellationScope scope(cancelled); // aborts this worker's transfers
+        JsonArena arena;                    // holds one response at a time
+        while (!cancelled.cancelled() && queues.pop(w, task, stolen)) {
+            steals += stolen ? 1 : 0;
+            const std::string& symbol = symbols[task.symbol];
+            const int64_t from = chunks[task.chunk].first;
+            const int64_t to = chunks[task.chunk].second;
+            {
+                std::lock_guard<std::mutex> lock(deliveryMutex);
+                if (states[task.symbol].failed) continue;
+            }
+            if (options.calendar && !options.calendar->isOpen(options.market, from)) {
+                int64_t open = options.calendar->nextOpen(options.market, from);
+                if (open < 0 || open >= to) {
+                    deliver(task.symbol, task.chunk, Series(), true);
+                    continue;
+                }
+            }
+
+            Series data;
+            std::string error;
+            bool fetched = false;
+            for (int attempt = 1;; ++attempt) {
+                if (!limiter.acquire(cancelled)) break;
+                arena.reset(); // the previous attempt's document is already destroyed
+                const Clock::time_point sent = Clock::now();
+                Result<ArenaJson> body = fetch(arena, symbol, from, to);
+                latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - sent).count());
+                if (body) {
+                    decodeInto(body.value(), data);
+                    keepRange(data, from, to);
+                    fetched = true;
+                    break;
+                }
+                if (cancelled.cancelled()) break;
+                if (attempt >= options.maxAttempts || !retryable(body.error())) {
+                    error = symbol + " " + formatApiTime(from, true) + ": " + body.error().message;
+                    break;
+                }
+                ++retries;
+                if (cancelled.waitFor(options.retryBackoff * (1 << std::min(attempt - 1, 10)))) break;
+            }
+            if (!fetched && error.empty()) {
+                break; // cancelled: the chunk stays undelivered, like the queued ones
+            }
+            if (!error.empty()) {
+                std::lock_guard<std::mutex> lock(deliveryMutex);
+                failSymbol(task.symbol, error);
+                continue;
+            }
+            deliver(task.symbol, task.chunk, std::move(data), false);
+        }
+        std::lock_guard<std::mutex> lock(deliveryMutex);
+        report.requestMs.insert(report.requestMs.end(), latencies.begin(), latencies.end());
+        report.retries += retries;
+        report.steals += steals;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(worker, w);
+    }
+    if (workers > 0) worker(0);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    saveCheckpoint();
+    report.failed = report.tasks - report.completed - report.skippedClosed;
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started);
+    return report;
+}
@@ -0,0 +1,118 @@
+#ifndef TRADERMADE_BACKFILL_ENGINE_H
+#define TRADERMADE_BACKFILL_ENGINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <mutex>
+#include <vector>
+#include "CancellationToken.h"
+#include "TraderMadeTypes.h"
+
+class TraderMade;
+class MarketCalendar;
+
+// Parallel historical download for many symbols. A job (symbols x time range) is split
+// into API-sized chunks that run on a pool of worker threads with per-worker task
+// queues; idle workers steal from busy ones. While some workers wait on the network,
+// others decode and hand finished chunks to the sink:
+//
+//   TickArchiveWriter archive("/data/ticks");
+//   BackfillEngine::Options options;
+//   options.threads = 16;
+//   options.requestsPerSecond = 20;
+//   options.checkpointPath = "/data/ticks/backfill.ckpt";
+//   options.beforeCheckpoint = [&] { archive.flush(); };
+//   BackfillEngine engine(tm, options);
+//   BackfillEngine::Report r = engine.runTicks({{"EURUSD", "GBPUSD"}, fromMs, toMs},
+//       [&](const std::string& symbol, const TickSeries& ticks) { archive.append(symbol, ticks); });
+//
+// Sink calls are serialized and, per symbol, in time order, so non-thread-safe
+// writers (TickArchiveWriter, ArrowFileWriter) can be used directly. Failed requests
+// (transport errors, HTTP 429 and 5xx, open circuit) are retried with backoff; a
+// chunk that still fails stops that symbol, and the others continue.
+//
+// With a checkpoint path, the end of each symbol's delivered data is saved (write to
+// a temporary file, then rename) every few chunks and at the end. Running the same
+// job again skips what was already delivered. With a calendar, chunks during which
+// the market is closed are not requested.
+class BackfillEngine {
+public:
+    struct Options {
+        size_t threads = 8;
+        double requestsPerSecond = 0;   // shared by all workers; 0 = unlimited
+        double burst = 1;               // requests allowed back to back at the start
+        int maxAttempts = 4;
+        std::chrono::milliseconds retryBackoff{500}; // doubled per attempt
+
+        // Chunk sizes, within what the API accepts per request.
+        int64_t tickChunkMs = 30LL * 60000;
+        int64_t dailyChunkMs = 365LL * 86400000;
+        int64_t hourlyChunkMs = 30LL * 86400000;
+        int64_t minuteChunkMs = 2LL * 86400000;
+
+        std::string checkpointPath;          // empty: no checkpoint
+        size_t checkpointEvery = 16;         // delivered chunks between saves
+        std::function<void()> beforeCheckpoint; // make sink output durable (e.g. flush)
+
+        const MarketCalendar* calendar = nullptr;
+        std::string market = "Forex";
+    };
+
+    struct Job {
+        std::vector<std::string> symbols;
+        int64_t startMs;  // UTC ms, [startMs, endMs)
+        int64_t endMs;
+        TimeSeriesInterval interval = TimeSeriesInterval::Daily; // runBars() only
+        int period = 1;
+    };
+
+    struct Report {
+        size_t tasks = 0;          // chunks scheduled in this run
+        size_t completed = 0;      // chunks fetched and delivered (or empty)
+        size_t failed = 0;         // chunks not delivered (errors, failed symbol, cancel)
+        size_t skippedClosed = 0;  // chunks not requested because the market was closed
+        size_t resumed = 0;        // chunks already done according to the checkpoint
+        size_t retries = 0;
+        size_t steals = 0;
+        uint64_t rows = 0;
+        std::chrono::milliseconds elapsed{0};
+        std::vector<double> requestMs;         // latency of every request made
+        std::vector<std::string> failedSymbols;
+        std::vector<std::string> errors;       // "SYMBOL START: message"
+    };
+
+    using TickSink = std::function<void(const std::string& symbol, const TickSeries& ticks)>;
+    using BarSink = std::function<void(const std::string& symbol, const BarSeries& bars)>;
+
+    explicit BackfillEngine(TraderMade& tm);
+    BackfillEngine(TraderMade& tm, const Options& options);
+
+    BackfillEngine(const BackfillEngine&) = delete;
+    BackfillEngine& operator=(const BackfillEngine&) = delete;
+
+    // /tick_historical in tickChunkMs chunks. Blocks until done or cancelled (by
+    // token or cancel()); throws std::invalid_argument for an invalid job. Exceptions
+    // from the sink are reported as failures of that chunk's symbol.
+    Report runTicks(const Job& job, const TickSink& sink, const CancellationToken& token = CancellationToken());
+    // /timeseries with job.interval and job.period.
+    Report runBars(const Job& job, const BarSink& sink, const CancellationToken& token = CancellationToken());
+
+    // Stops the current run from another thread: queued chunks are dropped,
+    // transfers in flight and backoff waits are aborted, and the checkpoint is saved.
+    // Cancelled chunks are not reported as failed symbols.
+    void cancel();
+
+private:
+    TraderMade& tm;
+    Options options;
+    std::mutex runMutex;
+    CancellationToken runToken; // of the current run
+
+    template <typename Series, typename Fetch>
+    Report run(const Job& job, int64_t chunkMs, int64_t barWidthMs, const std::string& jobKey, Fetch fetch,
+               const std::function<void(const std::string&, const Series&)>& sink, const CancellationToken& token);
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef TRADERMADE_BROADCAST_RING_H
+#define TRADERMADE_BROADCAST_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "Seqlock.h"
+
+// Lock-free single-producer / multi-consumer broadcast ring. Every consumer sees
+// every item (consumers do not compete); a consumer that falls more than capacity
+// items behind skips ahead and counts the lost items instead of blocking the producer.
+template <typename T>
+class BroadcastRing {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    enum class ReadStatus { Ok, Empty, Overrun };
+
+    explicit BroadcastRing(size_t capacity) : head(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("BroadcastRing capacity must be a power of two >= 2.");
+        }
+        size = capacity;
+        mask = capacity - 1;
+        shift = 0;
+        while ((size_t(1) << shift) < capacity) ++shift;
+
+        // Slots are cache-line aligned; C++14 operator new does not honour over-alignment.
+        storage.reset(new unsigned char[capacity * sizeof(Slot) + CACHE_LINE]);
+        void* p = storage.get();
+        size_t space = capacity * sizeof(Slot) + CACHE_LINE;
+        slots = static_cast<Slot*>(std::align(CACHE_LINE, capacity * sizeof(Slot), p, space));
+        for (size_t i = 0; i < capacity; ++i) {
+            new (&slots[i]) Slot();
+        }
+    }
+
+    ~BroadcastRing() {
+        for (size_t i = 0; i < size; ++i) {
+            slots[i].~Slot();
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    size_t capacity() const { return size; }
+
+    // Sequence number the next publish() will use (= number of items published).
+    uint64_t published() const { return head.load(std::memory_order_acquire); }
+
+    // Producer side; only one thread may publish.
+    void publish(const T& value) {
+        uint64_t seq = head.load(std::memory_order_relaxed);
+        slots[seq & mask].value.store(value);
+        head.store(seq + 1, std::memory_order_release);
+    }
+
+    // Reads item seq. Overrun means seq has already been overwritten.
+    ReadStatus read(uint64_t seq, T& out) const {
+        if (seq >= head.load(std::memory_order_acquire)) {
+            return ReadStatus::Empty;
+        }
+        uint64_t expected = 2 * ((seq >> shift) + 1);
+        uint64_t version = 0;
+        if (!slots[seq & mask].value.tryLoad(out, version) || version != expected) {
+            return ReadStatus::Overrun;
+        }
+        return ReadStatus::Ok;
+    }
+
+    // Per-thread reader with its own cursor. Not thread-safe itself; create one per consumer.
+    class Cursor {
+    public:
+        Cursor(const BroadcastRing& ring, bool fromLatest)
+            : ring(&ring), next(fromLatest ? ring.published() : oldest(ring)), lost(0) {}
+
+        // Copies the next item into out; returns false if nothing new is available.
+        bool poll(T& out) {
+            while (true) {
+                switch (ring->read(next, out)) {
+                case ReadStatus::Ok:
+                    ++next;
+                    return true;
+                case ReadStatus::Empty:
+                    return false;
+                case ReadStatus::Overrun: {
+                    uint64_t resume = oldest(*ring) + 1;
+                    if (resume <= next) resume = next + 1;
+                    lost += resume - next;
+                    next = resume;
+                    break;
+                }
+                }
+            }
+        }
+
+        uint64_t dropped() const { return lost; }
+        uint64_t position() const { return next; }
+
+    private:
+        static uint64_t oldest(const BroadcastRing& ring) {
+            uint64_t h = ring.published();
+            return h > ring.size ? h - ring.size : 0;
+        }
+
+        const BroadcastRing* ring;
+        uint64_t next;
+        uint64_t lost;
+    };
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        Seqlock<T> value;
+    };
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> head;
+    size_t size;
+    size_t mask;
+    size_t shift;
+    std::unique_ptr<unsigned char[]> storage;
+    Slot* slots;
+};
+
+template <typename T>
+constexpr size_t BroadcastRing<T>::CACHE_LINE;
+
+#endif
@@ -0,0 +1,80 @@
+#include "CancellationToken.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+struct CancellationToken::State {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::atomic<bool> cancelled{false};
+    std::vector<std::pair<size_t, Callback>> callbacks;
+    size_t nextId = 1;
+};
+
+CancellationToken::CancellationToken() : state(std::make_shared<State>()) {}
+
+void CancellationToken::cancel() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->cancelled.load()) {
+        return;
+    }
+    state->cancelled.store(true);
+    state->changed.notify_all();
+    for (auto& entry : state->callbacks) {
+        entry.second();
+    }
+    state->callbacks.clear();
+}
+
+bool CancellationToken::cancelled() const {
+    return state->cancelled.load(std::memory_order_acquire);
+}
+
+bool CancellationToken::waitFor(std::chrono::nanoseconds duration) const {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    return state->changed.wait_for(lock, duration, [this] { return state->cancelled.load(); });
+}
+
+size_t CancellationToken::subscribe(Callback callback) const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->cancelled.load()) {
+        callback();
+        return 0;
+    }
+    size_t id = state->nextId++;
+    state->callbacks.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void CancellationToken::unsubscribe(size_t id) const {
+    if (id == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto& callbacks = state->callbacks;
+    for (auto it = callbacks.begin(); it != callbacks.end(); ++it) {
+        if (it->first == id) {
+            callbacks.erase(it);
+            return;
+        }
+    }
+}
+
+namespace {
+thread_local const CancellationToken* currentToken = nullptr;
+}
+
+CancellationScope::CancellationScope(const CancellationToken& token) : token(token), previous(currentToken) {
+    currentToken = &this->token;
+}
+
+CancellationScope::~CancellationScope() {
+    currentToken = previous;
+}
+
+const CancellationToken* CancellationScope::current() {
+    return currentToken;
+}
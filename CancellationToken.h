@@ -0,0 +1,74 @@
+#ifndef TRADERMADE_CANCELLATION_TOKEN_H
+#define TRADERMADE_CANCELLATION_TOKEN_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Cooperative cancellation. Copies share state, so a token handed to a worker can be
+// cancelled from any other thread (a UI, a signal-handling thread, a timeout):
+//
+//   CancellationToken token;
+//   std::thread worker([&tm, token] {
+//       CancellationScope scope(token); // every SDK request on this thread observes it
+//       auto r = tm.tryGetTickHistoricalData("EURUSD", from, to, "json");
+//       if (!r && r.error().code == ErrorCode::Cancelled) { ... }
+//   });
+//   token.cancel(); // kills the transfer in flight; later requests fail immediately
+//
+// Cancelled try* calls return ErrorCode::Cancelled and throwing calls throw
+// OperationCancelled. BackfillEngine::runTicks/runBars and StreamingClient::start
+// take a token directly. A token cannot be reset; use a new one per operation.
+class CancellationToken {
+public:
+    using Callback = std::function<void()>;
+
+    CancellationToken();
+
+    // Idempotent. Runs the registered callbacks on the calling thread.
+    void cancel() const;
+    bool cancelled() const;
+
+    // Sleeps for up to duration; returns true (early) if the token is cancelled.
+    bool waitFor(std::chrono::nanoseconds duration) const;
+
+    // Registers a callback for cancel(); runs it at once if already cancelled. Returns
+    // an id for unsubscribe(), which waits for the callback if it is running.
+    // Callbacks run under the token's lock: keep them short and do not use the same
+    // token from inside one.
+    size_t subscribe(Callback callback) const;
+    void unsubscribe(size_t id) const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+};
+
+// Makes a token current for SDK requests on this thread, until the scope ends.
+// Scopes nest; the innermost one wins.
+class CancellationScope {
+public:
+    explicit CancellationScope(const CancellationToken& token);
+    ~CancellationScope();
+
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+    // The calling thread's current token, or nullptr.
+    static const CancellationToken* current();
+
+private:
+    CancellationToken token;
+    const CancellationToken* previous;
+};
+
+// Thrown by the throwing API when the current token is cancelled.
+class OperationCancelled : public std::runtime_error {
+public:
+    explicit OperationCancelled(const std::string& message) : std::runtime_error(message) {}
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "CircuitBreaker.h"
+
+#include <algorithm>
+#include <thread>
+
+void CircuitBreaker::configure(const CircuitBreakerOptions& newOptions) {
+    std::lock_guard<std::mutex> lock(mutex);
+    options = newOptions;
+    options.halfOpenProbes = std::max<size_t>(options.halfOpenProbes, 1);
+    bucketWidthMs.store(std::max<int64_t>(1, options.window.count() / static_cast<int64_t>(BUCKETS)));
+    slowCallNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(options.slowCall).count());
+    failureRatio.store(options.failureRatio);
+    slowCallRatio.store(options.slowCallRatio);
+    minimumCalls.store(options.minimumCalls);
+    calls.store(0);
+    failures.store(0);
+    slowCalls.store(0);
+    rejected.store(0);
+    opened = 0;
+    reset();
+    enabled.store(options.enabled);
+}
+
+void CircuitBreaker::reset() {
+    probesStarted = 0;
+    probesSucceeded = 0;
+    for (Bucket& b : buckets) {
+        b.index.store(-1);
+        b.calls.store(0);
+        b.failures.store(0);
+        b.slow.store(0);
+    }
+    current.store(CircuitState::Closed);
+}
+
+int64_t CircuitBreaker::bucketIndex(Clock::time_point t) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count() /
+           bucketWidthMs.load(std::memory_order_relaxed);
+}
+
+void CircuitBreaker::window(Clock::time_point t, uint32_t& windowCalls, uint32_t& windowFailures,
+                            uint32_t& windowSlow) const {
+    int64_t now = bucketIndex(t);
+    windowCalls = windowFailures = windowSlow = 0;
+    for (const Bucket& b : buckets) {
+        if (b.index.load(std::memory_order_acquire) > now - static_cast<int64_t>(BUCKETS)) {
+            windowCalls += b.calls.load(std::memory_order_relaxed);
+            windowFailures += b.failures.load(std::memory_order_relaxed);
+            windowSlow += b.slow.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void CircuitBreaker::trip(Clock::time_point t) {
+    current.store(CircuitState::Open);
+    openUntil = t + options.openFor;
+    probesStarted = 0;
+    probesSucceeded = 0;
+    ++opened;
+}
+
+CircuitBreaker::Admission CircuitBreaker::admit() {
+    if (!enabled.load(std::memory_order_acquire)) {
+        return Admission::Disabled;
+    }
+    if (current.load(std::memory_order_acquire) == CircuitState::Closed) {
+        return Admission::Normal;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (current == CircuitState::Open) {
+        if (Clock::now() < openUntil) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return Admission::Rejected;
+        }
+        current.store(CircuitState::HalfOpen);
+    }
+    if (current == CircuitState::HalfOpen) {
+        if (probesStarted >= options.halfOpenProbes) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return Admission::Rejected;
+        }
+        ++probesStarted;
+        return Admission::Probe;
+    }
+    return Admission::Normal; // closed by another thread meanwhile
+}
+
+void CircuitBreaker::count(Outcome outcome, bool slow) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    if (outcome == Outcome::Failure) failures.fetch_add(1, std::memory_order_relaxed);
+    if (slow) slowCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CircuitBreaker::record(Admission admission, Outcome outcome, std::chrono::nanoseconds latency) {
+    if (admission == Admission::Rejected || admission == Admission::Disabled) {
+        return;
+    }
+    const bool slow = outcome != Outcome::NotSent && latency.count() >= slowCallNs.load(std::memory_order_relaxed);
+    if (admission == Admission::Normal) {
+        if (outcome != Outcome::NotSent) {
+            count(outcome, slow);
+            recordClosed(outcome, slow, Clock::now());
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (outcome != Outcome::NotSent) {
+        count(outcome, slow);
+    }
+    // Probes admitted before the circuit re-opened (or was reconfigured) no longer count.
+    if (current != CircuitState::HalfOpen) {
+        return;
+    }
+    if (outcome == Outcome::NotSent) {
+        --probesStarted;
+    } else if (outcome == Outcome::Failure || slow) {
+        trip(Clock::now());
+    } else if (++probesSucceeded >= options.halfOpenProbes) {
+        reset();
+    }
+}
+
+// Adds a sent call to the rolling window and trips the circuit if a ratio is reached.
+// Lock free unless the circuit opens.
+void CircuitBreaker::recordClosed(Outcome outcome, bool slow, Clock::time_point t) {
+    if (current.load(std::memory_order_acquire) != CircuitState::Closed) {
+        return;
+    }
+    const int64_t index = bucketIndex(t);
+    Bucket& b = buckets[static_cast<size_t>(index % static_cast<int64_t>(BUCKETS))];
+    for (int64_t seen = b.index.load(std::memory_order_acquire); seen < index;
+         seen = b.index.load(std::memory_order_acquire)) {
+        if (seen == RESETTING) {
+            std::this_thread::yield();
+        } else if (b.index.compare_exchange_weak(seen, RESETTING, std::memory_order_acquire)) {
+            b.calls.store(0, std::memory_order_relaxed);
+            b.failures.store(0, std::memory_order_relaxed);
+            b.slow.store(0, std::memory_order_relaxed);
+            b.index.store(index, std::memory_order_release);
+            break;
+        }
+    }
+    b.calls.fetch_add(1, std::memory_order_relaxed);
+    if (outcome == Outcome::Failure) b.failures.fetch_add(1, std::memory_order_relaxed);
+    if (slow) b.slow.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t windowCalls, windowFailures, windowSlow;
+    window(t, windowCalls, windowFailures, windowSlow);
+    if (windowCalls >= minimumCalls.load(std::memory_order_relaxed) && windowCalls > 0 &&
+        (windowFailures >= failureRatio.load(std::memory_order_relaxed) * windowCalls ||
+         windowSlow >= slowCallRatio.load(std::memory_order_relaxed) * windowCalls)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (current == CircuitState::Closed && enabled.load(std::memory_order_relaxed)) {
+            trip(t);
+        }
+    }
+}
+
+CircuitState CircuitBreaker::state() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (current == CircuitState::Open && Clock::now() >= openUntil) {
+        return CircuitState::HalfOpen; // the next call will be a probe
+    }
+    return current;
+}
+
+CircuitBreakerStats CircuitBreaker::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    CircuitBreakerStats s;
+    s.calls = calls.load();
+    s.failures = failures.load();
+    s.slowCalls = slowCalls.load();
+    s.rejected = rejected.load();
+    s.opened = opened;
+    const Clock::time_point t = Clock::now();
+    s.state = current == CircuitState::Open && t >= openUntil ? CircuitState::HalfOpen : current.load();
+    uint32_t windowCalls, windowFailures, windowSlow;
+    window(t, windowCalls, windowFailures, windowSlow);
+    s.windowCalls = windowCalls;
+    s.windowFailureRatio = windowCalls ? static_cast<double>(windowFailures) / windowCalls : 0.0;
+    s.windowSlowRatio = windowCalls ? static_cast<double>(windowSlow) / windowCalls : 0.0;
+    return s;
+}
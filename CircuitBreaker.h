@@ -0,0 +1,141 @@
+#ifndef TRADERMADE_CIRCUIT_BREAKER_H
+#define TRADERMADE_CIRCUIT_BREAKER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Endpoints grouped by how they fail: a slow /tick_historical should not stop /live.
+enum class EndpointFamily {
+    Live,       // /live
+    Reference,  // currency, crypto and CFD lists
+    Historical, // /historical, /hour_historical, /minute_historical
+    Tick,       // /tick_historical, /tick_historical_sample
+    TimeSeries, // /timeseries
+    Market,     // /market_open_status, /market_opening_times
+    Convert,    // /convert
+    Pandas      // /pandasDF
+};
+
+constexpr size_t ENDPOINT_FAMILY_COUNT = 8;
+
+constexpr const char* toString(EndpointFamily family) {
+    return family == EndpointFamily::Live       ? "live"
+         : family == EndpointFamily::Reference  ? "reference"
+         : family == EndpointFamily::Historical ? "historical"
+         : family == EndpointFamily::Tick       ? "tick"
+         : family == EndpointFamily::TimeSeries ? "timeseries"
+         : family == EndpointFamily::Market     ? "market"
+         : family == EndpointFamily::Convert    ? "convert"
+         :                                        "pandas";
+}
+
+enum class CircuitState { Closed, Open, HalfOpen };
+
+constexpr const char* toString(CircuitState state) {
+    return state == CircuitState::Closed ? "closed" : state == CircuitState::Open ? "open" : "half_open";
+}
+
+struct CircuitBreakerOptions {
+    bool enabled = false;
+    double failureRatio = 0.5;                 // transport errors and HTTP 5xx, of the calls in the window
+    double slowCallRatio = 1.0;                // calls slower than slowCall, of the calls in the window
+    std::chrono::milliseconds slowCall{10000};
+    size_t minimumCalls = 20;                  // calls in the window before the ratios are checked
+    std::chrono::milliseconds window{30000};   // rolling, in 10 buckets
+    std::chrono::milliseconds openFor{10000};  // fail fast this long, then probe
+    size_t halfOpenProbes = 3;                 // trial calls; all must succeed to close again
+};
+
+struct CircuitBreakerStats {
+    EndpointFamily family = EndpointFamily::Live;
+    CircuitState state = CircuitState::Closed;
+    uint64_t calls = 0;       // calls let through since configured
+    uint64_t failures = 0;
+    uint64_t slowCalls = 0;
+    uint64_t rejected = 0;    // failed fast while open (or with all probes taken)
+    uint64_t opened = 0;      // times the circuit opened
+    size_t windowCalls = 0;   // in the current window
+    double windowFailureRatio = 0;
+    double windowSlowRatio = 0;
+};
+
+// Closed -> Open -> HalfOpen state machine for one endpoint family. While closed,
+// outcomes go into a rolling window; once it holds minimumCalls and the failure or
+// slow call ratio reaches its threshold, the circuit opens and calls are rejected
+// without touching the network. After openFor, up to halfOpenProbes calls are let
+// through: if all succeed (and are not slow) the circuit closes, any failure opens it
+// again. Thread safe. While disabled or closed, admit() and record() use atomics
+// only; the lock is taken for state changes and probes, never during a request.
+class CircuitBreaker {
+public:
+    enum class Admission { Rejected, Normal, Probe, Disabled }; // record() ignores Disabled
+    enum class Outcome { NotSent, Success, Failure };
+
+    CircuitBreaker() = default;
+    explicit CircuitBreaker(const CircuitBreakerOptions& options) { configure(options); }
+
+    CircuitBreaker(const CircuitBreaker&) = delete;
+    CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+    // Replaces the options and resets state and counters.
+    void configure(const CircuitBreakerOptions& options);
+
+    // Call before a request; when admitted, report the result with record().
+    Admission admit();
+    void record(Admission admission, Outcome outcome, std::chrono::nanoseconds latency);
+
+    CircuitState state() const;
+    CircuitBreakerStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t BUCKETS = 10;
+
+    // Closed state outcomes. A bucket is reused once its index is a window old: the
+    // first caller to see that claims it (index RESETTING), clears the counts and
+    // publishes the new index, while others for that bucket wait for the few stores.
+    // A call that straddles the reuse may land in the newer bucket.
+    static constexpr int64_t RESETTING = INT64_MIN;
+    struct Bucket {
+        std::atomic<int64_t> index{-1}; // bucket number since the clock epoch
+        std::atomic<uint32_t> calls{0};
+        std::atomic<uint32_t> failures{0};
+        std::atomic<uint32_t> slow{0};
+    };
+
+    mutable std::mutex mutex;
+    CircuitBreakerOptions options; // guarded by mutex
+    // Copies of the options the closed state reads without the lock.
+    std::atomic<bool> enabled{false};
+    std::atomic<int64_t> bucketWidthMs{1};
+    std::atomic<int64_t> slowCallNs{0};
+    std::atomic<double> failureRatio{1.0};
+    std::atomic<double> slowCallRatio{1.0};
+    std::atomic<size_t> minimumCalls{0};
+
+    std::atomic<CircuitState> current{CircuitState::Closed};
+    Clock::time_point openUntil;   // guarded by mutex, like the probe counts
+    size_t probesStarted = 0;
+    size_t probesSucceeded = 0;
+    std::array<Bucket, BUCKETS> buckets;
+
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> slowCalls{0};
+    std::atomic<uint64_t> rejected{0};
+    uint64_t opened = 0; // guarded by mutex
+
+    int64_t bucketIndex(Clock::time_point t) const;
+    void window(Clock::time_point t, uint32_t& calls, uint32_t& failures, uint32_t& slow) const;
+    void count(Outcome outcome, bool slow);
+    void recordClosed(Outcome outcome, bool slow, Clock::time_point t);
+    // Callers hold mutex.
+    void trip(Clock::time_point t);
+    void reset();
+};
+
+#endif
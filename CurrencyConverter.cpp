@@ -0,0 +1,614 @@
+#include "CurrencyConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "InstrumentRegistry.h"
+#include "TraderMadeDecode.h"
+#include "TraderMadeSDK.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// out[i] = amounts[i] * rates[index[i]]. Uses AVX2 gathers when the CPU has them,
+// otherwise a scalar loop the compiler is free to vectorize.
+void multiplyGatheredScalar(const double* amounts, const int32_t* index, const double* rates, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = amounts[i] * rates[index[i]];
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRADERMADE_HAVE_AVX2_DISPATCH 1
+
+__attribute__((target("avx2"))) void multiplyGatheredAvx2(const double* amounts, const int32_t* index,
+                                                          const double* rates, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + i));
+        __m256d r = _mm256_i32gather_pd(rates, idx, 8);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(amounts + i), r));
+    }
+    multiplyGatheredScalar(amounts + i, index + i, rates, out + i, n - i);
+}
+#endif
+
+void multiplyGathered(const double* amounts, const int32_t* index, const double* rates, double* out, size_t n) {
+#ifdef TRADERMADE_HAVE_AVX2_DISPATCH
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+        multiplyGatheredAvx2(amounts, index, rates, out, n);
+        return;
+    }
+#endif
+    multiplyGatheredScalar(amounts, index, rates, out, n);
+}
+
+RequestError noRate(const std::string& from, const std::string& to) {
+    return RequestError{ErrorCode::InvalidArgument, 0, "No conversion rate available for " + from + " to " + to + "."};
+}
+
+} // namespace
+
+CurrencyConverter::CurrencyConverter(TraderMade* tm) : CurrencyConverter(tm, Options()) {}
+
+CurrencyConverter::CurrencyConverter(TraderMade* tm, const Options& options) : tm(tm), options(options) {
+    if (options.maxHops == 0) {
+        throw std::invalid_argument("maxHops must be at least 1.");
+    }
+}
+
+bool CurrencyConverter::update(const LiveQuote& quote) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return applyLocked(quote, std::chrono::steady_clock::now());
+}
+
+size_t CurrencyConverter::update(const std::vector<LiveQuote>& quotes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    SteadyTime now = std::chrono::steady_clock::now();
+    size_t applied = 0;
+    for (const LiveQuote& q : quotes) {
+        if (applyLocked(q, now)) {
+            ++applied;
+        }
+    }
+    return applied;
+}
+
+size_t CurrencyConverter::updateFromLiveRates(const nlohmann::json& body) {
+    std::vector<LiveQuote> quotes;
+    decodeLiveQuotes(body, quotes);
+    return update(quotes);
+}
+
+Result<size_t> CurrencyConverter::refresh() {
+    std::string symbols;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Edge& e : edges) {
+            if (!symbols.empty()) symbols += ',';
+            symbols += e.symbol;
+        }
+    }
+    if (symbols.empty()) {
+        return size_t(0);
+    }
+    return fetch(symbols);
+}
+
+double CurrencyConverter::rate(const std::string& from, const std::string& to) {
+    Result<double> r = resolve(from, to);
+    if (!r) {
+        throw std::runtime_error(r.error().message);
+    }
+    return r.value();
+}
+
+double CurrencyConverter::convert(double amount, const std::string& from, const std::string& to) {
+    return amount * rate(from, to);
+}
+
+Result<double> CurrencyConverter::tryRate(const std::string& from, const std::string& to) {
+    return resolve(from, to);
+}
+
+Result<double> CurrencyConverter::tryConvert(double amount, const std::string& from, const std::string& to) {
+    Result<double> r = resolve(from, to);
+    if (!r) {
+        return r.error();
+    }
+    return amount * r.value();
+}
+
+double CurrencyConverter::rate(InstrumentId pair) {
+    Result<double> r = resolve(pair);
+    if (!r) {
+        throw std::runtime_error(r.error().message);
+    }
+    return r.value();
+}
+
+double CurrencyConverter::convert(double amount, InstrumentId pair) {
+    return amount * rate(pair);
+}
+
+Result<double> CurrencyConverter::tryRate(InstrumentId pair) {
+    return resolve(pair);
+}
+
+Result<double> CurrencyConverter::tryConvert(double amount, InstrumentId pair) {
+    Result<double> r = resolve(pair);
+    if (!r) {
+        return r.error();
+    }
+    return amount * r.value();
+}
+
+size_t CurrencyConverter::currencyCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return adjacency.size();
+}
+
+size_t CurrencyConverter::pairCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return edges.size();
+}
+
+uint64_t CurrencyConverter::refreshes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return refreshCount;
+}
+
+int CurrencyConverter::currencyLocked(const std::string& code) {
+    auto it = currencyIndex.find(code);
+    if (it != currencyIndex.end()) {
+        return it->second;
+    }
+    int index = static_cast<int>(adjacency.size());
+    currencyIndex.emplace(code, index);
+    adjacency.emplace_back();
+    return index;
+}
+
+int CurrencyConverter::findCurrencyLocked(const std::string& code) const {
+    auto it = currencyIndex.find(code);
+    return it == currencyIndex.end() ? -1 : it->second;
+}
+
+bool CurrencyConverter::applyLocked(const LiveQuote& quote, SteadyTime now) {
+    if (!(quote.mid > 0.0) || !std::isfinite(quote.mid)) {
+        return false;
+    }
+    std::string symbol(quote.symbol);
+    std::string baseCode;
+    std::string quoteCode;
+    InstrumentId id = options.registry ? options.registry->find(symbol) : -1;
+    if (id >= 0 && !options.registry->info(id).base.empty()) {
+        baseCode = options.registry->info(id).base; // e.g. BTCUSDT -> BTC, USDT
+        quoteCode = options.registry->info(id).quote;
+    } else if (symbol.size() == 6) {
+        baseCode = symbol.substr(0, 3);
+        quoteCode = symbol.substr(3, 3);
+    } else {
+        return false;
+    }
+    int base = currencyLocked(baseCode);
+    int counter = currencyLocked(quoteCode);
+    if (base == counter) {
+        return false;
+    }
+
+    auto it = edgeIndex.find(key(base, counter));
+    if (it != edgeIndex.end()) {
+        edges[it->second].mid = quote.mid;
+        edges[it->second].updated = now;
+        return true;
+    }
+    it = edgeIndex.find(key(counter, base));
+    if (it != edgeIndex.end()) {
+        edges[it->second].mid = 1.0 / quote.mid;
+        edges[it->second].updated = now;
+        return true;
+    }
+
+    int index = static_cast<int>(edges.size());
+    edges.push_back(Edge{base, counter, quote.mid, now, symbol});
+    edgeIndex.emplace(key(base, counter), index);
+    adjacency[base].push_back(Step{index, false});
+    adjacency[counter].push_back(Step{index, true});
+    paths.clear(); // a new edge can shorten existing paths
+    return true;
+}
+
+// Symbols to request for a pair with no path: the cross itself, plus the legs to and
+// from the pivot currency that are not known yet, so a path through the pivot is found
+// even if /live does not quote the cross. Symbols already in the list are skipped.
+void CurrencyConverter::appendUnknownLocked(const std::string& from, const std::string& to,
+                                            std::string& symbols) const {
+    auto append = [&symbols](const std::string& symbol) {
+        if ((',' + symbols + ',').find(',' + symbol + ',') != std::string::npos) return;
+        if (!symbols.empty()) symbols += ',';
+        symbols += symbol;
+    };
+    auto known = [this](const std::string& a, const std::string& b) {
+        int x = findCurrencyLocked(a);
+        int y = findCurrencyLocked(b);
+        return x >= 0 && y >= 0 && (edgeIndex.count(key(x, y)) || edgeIndex.count(key(y, x)));
+    };
+    append(from + to);
+    if (from != options.pivot && to != options.pivot) {
+        if (!known(from, options.pivot)) append(from + options.pivot);
+        if (!known(options.pivot, to)) append(options.pivot + to);
+    }
+}
+
+// Breadth-first search: fewest hops, visiting the pivot first so it wins ties.
+const std::vector<CurrencyConverter::Step>* CurrencyConverter::pathLocked(int from, int to) {
+    auto cached = paths.find(key(from, to));
+    if (cached != paths.end()) {
+        return cached->second.empty() ? nullptr : &cached->second;
+    }
+
+    const int pivot = findCurrencyLocked(options.pivot);
+    const size_t n = adjacency.size();
+    std::vector<Step> via(n, Step{-1, false});
+    std::vector<int> depth(n, -1);
+    std::vector<int> queue;
+    queue.reserve(n);
+    queue.push_back(from);
+    depth[from] = 0;
+
+    auto next = [&](const Step& s) { return s.inverted ? edges[s.edge].base : edges[s.edge].quote; };
+    for (size_t head = 0; head < queue.size() && depth[to] < 0; ++head) {
+        int node = queue[head];
+        if (static_cast<size_t>(depth[node]) >= options.maxHops) {
+            continue;
+        }
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const Step& s : adjacency[node]) {
+                int neighbor = next(s);
+                if ((neighbor == pivot) != (pass == 0) || depth[neighbor] >= 0) {
+                    continue;
+                }
+                depth[neighbor] = depth[node] + 1;
+                via[neighbor] = s;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    std::vector<Step>& path = paths[key(from, to)];
+    if (depth[to] < 0) {
+        return nullptr;
+    }
+    path.resize(static_cast<size_t>(depth[to]));
+    for (int node = to, i = depth[to] - 1; node != from; --i) {
+        path[static_cast<size_t>(i)] = via[node];
+        node = via[node].inverted ? edges[via[node].edge].quote : edges[via[node].edge].base;
+    }
+    return &path;
+}
+
+double CurrencyConverter::pathRateLocked(const std::vector<Step>& path) const {
+    double r = 1.0;
+    for (const Step& s : path) {
+        r = s.inverted ? r / edges[s.edge].mid : r * edges[s.edge].mid;
+    }
+    return r;
+}
+
+bool CurrencyConverter::staleLocked(const std::vector<Step>& path, SteadyTime now) const {
+    for (const Step& s : path) {
+        if (now - edges[s.edge].updated > options.maxAge) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Result<size_t> CurrencyConverter::fetch(const std::string& symbols) {
+    if (!tm) {
+        return RequestError{ErrorCode::NotConfigured, 0, "CurrencyConverter has no TraderMade instance to refresh from."};
+    }
+    Result<nlohmann::json> body = tm->tryGetLiveRates(symbols);
+    if (!body) {
+        return body.error();
+    }
+    std::vector<LiveQuote> quotes;
+    decodeLiveQuotes(body.value(), quotes);
+    std::lock_guard<std::mutex> lock(mutex);
+    SteadyTime now = std::chrono::steady_clock::now();
+    size_t applied = 0;
+    for (const LiveQuote& q : quotes) {
+        if (applyLocked(q, now)) {
+            ++applied;
+        }
+    }
+    ++refreshCount;
+    return applied;
+}
+
+Result<double> CurrencyConverter::resolve(const std::string& from, const std::string& to) {
+    if (from.empty() || to.empty()) {
+        return RequestError{ErrorCode::InvalidArgument, 0, "from and to currencies are required."};
+    }
+    if (from == to) {
+        return 1.0;
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::string symbols;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int f = findCurrencyLocked(from);
+            int t = findCurrencyLocked(to);
+            const std::vector<Step>* path = f >= 0 && t >= 0 ? pathLocked(f, t) : nullptr;
+            if (path && (!tm || attempt > 0 || !staleLocked(*path, std::chrono::steady_clock::now()))) {
+                return pathRateLocked(*path);
+            }
+            if (!path && (!tm || attempt > 0)) {
+                return noRate(from, to);
+            }
+            if (path) {
+                // Refresh everything we know in the same call; the other paths age together.
+                for (const Edge& e : edges) {
+                    if (!symbols.empty()) symbols += ',';
+                    symbols += e.symbol;
+                }
+            } else {
+                appendUnknownLocked(from, to, symbols);
+            }
+        }
+
+        Result<size_t> fetched = fetch(symbols);
+        if (!fetched) {
+            std::lock_guard<std::mutex> lock(mutex);
+            int f = findCurrencyLocked(from);
+            int t = findCurrencyLocked(to);
+            const std::vector<Step>* path = f >= 0 && t >= 0 ? pathLocked(f, t) : nullptr;
+            if (path) {
+                return pathRateLocked(*path); // stale rate beats no rate
+            }
+            return fetched.error();
+        }
+    }
+    return noRate(from, to);
+}
+
+Result<const InstrumentInfo*> CurrencyConverter::pairInfo(InstrumentId pair) const {
+    if (!options.registry) {
+        return RequestError{ErrorCode::NotConfigured, 0, "CurrencyConverter has no InstrumentRegistry (Options::registry)."};
+    }
+    if (pair < 0 || static_cast<size_t>(pair) >= options.registry->size()) {
+        return RequestError{ErrorCode::InvalidArgument, 0, "Unknown instrument id " + std::to_string(pair) + "."};
+    }
+    const InstrumentInfo& info = options.registry->info(pair);
+    if (info.base.empty() || info.quote.empty()) {
+        return RequestError{ErrorCode::InvalidArgument, 0, info.symbol + " is not a currency pair."};
+    }
+    return &info;
+}
+
+Result<double> CurrencyConverter::resolve(InstrumentId pair) {
+    Result<const InstrumentInfo*> info = pairInfo(pair);
+    if (!info) {
+        return info.error();
+    }
+    {
+        // Fast path: cached currency indices and a fresh path, no string hashing.
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pairCurrencies.size() <= static_cast<size_t>(pair)) {
+            pairCurrencies.resize(options.registry->size(), std::make_pair(-1, -1));
+        }
+        std::pair<int, int>& cached = pairCurrencies[static_cast<size_t>(pair)];
+        if (cached.first < 0 || cached.second < 0) {
+            cached = std::make_pair(findCurrencyLocked(info.value()->base), findCurrencyLocked(info.value()->quote));
+        }
+        if (cached.first >= 0 && cached.second >= 0) {
+            const std::vector<Step>* path = pathLocked(cached.first, cached.second);
+            if (path && (!tm || !staleLocked(*path, std::chrono::steady_clock::now()))) {
+                return pathRateLocked(*path);
+            }
+        }
+    }
+    return resolve(info.value()->base, info.value()->quote);
+}
+
+void CurrencyConverter::resolveMany(const std::vector<std::pair<std::string, std::string>>& pairs,
+                                    std::vector<double>& rates) {
+    const double NOT_AVAILABLE = std::numeric_limits<double>::quiet_NaN();
+    rates.assign(pairs.size(), NOT_AVAILABLE);
+
+    std::string symbols;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SteadyTime now = std::chrono::steady_clock::now();
+        bool refreshKnown = false;
+        for (const auto& p : pairs) {
+            if (p.first == p.second) continue;
+            int f = findCurrencyLocked(p.first);
+            int t = findCurrencyLocked(p.second);
+            const std::vector<Step>* path = f >= 0 && t >= 0 ? pathLocked(f, t) : nullptr;
+            if (!path) {
+                appendUnknownLocked(p.first, p.second, symbols);
+            } else if (staleLocked(*path, now)) {
+                refreshKnown = true;
+            }
+        }
+        if (refreshKnown) {
+            for (const Edge& e : edges) {
+                if (!symbols.empty()) symbols += ',';
+                symbols += e.symbol;
+            }
+        }
+    }
+    if (tm && !symbols.empty() && !pairs.empty()) {
+        fetch(symbols); // on failure the cached (possibly stale) rates are used
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (pairs[i].first == pairs[i].second) {
+            rates[i] = 1.0;
+            continue;
+        }
+        int f = findCurrencyLocked(pairs[i].first);
+        int t = findCurrencyLocked(pairs[i].second);
+        const std::vector<Step>* path = f >= 0 && t >= 0 ? pathLocked(f, t) : nullptr;
+        if (path) {
+            rates[i] = pathRateLocked(*path);
+        }
+    }
+}
+
+template <typename ToColumn>
+CurrencyConverter::BulkResult CurrencyConverter::convertColumns(const double* amounts, const std::string* from,
+                                                                ToColumn to, size_t count, double* out) {
+    BulkResult result;
+    if (count == 0) {
+        return result;
+    }
+    if (count > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::length_error("convertBulk supports at most 2^31 - 1 rows.");
+    }
+
+    // Pass 1: map every row to a distinct pair index.
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::unordered_map<std::string, int32_t> pairIndex;
+    std::vector<int32_t> rowPair(count);
+    std::string pairKey;
+    int32_t last = -1;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& f = from[i];
+        const std::string& t = to(i);
+        // Books are usually grouped by currency, so the previous row's pair is a cheap first guess.
+        if (last >= 0 && pairs[last].first == f && pairs[last].second == t) {
+            rowPair[i] = last;
+            continue;
+        }
+        pairKey.assign(f).append(1, '/').append(t);
+        auto it = pairIndex.find(pairKey);
+        if (it == pairIndex.end()) {
+            it = pairIndex.emplace(pairKey, static_cast<int32_t>(pairs.size())).first;
+            pairs.emplace_back(f, t);
+        }
+        rowPair[i] = last = it->second;
+    }
+
+    // Pass 2: one rate per distinct pair, at most one /live call.
+    std::vector<double> rates;
+    resolveMany(pairs, rates);
+    result.distinctPairs = pairs.size();
+    std::vector<size_t> rowsPerPair(pairs.size(), 0);
+    for (int32_t p : rowPair) {
+        ++rowsPerPair[p];
+    }
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        if (std::isnan(rates[p])) {
+            result.failed += rowsPerPair[p];
+            result.missingPairs.push_back(pairs[p].first + "/" + pairs[p].second);
+        }
+    }
+    result.converted = count - result.failed;
+
+    // Pass 3: out[i] = amounts[i] * rates[rowPair[i]]
+    multiplyGathered(amounts, rowPair.data(), rates.data(), out, count);
+    return result;
+}
+
+CurrencyConverter::BulkResult CurrencyConverter::convertBulk(const double* amounts, const std::string* from,
+                                                             const std::string* to, size_t count, double* out) {
+    return convertColumns(amounts, from, [to](size_t i) -> const std::string& { return to[i]; }, count, out);
+}
+
+CurrencyConverter::BulkResult CurrencyConverter::convertBulk(const double* amounts, const std::string* from,
+                                                             const std::string& to, size_t count, double* out) {
+    return convertColumns(amounts, from, [&to](size_t) -> const std::string& { return to; }, count, out);
+}
+
+CurrencyConverter::BulkResult CurrencyConverter::convertBulk(const std::vector<double>& amounts,
+                                                             const std::vector<std::string>& from,
+                                                             const std::vector<std::string>& to,
+                                                             std::vector<double>& out) {
+    if (from.size() != amounts.size() || to.size() != amounts.size()) {
+        throw std::invalid_argument("amounts, from and to must have the same length.");
+    }
+    out.resize(amounts.size());
+    return convertBulk(amounts.data(), from.data(), to.data(), amounts.size(), out.data());
+}
+
+CurrencyConverter::BulkResult CurrencyConverter::convertBulk(const double* amounts, const InstrumentId* pairIds,
+                                                             size_t count, double* out) {
+    BulkResult result;
+    if (count == 0) {
+        return result;
+    }
+    if (count > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::length_error("convertBulk supports at most 2^31 - 1 rows.");
+    }
+    if (!options.registry) {
+        throw std::logic_error("convertBulk by InstrumentId needs Options::registry.");
+    }
+
+    // Pass 1: distinct pairs, indexed by ID (no hashing). Rows with an ID that is not a
+    // currency pair point at a trailing NaN rate.
+    std::vector<int32_t> slot(options.registry->size(), -1);
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::vector<InstrumentId> invalid;
+    std::vector<int32_t> rowPair(count);
+    const int32_t NO_RATE = -2;
+    for (size_t i = 0; i < count; ++i) {
+        const InstrumentId id = pairIds[i];
+        if (id < 0 || static_cast<size_t>(id) >= slot.size()) {
+            rowPair[i] = NO_RATE;
+            invalid.push_back(id);
+            continue;
+        }
+        int32_t& s = slot[static_cast<size_t>(id)];
+        if (s == -1) {
+            const InstrumentInfo& info = options.registry->info(id);
+            if (info.base.empty() || info.quote.empty()) {
+                s = NO_RATE;
+                invalid.push_back(id);
+            } else {
+                s = static_cast<int32_t>(pairs.size());
+                pairs.emplace_back(info.base, info.quote);
+            }
+        }
+        rowPair[i] = s;
+    }
+
+    // Pass 2: one rate per distinct pair, at most one /live call.
+    std::vector<double> rates;
+    resolveMany(pairs, rates);
+    const int32_t noRateSlot = static_cast<int32_t>(rates.size());
+    rates.push_back(std::numeric_limits<double>::quiet_NaN());
+    result.distinctPairs = pairs.size();
+    std::vector<size_t> rowsPerPair(rates.size(), 0);
+    for (int32_t& p : rowPair) {
+        if (p == NO_RATE) p = noRateSlot;
+        ++rowsPerPair[p];
+    }
+    for (size_t p = 0; p < pairs.size(); ++p) {
+        if (std::isnan(rates[p])) {
+            result.failed += rowsPerPair[p];
+            result.missingPairs.push_back(pairs[p].first + "/" + pairs[p].second);
+        }
+    }
+    result.failed += rowsPerPair[noRateSlot];
+    std::sort(invalid.begin(), invalid.end());
+    invalid.erase(std::unique(invalid.begin(), invalid.end()), invalid.end());
+    for (InstrumentId id : invalid) {
+        result.missingPairs.push_back("#" + std::to_string(id));
+    }
+    result.converted = count - result.failed;
+
+    // Pass 3: out[i] = amounts[i] * rates[rowPair[i]]
+    multiplyGathered(amounts, rowPair.data(), rates.data(), out, count);
+    return result;
+}
@@ -0,0 +1,158 @@
+#ifndef TRADERMADE_CURRENCY_CONVERTER_H
+#define TRADERMADE_CURRENCY_CONVERTER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "TraderMadeTypes.h"
+#include "TraderMadeResult.h"
+
+class TraderMade;
+class InstrumentRegistry;
+struct InstrumentInfo;
+
+// Local replacement for /convert. Keeps a currency graph built from cached live
+// quotes (one edge per pair, usable in both directions) and converts with
+// direct, inverse or triangulated rates in well under a microsecond:
+//
+//   CurrencyConverter fx(&tm);
+//   fx.updateFromLiveRates(tm.getLiveRates("EURUSD,GBPUSD,USDJPY"));
+//   double yen = fx.convert(1000.0, "GBP", "JPY");   // GBP -> USD -> JPY
+//
+// Cross rates take the path with the fewest hops, preferring the pivot currency
+// (USD by default) on ties. When a TraderMade instance is attached, quotes older
+// than Options::maxAge are refreshed with one batched /live call before use, and
+// for pairs with no path the same call asks for the cross and both legs via the
+// pivot, so they convert even if /live does not quote the cross. Without one, only
+// fed quotes are used.
+// All members are thread-safe.
+class CurrencyConverter {
+public:
+    struct Options {
+        std::chrono::milliseconds maxAge{60000}; // quotes older than this are refreshed
+        std::string pivot = "USD";               // preferred intermediate currency
+        size_t maxHops = 4;                      // longest conversion chain considered
+
+        // Optional: enables the InstrumentId overloads. Must outlive the converter and
+        // stop changing before it is used from several threads.
+        const InstrumentRegistry* registry = nullptr;
+    };
+
+    explicit CurrencyConverter(TraderMade* tm = nullptr);
+    CurrencyConverter(TraderMade* tm, const Options& options);
+
+    CurrencyConverter(const CurrencyConverter&) = delete;
+    CurrencyConverter& operator=(const CurrencyConverter&) = delete;
+
+    // --- Feeding quotes (6 letter currency pairs, or any pair in Options::registry; CFDs are ignored) ---
+
+    bool update(const LiveQuote& quote);
+    size_t update(const std::vector<LiveQuote>& quotes);
+    size_t updateFromLiveRates(const nlohmann::json& body);
+
+    // Re-fetches every known pair with one /live call. Fails if no TraderMade is attached.
+    Result<size_t> refresh();
+
+    // --- Conversion ---
+
+    // Units of `to` per unit of `from`. Throws std::runtime_error if no rate is available.
+    double rate(const std::string& from, const std::string& to);
+    double convert(double amount, const std::string& from, const std::string& to);
+
+    Result<double> tryRate(const std::string& from, const std::string& to);
+    Result<double> tryConvert(double amount, const std::string& from, const std::string& to);
+
+    // By currency pair ID (needs Options::registry): units of the pair's quote currency
+    // per unit of its base, e.g. USD per EUR for EURUSD. The ID's currencies are looked
+    // up once and cached in an array, so repeated calls skip the string lookups.
+    double rate(InstrumentId pair);
+    double convert(double amount, InstrumentId pair);
+    Result<double> tryRate(InstrumentId pair);
+    Result<double> tryConvert(double amount, InstrumentId pair);
+
+    // --- Bulk conversion (columnar) ---
+    //
+    // out[i] = amounts[i] * rate(from[i], to[i]). Each distinct pair is resolved once,
+    // every missing or stale rate is fetched in a single /live call, and the rows are
+    // multiplied in one vectorized pass. Rows without a rate get NaN.
+    struct BulkResult {
+        size_t converted = 0;
+        size_t failed = 0;
+        size_t distinctPairs = 0;
+        std::vector<std::string> missingPairs; // "FROM/TO" per pair without a rate ("#<id>" if not a pair)
+    };
+
+    BulkResult convertBulk(const double* amounts, const std::string* from, const std::string* to,
+                           size_t count, double* out);
+    // Every row converts into the same currency (e.g. the book's reporting currency).
+    BulkResult convertBulk(const double* amounts, const std::string* from, const std::string& to,
+                           size_t count, double* out);
+    BulkResult convertBulk(const std::vector<double>& amounts, const std::vector<std::string>& from,
+                           const std::vector<std::string>& to, std::vector<double>& out);
+    // out[i] = amounts[i] * rate(pairs[i]): amounts in each pair's base currency,
+    // converted into its quote currency. Needs Options::registry.
+    BulkResult convertBulk(const double* amounts, const InstrumentId* pairs, size_t count, double* out);
+
+    size_t currencyCount() const;
+    size_t pairCount() const;
+    uint64_t refreshes() const;
+
+private:
+    using SteadyTime = std::chrono::steady_clock::time_point;
+
+    struct Edge {
+        int base;
+        int quote;
+        double mid;
+        SteadyTime updated;
+        std::string symbol;
+    };
+
+    // One hop of a conversion path: multiply by edges[edge].mid, or divide if inverted.
+    struct Step {
+        int edge;
+        bool inverted;
+    };
+
+    TraderMade* tm;
+    Options options;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, int> currencyIndex;
+    std::vector<std::vector<Step>> adjacency; // per currency: outgoing steps
+    std::vector<Edge> edges;
+    std::unordered_map<uint64_t, int> edgeIndex;          // (base, quote) -> edge
+    std::unordered_map<uint64_t, std::vector<Step>> paths; // (from, to) -> cached path
+    std::vector<std::pair<int, int>> pairCurrencies;       // InstrumentId -> (base, quote), -1 if unknown
+    uint64_t refreshCount = 0;
+
+    static uint64_t key(int a, int b) { return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b); }
+
+    // Callers hold mutex.
+    int currencyLocked(const std::string& code);
+    int findCurrencyLocked(const std::string& code) const;
+    bool applyLocked(const LiveQuote& quote, SteadyTime now);
+    const std::vector<Step>* pathLocked(int from, int to);
+    double pathRateLocked(const std::vector<Step>& path) const;
+    bool staleLocked(const std::vector<Step>& path, SteadyTime now) const;
+    void appendUnknownLocked(const std::string& from, const std::string& to, std::string& symbols) const;
+
+    // Fetches symbols (comma separated) via /live and applies them. Takes the lock itself.
+    Result<size_t> fetch(const std::string& symbols);
+    // Resolves a path for from/to, refreshing or fetching as needed, and returns its rate.
+    Result<double> resolve(const std::string& from, const std::string& to);
+    Result<double> resolve(InstrumentId pair);
+    // The registry entry for a currency pair ID, or an error.
+    Result<const InstrumentInfo*> pairInfo(InstrumentId pair) const;
+    // Rates for distinct (from, to) pairs with at most one /live call; NaN where unavailable.
+    void resolveMany(const std::vector<std::pair<std::string, std::string>>& pairs, std::vector<double>& rates);
+    template <typename ToColumn>
+    BulkResult convertColumns(const double* amounts, const std::string* from, ToColumn to, size_t count, double* out);
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "InstrumentRegistry.h"
+
+#include <stdexcept>
+#include "TraderMadeSDK.h"
+
+namespace {
+
+// Reference lists come as {"available_currencies": {code: name}} or, for CFDs,
+// {"instruments": [{"instrument", "name"}]} / {"instruments": {code: name}}.
+template <typename Visit>
+void forEachEntry(const nlohmann::json& body, const char* key, const char* codeField, Visit visit) {
+    if (!body.is_object()) {
+        return;
+    }
+    auto list = body.find(key);
+    if (list == body.end()) {
+        return;
+    }
+    if (list->is_object()) {
+        for (auto it = list->begin(); it != list->end(); ++it) {
+            visit(it.key(), it->is_string() ? it->get<std::string>() : std::string());
+        }
+    } else if (list->is_array()) {
+        for (const nlohmann::json& entry : *list) {
+            if (entry.is_string()) {
+                visit(entry.get<std::string>(), std::string());
+            } else if (entry.is_object() && entry.contains(codeField) && entry[codeField].is_string()) {
+                auto name = entry.find("name");
+                visit(entry[codeField].get<std::string>(),
+                      name != entry.end() && name->is_string() ? name->get<std::string>() : std::string());
+            }
+        }
+    }
+}
+
+} // namespace
+
+size_t InstrumentRegistry::load(TraderMade& tm) {
+    size_t before = instruments.size();
+    addCurrencyList(tm.getLiveCurrencyList(), false);
+    addCurrencyList(tm.getCryptoList(), true);
+    addCfdList(tm.getCfdList());
+    addStreamingList(tm.getStreamingCurrencyList());
+    return instruments.size() - before;
+}
+
+void InstrumentRegistry::addCurrencyList(const nlohmann::json& body, bool crypto) {
+    forEachEntry(body, "available_currencies", "currency", [&](const std::string& code, const std::string& name) {
+        auto inserted = currencies.emplace(code, CurrencyInfo{code, name, crypto});
+        CurrencyInfo& c = inserted.first->second;
+        if (inserted.second) return;
+        if (!name.empty() || c.name.empty()) c.name = name;
+        c.crypto = c.crypto && crypto; // fiat wins when a code is in both lists
+    });
+}
+
+size_t InstrumentRegistry::addCfdList(const nlohmann::json& body) {
+    size_t before = instruments.size();
+    forEachEntry(body, "instruments", "instrument", [&](const std::string& code, const std::string& name) {
+        if (find(code) >= 0) return;
+        InstrumentInfo info;
+        info.symbol = code;
+        info.name = name;
+        info.assetClass = AssetClass::Cfd;
+        info.streamable = false;
+        add(std::move(info));
+    });
+    return instruments.size() - before;
+}
+
+size_t InstrumentRegistry::addStreamingList(const nlohmann::json& body) {
+    size_t before = instruments.size();
+    forEachEntry(body, "available_currencies", "currency", [&](const std::string& code, const std::string& name) {
+        InstrumentId existing = find(code);
+        if (existing >= 0) {
+            instruments[existing].streamable = true;
+            return;
+        }
+        InstrumentInfo info;
+        if (!splitPair(code, info)) {
+            // Streaming symbols outside the currency lists are still usable.
+            info.symbol = code;
+            info.assetClass = AssetClass::Forex;
+        }
+        if (!name.empty()) info.name = name;
+        info.streamable = true;
+        add(std::move(info));
+    });
+    return instruments.size() - before;
+}
+
+InstrumentId InstrumentRegistry::intern(const std::string& symbol) {
+    InstrumentId id = find(symbol);
+    if (id >= 0) {
+        return id;
+    }
+    InstrumentInfo info;
+    if (!splitPair(symbol, info)) {
+        throw std::invalid_argument("Unknown or ambiguous instrument: " + symbol);
+    }
+    info.streamable = false;
+    return add(std::move(info));
+}
+
+InstrumentId InstrumentRegistry::find(const std::string& symbol) const {
+    auto it = ids.find(symbol);
+    return it == ids.end() ? -1 : it->second;
+}
+
+const InstrumentInfo& InstrumentRegistry::info(InstrumentId id) const {
+    if (id < 0 || static_cast<size_t>(id) >= instruments.size()) {
+        throw std::out_of_range("Unknown instrument id " + std::to_string(id));
+    }
+    return instruments[static_cast<size_t>(id)];
+}
+
+const CurrencyInfo* InstrumentRegistry::currency(const std::string& code) const {
+    auto it = currencies.find(code);
+    return it == currencies.end() ? nullptr : &it->second;
+}
+
+std::string InstrumentRegistry::symbolList(const std::vector<InstrumentId>& list) const {
+    std::string out;
+    for (InstrumentId id : list) {
+        if (!out.empty()) out += ',';
+        out += symbol(id);
+    }
+    return out;
+}
+
+std::vector<std::string> InstrumentRegistry::symbols(const std::vector<InstrumentId>& list) const {
+    std::vector<std::string> out;
+    out.reserve(list.size());
+    for (InstrumentId id : list) {
+        out.push_back(symbol(id));
+    }
+    return out;
+}
+
+std::vector<InstrumentId> InstrumentRegistry::streamable() const {
+    std::vector<InstrumentId> out;
+    for (const InstrumentInfo& i : instruments) {
+        if (i.streamable) out.push_back(i.id);
+    }
+    return out;
+}
+
+InstrumentId InstrumentRegistry::add(InstrumentInfo info) {
+    info.id = static_cast<InstrumentId>(instruments.size());
+    ids.emplace(info.symbol, info.id);
+    instruments.push_back(std::move(info));
+    return instruments.back().id;
+}
+
+bool InstrumentRegistry::splitPair(const std::string& symbol, InstrumentInfo& info) const {
+    // Codes are 3 letters for fiat but 2 to 5 for crypto (BTCUSDT, DOGEUSD, MATICBTC), so
+    // try every split into two known codes. A symbol with more than one such split
+    // (say "ABCDE" with AB/CDE and ABC/DE all listed) is ambiguous and rejected.
+    const CurrencyInfo* base = nullptr;
+    const CurrencyInfo* quote = nullptr;
+    for (size_t at = 2; at + 2 <= symbol.size(); ++at) {
+        const CurrencyInfo* b = currency(symbol.substr(0, at));
+        const CurrencyInfo* q = b ? currency(symbol.substr(at)) : nullptr;
+        if (!q || b == q) {
+            continue;
+        }
+        if (base) {
+            return false;
+        }
+        base = b;
+        quote = q;
+    }
+    if (!base) {
+        return false;
+    }
+    info.symbol = symbol;
+    info.base = base->code;
+    info.quote = quote->code;
+    info.assetClass = base->crypto || quote->crypto ? AssetClass::Crypto : AssetClass::Forex;
+    if (info.name.empty()) {
+        info.name = base->name + " " + quote->name;
+    }
+    return true;
+}
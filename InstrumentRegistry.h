@@ -0,0 +1,88 @@
+#ifndef TRADERMADE_INSTRUMENT_REGISTRY_H
+#define TRADERMADE_INSTRUMENT_REGISTRY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "TraderMadeTypes.h"
+
+class TraderMade;
+
+enum class AssetClass { Forex, Crypto, Cfd };
+
+struct CurrencyInfo {
+    std::string code;  // e.g. "EUR", "BTC"
+    std::string name;
+    bool crypto;       // false if the code is in the fiat list, even if also in the crypto list
+};
+
+struct InstrumentInfo {
+    InstrumentId id;
+    std::string symbol;  // API symbol, e.g. "EURUSD" or "UK100"
+    std::string name;
+    AssetClass assetClass;
+    std::string base;    // empty for CFDs
+    std::string quote;   // empty for CFDs
+    bool streamable;     // listed by getStreamingCurrencyList()
+};
+
+// Interns symbols into dense InstrumentIds (0, 1, 2, ...) and keeps their metadata,
+// so per-symbol state can live in plain arrays indexed by ID instead of string maps.
+//
+//   InstrumentRegistry registry;
+//   registry.load(tm);                              // four reference-list calls
+//   InstrumentId eurusd = registry.intern("EURUSD");
+//   tm.getTimeSeriesData<...>(registry.symbol(eurusd), ...);
+//   QuoteTable table(registry);                     // same IDs
+//
+// LiveQuoteFeed and CurrencyConverter take IDs directly once given the registry
+// (Options::registry); REST calls take registry.symbol(id) or symbolList(ids).
+//
+// Pairs are not enumerated up front: intern() registers any pair of known
+// currencies on first use. Populate the registry before sharing it between
+// threads; the const members are safe to call concurrently once it stops changing.
+class InstrumentRegistry {
+public:
+    // Calls getLiveCurrencyList, getCryptoList, getCfdList and getStreamingCurrencyList.
+    // Throws whatever those calls throw. Returns the number of instruments registered.
+    size_t load(TraderMade& tm);
+
+    // Individual list responses, for callers that fetch (or cache) them themselves.
+    // A code in both the fiat and the crypto list counts as fiat, whatever the order.
+    void addCurrencyList(const nlohmann::json& body, bool crypto);
+    size_t addCfdList(const nlohmann::json& body);
+    size_t addStreamingList(const nlohmann::json& body);
+
+    // ID for symbol, registering it if it is a CFD or a pair of known currencies
+    // (including crypto codes of 2 to 5+ letters, e.g. BTCUSDT). Throws
+    // std::invalid_argument for symbols the reference lists do not cover, and for pairs
+    // that split into known codes in more than one way.
+    InstrumentId intern(const std::string& symbol);
+    // ID for symbol, or -1 if it is not registered.
+    InstrumentId find(const std::string& symbol) const;
+
+    size_t size() const { return instruments.size(); }
+    const InstrumentInfo& info(InstrumentId id) const;
+    const std::string& symbol(InstrumentId id) const { return info(id).symbol; }
+    const std::vector<InstrumentInfo>& all() const { return instruments; }
+
+    // nullptr if the code is not in the currency or crypto list.
+    const CurrencyInfo* currency(const std::string& code) const;
+    size_t currencyCount() const { return currencies.size(); }
+
+    // Comma separated symbols for the currency parameter of /live, /convert etc.
+    std::string symbolList(const std::vector<InstrumentId>& ids) const;
+    std::vector<std::string> symbols(const std::vector<InstrumentId>& ids) const;
+    std::vector<InstrumentId> streamable() const;
+
+private:
+    std::vector<InstrumentInfo> instruments;
+    std::unordered_map<std::string, InstrumentId> ids;
+    std::unordered_map<std::string, CurrencyInfo> currencies;
+
+    InstrumentId add(InstrumentInfo info);
+    bool splitPair(const std::string& symbol, InstrumentInfo& info) const;
+};
+
+#endif
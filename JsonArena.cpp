@@ -0,0 +1,62 @@
+#include "JsonArena.h"
+
+#include <algorithm>
+
+JsonArena::JsonArena(size_t blockSize) : blockSize(std::max<size_t>(blockSize, 1024)) {}
+
+JsonArena::~JsonArena() = default;
+
+void JsonArena::addBlock(size_t minimum) {
+    // Each block doubles the previous one, so a large document needs only a few.
+    size_t size = std::max(minimum, blocks.empty() ? blockSize : blocks.back().size * 2);
+    blocks.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    cursor = blocks.back().data.get();
+    limit = cursor + size;
+    reservedBytes += size;
+}
+
+void* JsonArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t at = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (!cursor || at + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(bytes + alignment);
+        at = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+    cursor = reinterpret_cast<unsigned char*>(at + bytes);
+    usedBytes += bytes;
+    return reinterpret_cast<void*>(at);
+}
+
+void JsonArena::reset() {
+    if (blocks.size() > 1) {
+        // Fold into one block big enough for everything the last document needed.
+        size_t total = reservedBytes;
+        blocks.clear();
+        reservedBytes = 0;
+        addBlock(total);
+    } else if (!blocks.empty()) {
+        cursor = blocks.front().data.get();
+        limit = cursor + blocks.front().size;
+    }
+    usedBytes = 0;
+}
+
+namespace {
+thread_local JsonArena* currentArena = nullptr;
+}
+
+JsonArena::Scope::Scope(JsonArena& arena) : previous(currentArena) {
+    currentArena = &arena;
+}
+
+JsonArena::Scope::~Scope() {
+    currentArena = previous;
+}
+
+JsonArena* JsonArena::current() {
+    return currentArena;
+}
+
+ArenaJson parseInArena(JsonArena& arena, const std::string& text) {
+    JsonArena::Scope scope(arena);
+    return ArenaJson::parse(text, nullptr, false);
+}
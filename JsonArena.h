@@ -0,0 +1,117 @@
+#ifndef TRADERMADE_JSON_ARENA_H
+#define TRADERMADE_JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Monotonic memory for parsed responses. A /tick_historical page is tens of thousands
+// of small objects and strings; with nlohmann::json each is a separate malloc and
+// free. Parsed into an ArenaJson instead, they are bump-allocated from a few large
+// blocks and released together by reset():
+//
+//   JsonArena arena;                                        // one per worker thread
+//   for (...) {
+//       arena.reset();                                      // previous document is gone
+//       Result<ArenaJson> r = tm.tryGetTickHistoricalData(arena, "EURUSD", from, to, "json");
+//       if (r) decodeTicks(r.value(), ticks);
+//   }
+//
+// After reset() the arena keeps one block sized to the largest document so far, so a
+// steady stream of similar responses leaves the system allocator almost untouched.
+//
+// Rules: a document must be destroyed before its arena is reset or destroyed, and may
+// only be modified or copied on a thread inside a JsonArena::Scope for that arena
+// (the SDK opens one while it parses). An arena is used by one thread at a time.
+class JsonArena {
+public:
+    explicit JsonArena(size_t blockSize = 64 * 1024);
+    ~JsonArena();
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+
+    // Frees everything allocated since the last reset in one step.
+    void reset();
+
+    size_t used() const { return usedBytes; }          // since the last reset
+    size_t reserved() const { return reservedBytes; }  // held from the system
+    size_t blockCount() const { return blocks.size(); }
+
+    // Makes an arena the calling thread's current one until the scope ends. Scopes nest.
+    class Scope {
+    public:
+        explicit Scope(JsonArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        JsonArena* previous;
+    };
+
+    // The calling thread's current arena, or nullptr.
+    static JsonArena* current();
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    unsigned char* cursor = nullptr;
+    unsigned char* limit = nullptr;
+    size_t usedBytes = 0;
+    size_t reservedBytes = 0;
+
+    void addBlock(size_t minimum);
+};
+
+// Allocator for ArenaJson. basic_json default-constructs its allocators, so this one is
+// stateless and draws from JsonArena::current(); allocating without a current arena
+// throws std::logic_error. Deallocation is a no-op: memory returns on reset().
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        JsonArena* arena = JsonArena::current();
+        if (!arena) {
+            throw std::logic_error("ArenaJson allocation outside a JsonArena::Scope.");
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) noexcept { return true; }
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) noexcept { return false; }
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// nlohmann::json with every object, array and string in a JsonArena. Reading works as
+// with nlohmann::json, except that strings are ArenaString: use
+// get_ref<const ArenaString&>() rather than get<std::string>().
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t, double,
+                                       ArenaAllocator>;
+
+// Parses text into arena; a discarded value (is_discarded()) if it is not valid JSON.
+ArenaJson parseInArena(JsonArena& arena, const std::string& text);
+
+#endif
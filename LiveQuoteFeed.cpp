@@ -0,0 +1,167 @@
+#include "LiveQuoteFeed.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "InstrumentRegistry.h"
+#include "TraderMadeDecode.h"
+
+LiveQuoteFeed::LiveQuoteFeed(TraderMade& tm, const std::vector<std::string>& symbols)
+    : LiveQuoteFeed(tm, symbols, Options()) {}
+
+LiveQuoteFeed::LiveQuoteFeed(TraderMade& tm, const std::vector<std::string>& symbols, const Options& options)
+    : tm(tm), options(options), ring(options.capacity) {
+    if (options.maxSymbolsPerRequest == 0) {
+        throw std::invalid_argument("maxSymbolsPerRequest must be at least 1.");
+    }
+    for (const std::string& s : symbols) {
+        subscribe(s);
+    }
+}
+
+LiveQuoteFeed::LiveQuoteFeed(TraderMade& tm, const std::vector<InstrumentId>& ids, const Options& options)
+    : LiveQuoteFeed(tm, std::vector<std::string>(), options) {
+    for (InstrumentId id : ids) {
+        subscribe(id);
+    }
+}
+
+LiveQuoteFeed::~LiveQuoteFeed() {
+    stop();
+}
+
+void LiveQuoteFeed::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (worker.joinable()) {
+        return;
+    }
+    stopping = false;
+    stopToken = CancellationToken();
+    worker = std::thread(&LiveQuoteFeed::run, this);
+}
+
+void LiveQuoteFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopToken.cancel();
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void LiveQuoteFeed::subscribe(const std::string& symbol) {
+    if (symbol.empty()) {
+        throw std::invalid_argument("symbol is required.");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::find(subscribed.begin(), subscribed.end(), symbol) == subscribed.end()) {
+        subscribed.push_back(symbol);
+        ++subscriptionVersion;
+    }
+}
+
+void LiveQuoteFeed::unsubscribe(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find(subscribed.begin(), subscribed.end(), symbol);
+    if (it != subscribed.end()) {
+        subscribed.erase(it);
+        ++subscriptionVersion;
+    }
+}
+
+const std::string& LiveQuoteFeed::symbolOf(InstrumentId id) const {
+    if (!options.registry) {
+        throw std::logic_error("LiveQuoteFeed needs Options::registry to subscribe by InstrumentId.");
+    }
+    return options.registry->symbol(id); // std::out_of_range for unknown IDs
+}
+
+void LiveQuoteFeed::subscribe(InstrumentId id) {
+    subscribe(symbolOf(id));
+}
+
+void LiveQuoteFeed::unsubscribe(InstrumentId id) {
+    unsubscribe(symbolOf(id));
+}
+
+std::vector<std::string> LiveQuoteFeed::symbols() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscribed;
+}
+
+std::string LiveQuoteFeed::lastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastErrorMessage;
+}
+
+void LiveQuoteFeed::run() {
+    std::vector<std::string> batches; // comma separated currency parameter per request
+    uint64_t builtVersion = ~uint64_t(0);
+    std::vector<LiveQuote> decoded;
+    auto next = std::chrono::steady_clock::now();
+    CancellationToken token;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        token = stopToken;
+    }
+    CancellationScope scope(token);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wake.wait_until(lock, next, [this] { return stopping; })) {
+                return;
+            }
+            if (builtVersion != subscriptionVersion) {
+                batches.clear();
+                for (size_t i = 0; i < subscribed.size(); i += options.maxSymbolsPerRequest) {
+                    std::string batch;
+                    size_t end = std::min(subscribed.size(), i + options.maxSymbolsPerRequest);
+                    for (size_t j = i; j < end; ++j) {
+                        if (!batch.empty()) batch += ',';
+                        batch += subscribed[j];
+                    }
+                    batches.push_back(batch);
+                }
+                builtVersion = subscriptionVersion;
+            }
+        }
+        if (options.calendar) {
+            int64_t nowMs = MarketCalendar::nowMs();
+            if (!options.calendar->isOpen(options.market, nowMs)) {
+                closedCount.fetch_add(1, std::memory_order_relaxed);
+                next = std::chrono::steady_clock::now() +
+                       options.calendar->pollDelay(options.market, nowMs, options.interval, options.closedInterval);
+                continue;
+            }
+        }
+        next += options.interval;
+
+        for (const std::string& batch : batches) {
+            Result<nlohmann::json> result = tm.tryGetLiveRates(batch);
+            if (!result && result.error().code == ErrorCode::Cancelled) {
+                return;
+            }
+            pollCount.fetch_add(1, std::memory_order_relaxed);
+            if (!result) {
+                errorCount.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(mutex);
+                lastErrorMessage = result.error().message;
+                continue;
+            }
+            decoded.clear();
+            decodeLiveQuotes(result.value(), decoded);
+            for (const LiveQuote& q : decoded) {
+                ring.publish(q);
+            }
+        }
+
+        // Do not try to catch up on missed ticks after a slow poll.
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef TRADERMADE_LIVE_QUOTE_FEED_H
+#define TRADERMADE_LIVE_QUOTE_FEED_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TraderMadeSDK.h"
+#include "BroadcastRing.h"
+#include "MarketCalendar.h"
+
+class InstrumentRegistry;
+
+// Polls /live for a subscribed symbol set on a dedicated thread and publishes the
+// decoded quotes into a lock-free broadcast ring. Any number of consumers read
+// the same quotes without extra API calls:
+//
+//   LiveQuoteFeed feed(tm, {"EURUSD", "GBPUSD"});
+//   feed.start();
+//   LiveQuoteFeed::Consumer c = feed.consumer();
+//   LiveQuote q;
+//   while (c.poll(q)) { ... }
+//
+// The feed polls through tm from its own thread. tm's keys and base URL may be changed
+// while the feed runs (see setRestApiKey); the next poll uses the new ones.
+class LiveQuoteFeed {
+public:
+    struct Options {
+        std::chrono::milliseconds interval{1000}; // time between polls
+        size_t capacity = 4096;                    // ring size, power of two
+        size_t maxSymbolsPerRequest = 50;          // /live calls are batched by this many symbols
+
+        // Optional market-hours gate: while `market` is closed the feed does not poll,
+        // and checks back after closedInterval (0 = sleep until the next open).
+        const MarketCalendar* calendar = nullptr;
+        std::string market = "Forex";
+        std::chrono::milliseconds closedInterval{0};
+
+        // Optional: enables the InstrumentId overloads. Must outlive the feed.
+        const InstrumentRegistry* registry = nullptr;
+    };
+
+    using Consumer = BroadcastRing<LiveQuote>::Cursor;
+
+    LiveQuoteFeed(TraderMade& tm, const std::vector<std::string>& symbols);
+    LiveQuoteFeed(TraderMade& tm, const std::vector<std::string>& symbols, const Options& options);
+    // Subscribes to instruments by ID; needs options.registry.
+    LiveQuoteFeed(TraderMade& tm, const std::vector<InstrumentId>& ids, const Options& options);
+    ~LiveQuoteFeed();
+
+    LiveQuoteFeed(const LiveQuoteFeed&) = delete;
+    LiveQuoteFeed& operator=(const LiveQuoteFeed&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return worker.joinable(); }
+
+    // Symbol set changes take effect from the next poll.
+    void subscribe(const std::string& symbol);
+    void unsubscribe(const std::string& symbol);
+    void subscribe(InstrumentId id);   // these two need Options::registry
+    void unsubscribe(InstrumentId id);
+    std::vector<std::string> symbols() const;
+
+    // New consumer; by default it only sees quotes published after it was created.
+    Consumer consumer(bool fromLatest = true) const { return Consumer(ring, fromLatest); }
+
+    // Counters
+    uint64_t polls() const { return pollCount.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return errorCount.load(std::memory_order_relaxed); }
+    uint64_t skippedClosed() const { return closedCount.load(std::memory_order_relaxed); }
+    uint64_t published() const { return ring.published(); }
+    std::string lastError() const;
+
+private:
+    TraderMade& tm;
+    Options options;
+    BroadcastRing<LiveQuote> ring;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::string> subscribed;
+    uint64_t subscriptionVersion = 0;
+    bool stopping = false;
+    CancellationToken stopToken; // aborts the poll in flight on stop()
+    std::string lastErrorMessage;
+    std::thread worker;
+
+    std::atomic<uint64_t> pollCount{0};
+    std::atomic<uint64_t> errorCount{0};
+    std::atomic<uint64_t> closedCount{0};
+
+    const std::string& symbolOf(InstrumentId id) const;
+    void run();
+};
+
+#endif
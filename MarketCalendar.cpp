@@ -0,0 +1,244 @@
+#include "MarketCalendar.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include "TraderMadeSDK.h"
+
+constexpr int64_t MarketCalendar::MS_PER_WEEK;
+
+namespace {
+
+const int64_t MS_PER_MINUTE = 60 * 1000;
+const int64_t MS_PER_DAY = 24 * 60 * MS_PER_MINUTE;
+
+int64_t floorMod(int64_t a, int64_t b) {
+    int64_t m = a % b;
+    return m < 0 ? m + b : m;
+}
+
+// 1970-01-01 was a Thursday (day 4 with Sunday = 0).
+int64_t weekOffset(int64_t timeMs) {
+    return floorMod(timeMs + 4 * MS_PER_DAY, MarketCalendar::MS_PER_WEEK);
+}
+
+int parseDay(const std::string& s) {
+    static const char* NAMES[] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+    if (s.size() >= 3) {
+        std::string prefix;
+        for (size_t i = 0; i < 3; ++i) prefix += static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+        for (int d = 0; d < 7; ++d) {
+            if (prefix == NAMES[d]) return d;
+        }
+    }
+    throw std::invalid_argument("Invalid day name: " + s);
+}
+
+// "HH:MM" (24:00 allowed for end of day)
+int parseMinute(const std::string& s) {
+    size_t colon = s.find(':');
+    if (colon == std::string::npos) {
+        throw std::invalid_argument("Invalid time (expected HH:MM): " + s);
+    }
+    int h = std::atoi(s.substr(0, colon).c_str());
+    int m = std::atoi(s.substr(colon + 1, 2).c_str());
+    if (h < 0 || h > 24 || m < 0 || m > 59 || (h == 24 && m != 0)) {
+        throw std::invalid_argument("Invalid time (expected HH:MM): " + s);
+    }
+    return h * 60 + m;
+}
+
+// "UTC", "GMT", "Z", "UTC+10:00", "GMT-5" -> offset in minutes; false for named zones.
+bool parseOffset(const std::string& tz, int& minutes) {
+    minutes = 0;
+    if (tz.empty() || tz == "UTC" || tz == "GMT" || tz == "Z" || tz == "Etc/UTC") {
+        return true;
+    }
+    if (tz.size() < 4 || (tz.compare(0, 3, "UTC") != 0 && tz.compare(0, 3, "GMT") != 0) ||
+        (tz[3] != '+' && tz[3] != '-')) {
+        return false;
+    }
+    std::string rest = tz.substr(4);
+    size_t colon = rest.find(':');
+    int h = std::atoi(rest.substr(0, colon).c_str());
+    int m = colon == std::string::npos ? 0 : std::atoi(rest.substr(colon + 1).c_str());
+    minutes = (tz[3] == '-' ? -1 : 1) * (h * 60 + m);
+    return true;
+}
+
+std::string stringField(const nlohmann::json& j, const char* key) {
+    auto it = j.find(key);
+    return it != j.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+} // namespace
+
+size_t MarketCalendar::load(TraderMade& tm) {
+    return loadMarketOpenTiming(tm.getMarketOpenTiming());
+}
+
+size_t MarketCalendar::loadMarketOpenTiming(const nlohmann::json& body) {
+    auto list = body.is_object() ? body.find("markets") : body.end();
+    if (list == body.end() || !list->is_array()) {
+        throw std::invalid_argument("market_opening_times response has no markets array.");
+    }
+    size_t loaded = 0;
+    for (const nlohmann::json& entry : *list) {
+        std::string name = stringField(entry, "market");
+        auto sessions = entry.find("sessions");
+        if (name.empty() || sessions == entry.end() || !sessions->is_array()) {
+            continue;
+        }
+        int offsetMinutes = 0;
+        if (!parseOffset(stringField(entry, "timezone"), offsetMinutes)) {
+            skipped.push_back(name);
+            continue;
+        }
+        // Parse every session before adding any, so a bad one skips the whole market.
+        std::vector<std::array<int, 4>> parsed;
+        try {
+            for (const nlohmann::json& s : *sessions) {
+                parsed.push_back({{parseDay(stringField(s, "open_day")),
+                                   parseMinute(stringField(s, "open_time")) - offsetMinutes,
+                                   parseDay(stringField(s, "close_day")),
+                                   parseMinute(stringField(s, "close_time")) - offsetMinutes}});
+            }
+        } catch (const std::invalid_argument&) {
+            skipped.push_back(name);
+            continue;
+        }
+        findOrAdd(name);
+        for (const std::array<int, 4>& p : parsed) {
+            addSession(name, p[0], p[1], p[2], p[3]);
+        }
+        ++loaded;
+    }
+    return loaded;
+}
+
+void MarketCalendar::addSession(const std::string& market, int openDay, int openMinute, int closeDay, int closeMinute) {
+    int64_t open = floorMod(openDay * MS_PER_DAY + openMinute * MS_PER_MINUTE, MS_PER_WEEK);
+    int64_t close = floorMod(closeDay * MS_PER_DAY + closeMinute * MS_PER_MINUTE, MS_PER_WEEK);
+    Market& m = findOrAdd(market);
+    if (close > open) {
+        addInterval(m, open, close);
+    } else {
+        // Wraps past Saturday 24:00 (or spans the whole week when close == open).
+        addInterval(m, open, MS_PER_WEEK);
+        if (close > 0) addInterval(m, 0, close);
+    }
+}
+
+std::vector<std::string> MarketCalendar::markets() const {
+    std::vector<std::string> names;
+    for (const Market& m : marketList) {
+        names.push_back(m.name);
+    }
+    return names;
+}
+
+bool MarketCalendar::isOpen(const std::string& market, int64_t timeMs) const {
+    const Market* m = find(market);
+    return !m || sessionAt(*m, weekOffset(timeMs)) >= 0;
+}
+
+int64_t MarketCalendar::nextOpen(const std::string& market, int64_t timeMs) const {
+    const Market* m = find(market);
+    if (!m) {
+        return timeMs;
+    }
+    if (m->sessions.empty()) {
+        return -1;
+    }
+    int64_t week = weekOffset(timeMs);
+    if (sessionAt(*m, week) >= 0) {
+        return timeMs;
+    }
+    auto it = std::upper_bound(m->sessions.begin(), m->sessions.end(), week,
+                               [](int64_t t, const std::pair<int64_t, int64_t>& s) { return t < s.first; });
+    int64_t open = it != m->sessions.end() ? it->first : m->sessions.front().first + MS_PER_WEEK;
+    return timeMs + (open - week);
+}
+
+int64_t MarketCalendar::nextClose(const std::string& market, int64_t timeMs) const {
+    const Market* m = find(market);
+    if (!m) {
+        return -1;
+    }
+    int64_t week = weekOffset(timeMs);
+    long i = sessionAt(*m, week);
+    if (i < 0) {
+        return timeMs;
+    }
+    const auto& sessions = m->sessions;
+    int64_t close = sessions[static_cast<size_t>(i)].second;
+    // A session ending at the week boundary continues into one starting at 0.
+    if (close == MS_PER_WEEK && sessions.front().first == 0) {
+        if (sessions.front().second == MS_PER_WEEK) {
+            return -1; // open all week
+        }
+        close = MS_PER_WEEK + sessions.front().second;
+    }
+    return timeMs + (close - week);
+}
+
+std::chrono::milliseconds MarketCalendar::pollDelay(const std::string& market, int64_t timeMs,
+                                                    std::chrono::milliseconds openInterval,
+                                                    std::chrono::milliseconds closedInterval) const {
+    int64_t open = nextOpen(market, timeMs);
+    if (open == timeMs) {
+        return openInterval;
+    }
+    if (open < 0) {
+        return closedInterval.count() > 0 ? closedInterval : std::chrono::milliseconds(MS_PER_DAY);
+    }
+    std::chrono::milliseconds untilOpen(open - timeMs);
+    return closedInterval.count() > 0 ? std::min(closedInterval, untilOpen) : untilOpen;
+}
+
+int64_t MarketCalendar::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const MarketCalendar::Market* MarketCalendar::find(const std::string& market) const {
+    for (const Market& m : marketList) {
+        if (m.name == market) return &m;
+    }
+    return nullptr;
+}
+
+MarketCalendar::Market& MarketCalendar::findOrAdd(const std::string& market) {
+    for (Market& m : marketList) {
+        if (m.name == market) return m;
+    }
+    marketList.push_back(Market{market, {}});
+    return marketList.back();
+}
+
+void MarketCalendar::addInterval(Market& m, int64_t open, int64_t close) {
+    auto& s = m.sessions;
+    s.emplace_back(open, close);
+    std::sort(s.begin(), s.end());
+    std::vector<std::pair<int64_t, int64_t>> merged;
+    for (const auto& interval : s) {
+        if (!merged.empty() && interval.first <= merged.back().second) {
+            merged.back().second = std::max(merged.back().second, interval.second);
+        } else {
+            merged.push_back(interval);
+        }
+    }
+    s.swap(merged);
+}
+
+long MarketCalendar::sessionAt(const Market& m, int64_t weekMs) {
+    auto it = std::upper_bound(m.sessions.begin(), m.sessions.end(), weekMs,
+                               [](int64_t t, const std::pair<int64_t, int64_t>& s) { return t < s.first; });
+    if (it == m.sessions.begin()) {
+        return -1;
+    }
+    --it;
+    return weekMs < it->second ? static_cast<long>(it - m.sessions.begin()) : -1;
+}
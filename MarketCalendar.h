@@ -0,0 +1,75 @@
+#ifndef TRADERMADE_MARKET_CALENDAR_H
+#define TRADERMADE_MARKET_CALENDAR_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class TraderMade;
+
+// Weekly trading calendar built once from getMarketOpenTiming(). Each market's
+// sessions are folded into a sorted, merged list of [open, close) offsets within
+// the week, so "is it open at t" is a binary search instead of a call to
+// getOpenMarketStatus():
+//
+//   MarketCalendar calendar;
+//   calendar.load(tm);
+//   if (!calendar.isOpen("Forex", nowMs)) { ... sleep until calendar.nextOpen("Forex", nowMs) ... }
+//
+// Times are milliseconds since the Unix epoch (UTC), like LiveQuote::timestampMs.
+// Session times must be UTC or a fixed offset ("UTC+10:00"); markets in any other
+// timezone, or with a session that does not parse, are skipped whole and listed by
+// skippedMarkets(). Load before sharing between threads; the const members are safe
+// to call concurrently afterwards.
+class MarketCalendar {
+public:
+    static constexpr int64_t MS_PER_WEEK = 7LL * 24 * 60 * 60 * 1000;
+
+    // Calls getMarketOpenTiming(); throws whatever it throws. Returns the number of markets loaded.
+    size_t load(TraderMade& tm);
+    // {"markets": [{"market", "timezone", "sessions": [{"open_day", "open_time", "close_day", "close_time"}]}]}
+    size_t loadMarketOpenTiming(const nlohmann::json& body);
+
+    // Adds one weekly session; days are 0 = Sunday .. 6 = Saturday, times in minutes (UTC).
+    void addSession(const std::string& market, int openDay, int openMinute, int closeDay, int closeMinute);
+
+    bool hasMarket(const std::string& market) const { return find(market) != nullptr; }
+    std::vector<std::string> markets() const;
+    const std::vector<std::string>& skippedMarkets() const { return skipped; }
+
+    // Unknown markets are reported as open, so a missing calendar never stops polling.
+    bool isOpen(const std::string& market, int64_t timeMs) const;
+    // Next time >= timeMs at which the market opens / closes; timeMs if already in that
+    // state, -1 if it never does (never open, or always open).
+    int64_t nextOpen(const std::string& market, int64_t timeMs) const;
+    int64_t nextClose(const std::string& market, int64_t timeMs) const;
+
+    // Delay before the next poll of something that trades on market: openInterval while
+    // open; while closed, closedInterval or the time until the next open, whichever is
+    // shorter. closedInterval = 0 suspends until the open.
+    std::chrono::milliseconds pollDelay(const std::string& market, int64_t timeMs,
+                                        std::chrono::milliseconds openInterval,
+                                        std::chrono::milliseconds closedInterval) const;
+
+    static int64_t nowMs();
+
+private:
+    struct Market {
+        std::string name;
+        std::vector<std::pair<int64_t, int64_t>> sessions; // [open, close) ms within the week, sorted and merged
+    };
+
+    std::vector<Market> marketList;
+    std::vector<std::string> skipped;
+
+    const Market* find(const std::string& market) const;
+    Market& findOrAdd(const std::string& market);
+    static void addInterval(Market& m, int64_t open, int64_t close);
+    // Index of the session containing weekMs, or -1.
+    static long sessionAt(const Market& m, int64_t weekMs);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "QuoteTable.h"
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include "InstrumentRegistry.h"
+#include "TraderMadeDecode.h"
+
+constexpr size_t QuoteTable::CACHE_LINE;
+
+QuoteTable::QuoteTable(size_t capacity) : slotCount(capacity), names(capacity), used(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("QuoteTable capacity must be greater than zero.");
+    }
+    // Slots are cache-line aligned; C++14 operator new does not honour over-alignment.
+    storage.reset(new unsigned char[capacity * sizeof(Slot) + CACHE_LINE]);
+    void* p = storage.get();
+    size_t space = capacity * sizeof(Slot) + CACHE_LINE;
+    slots = static_cast<Slot*>(std::align(CACHE_LINE, capacity * sizeof(Slot), p, space));
+    for (size_t i = 0; i < capacity; ++i) {
+        new (&slots[i]) Slot();
+    }
+    ids.reserve(capacity);
+    scratch.reserve(64);
+}
+
+QuoteTable::QuoteTable(const InstrumentRegistry& registry, size_t extraCapacity)
+    : QuoteTable(std::max<size_t>(1, registry.size() + extraCapacity)) {
+    for (size_t i = 0; i < registry.size(); ++i) {
+        intern(registry.symbol(static_cast<InstrumentId>(i)));
+    }
+}
+
+QuoteTable::~QuoteTable() {
+    for (size_t i = 0; i < slotCount; ++i) {
+        slots[i].~Slot();
+    }
+}
+
+InstrumentId QuoteTable::intern(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(symbol);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    size_t id = used.load(std::memory_order_relaxed);
+    if (id == slotCount) {
+        throw std::length_error("QuoteTable is full (capacity " + std::to_string(slotCount) + ").");
+    }
+    LiveQuote named;
+    named.setSymbol(symbol);
+    std::copy(std::begin(named.symbol), std::end(named.symbol), names[id].begin());
+    ids.emplace(symbol, static_cast<InstrumentId>(id));
+    used.store(id + 1, std::memory_order_release);
+    return static_cast<InstrumentId>(id);
+}
+
+InstrumentId QuoteTable::find(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(symbol);
+    return it == ids.end() ? -1 : it->second;
+}
+
+const char* QuoteTable::symbol(InstrumentId id) const {
+    return valid(id) ? names[static_cast<size_t>(id)].data() : nullptr;
+}
+
+void QuoteTable::store(InstrumentId id, const LiveQuote& quote) {
+    if (!valid(id)) {
+        throw std::out_of_range("QuoteTable id " + std::to_string(id) + " has not been interned.");
+    }
+    slots[id].quote.store(quote);
+}
+
+InstrumentId QuoteTable::update(const LiveQuote& quote) {
+    InstrumentId id;
+    try {
+        id = intern(quote.symbol);
+    } catch (const std::length_error&) {
+        return -1;
+    }
+    slots[id].quote.store(quote);
+    return id;
+}
+
+size_t QuoteTable::update(const std::vector<LiveQuote>& quotes) {
+    size_t stored = 0;
+    for (const LiveQuote& q : quotes) {
+        if (update(q) >= 0) {
+            ++stored;
+        }
+    }
+    return stored;
+}
+
+size_t QuoteTable::updateFromLiveRates(const nlohmann::json& body) {
+    scratch.clear();
+    decodeLiveQuotes(body, scratch);
+    return update(scratch);
+}
+
+bool QuoteTable::tryLoad(InstrumentId id, LiveQuote& out, uint64_t& version) const {
+    if (!valid(id)) {
+        return false;
+    }
+    return slots[id].quote.tryLoad(out, version) && version != 0;
+}
+
+bool QuoteTable::load(InstrumentId id, LiveQuote& out) const {
+    if (!valid(id) || slots[id].quote.version() == 0) {
+        return false;
+    }
+    out = slots[id].quote.load();
+    return true;
+}
+
+uint64_t QuoteTable::version(InstrumentId id) const {
+    return valid(id) ? slots[id].quote.version() : 0;
+}
@@ -0,0 +1,91 @@
+#ifndef TRADERMADE_QUOTE_TABLE_H
+#define TRADERMADE_QUOTE_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "TraderMadeTypes.h"
+#include "Seqlock.h"
+
+class InstrumentRegistry;
+
+// Fixed-capacity table holding the latest quote per symbol. Each symbol gets a
+// dense ID and a cache-line aligned seqlock slot, so readers on any number of
+// threads get a consistent bid/ask/mid/timestamp without locks or allocations:
+//
+//   QuoteTable table(256);
+//   InstrumentId eurusd = table.intern("EURUSD"); // resolve once
+//   table.updateFromLiveRates(tm.getLiveRates("EURUSD,GBPUSD"));
+//   LiveQuote q;
+//   if (table.load(eurusd, q)) { ... q.mid ... }
+//
+// Updates must come from one writer thread at a time (e.g. a LiveQuoteFeed
+// consumer or a StreamingClient handler). Symbol lookups take a mutex; the
+// ID-based read path does not.
+class QuoteTable {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    explicit QuoteTable(size_t capacity);
+    // Pre-interns every registry instrument in ID order, so table IDs equal registry IDs.
+    QuoteTable(const InstrumentRegistry& registry, size_t extraCapacity = 0);
+    ~QuoteTable();
+
+    QuoteTable(const QuoteTable&) = delete;
+    QuoteTable& operator=(const QuoteTable&) = delete;
+
+    size_t capacity() const { return slotCount; }
+    size_t size() const { return used.load(std::memory_order_acquire); }
+
+    // ID for symbol, assigning the next free slot if needed. Throws std::length_error when full.
+    InstrumentId intern(const std::string& symbol);
+    // ID for symbol, or -1 if it has never been interned.
+    InstrumentId find(const std::string& symbol) const;
+    // Symbol of an interned ID, or nullptr.
+    const char* symbol(InstrumentId id) const;
+
+    // --- Writer side ---
+
+    void store(InstrumentId id, const LiveQuote& quote);
+    // Interns quote.symbol and stores the quote; returns its ID (-1 if the table is full).
+    InstrumentId update(const LiveQuote& quote);
+    size_t update(const std::vector<LiveQuote>& quotes);
+    // Decodes a /live response body and stores every quote in it.
+    size_t updateFromLiveRates(const nlohmann::json& body);
+
+    // --- Reader side (lock-free) ---
+
+    // Latest quote for id; false if id is unknown or has never been written.
+    bool load(InstrumentId id, LiveQuote& out) const;
+    // Single attempt; fails if it overlapped a write. version increases with every store.
+    bool tryLoad(InstrumentId id, LiveQuote& out, uint64_t& version) const;
+    // 0 until the first store; compare against a previous value to detect new quotes.
+    uint64_t version(InstrumentId id) const;
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        Seqlock<LiveQuote> quote; // 56 bytes: one slot per cache line
+    };
+    using SymbolName = std::array<char, sizeof(LiveQuote::symbol)>;
+
+    size_t slotCount;
+    std::unique_ptr<unsigned char[]> storage;
+    Slot* slots;
+    std::vector<SymbolName> names; // sized once; entry i is written before used > i
+    std::atomic<size_t> used;
+
+    mutable std::mutex mutex; // guards ids and slot assignment
+    std::unordered_map<std::string, InstrumentId> ids;
+    std::vector<LiveQuote> scratch; // writer-owned decode buffer
+
+    bool valid(InstrumentId id) const { return id >= 0 && static_cast<size_t>(id) < size(); }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "Resample.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRADERMADE_HAVE_SSE2 1
+#endif
+
+namespace {
+
+// Min and max of p[0..n) (n > 0). SSE2 is part of every x86-64 target, so the
+// vector path needs no runtime check; NaNs are not expected in price columns.
+void minMax(const double* p, size_t n, double& lo, double& hi) {
+    size_t i = 0;
+    double l = p[0];
+    double h = p[0];
+#ifdef TRADERMADE_HAVE_SSE2
+    if (n >= 8) {
+        __m128d l0 = _mm_loadu_pd(p), l1 = _mm_loadu_pd(p + 2);
+        __m128d h0 = l0, h1 = l1;
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m128d a = _mm_loadu_pd(p + i);
+            __m128d b = _mm_loadu_pd(p + i + 2);
+            l0 = _mm_min_pd(l0, a);
+            l1 = _mm_min_pd(l1, b);
+            h0 = _mm_max_pd(h0, a);
+            h1 = _mm_max_pd(h1, b);
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_min_pd(l0, l1));
+        l = std::min(lanes[0], lanes[1]);
+        _mm_storeu_pd(lanes, _mm_max_pd(h0, h1));
+        h = std::max(lanes[0], lanes[1]);
+    }
+#endif
+    for (; i < n; ++i) {
+        l = p[i] < l ? p[i] : l;
+        h = p[i] > h ? p[i] : h;
+    }
+    lo = l;
+    hi = h;
+}
+
+double columnMin(const double* p, size_t n) {
+    double lo, hi;
+    minMax(p, n, lo, hi);
+    return lo;
+}
+
+double columnMax(const double* p, size_t n) {
+    double lo, hi;
+    minMax(p, n, lo, hi);
+    return hi;
+}
+
+void checkInterval(int64_t intervalMs) {
+    if (intervalMs <= 0) {
+        throw std::invalid_argument("Resample interval must be positive.");
+    }
+}
+
+// Calls emit(begin, end, bucket) for each run of rows sharing a bucket.
+template <typename Emit>
+void forEachBucket(const int64_t* t, size_t count, int64_t intervalMs, int64_t originMs, Emit emit) {
+    size_t begin = 0;
+    while (begin < count) {
+        int64_t bucket = bucketStart(t[begin], intervalMs, originMs);
+        int64_t next = bucket + intervalMs;
+        size_t end = begin + 1;
+        while (end < count && t[end] < next) {
+            if (t[end] < t[end - 1]) {
+                throw std::invalid_argument("Resample input must be sorted by time.");
+            }
+            ++end;
+        }
+        emit(begin, end, bucket);
+        begin = end;
+    }
+}
+
+} // namespace
+
+size_t resampleTicks(const int64_t* timestampMs, const double* price, size_t count,
+                     int64_t intervalMs, BarSeries& out, int64_t originMs) {
+    checkInterval(intervalMs);
+    size_t before = out.size();
+    forEachBucket(timestampMs, count, intervalMs, originMs, [&](size_t begin, size_t end, int64_t bucket) {
+        double lo, hi;
+        minMax(price + begin, end - begin, lo, hi);
+        out.push_back(bucket, price[begin], hi, lo, price[end - 1]);
+    });
+    return out.size() - before;
+}
+
+size_t resampleTicks(const TickSeries& ticks, PriceField field, int64_t intervalMs, BarSeries& out, int64_t originMs) {
+    const std::vector<double>& column = field == PriceField::Bid ? ticks.bid
+                                      : field == PriceField::Ask ? ticks.ask
+                                      :                            ticks.mid;
+    return resampleTicks(ticks.timestampMs.data(), column.data(), ticks.size(), intervalMs, out, originMs);
+}
+
+size_t resampleBars(const BarSeries& bars, int64_t intervalMs, BarSeries& out, int64_t originMs) {
+    checkInterval(intervalMs);
+    size_t before = out.size();
+    forEachBucket(bars.timestampMs.data(), bars.size(), intervalMs, originMs,
+                  [&](size_t begin, size_t end, int64_t bucket) {
+        size_t n = end - begin;
+        out.push_back(bucket, bars.open[begin], columnMax(bars.high.data() + begin, n),
+                      columnMin(bars.low.data() + begin, n), bars.close[end - 1]);
+    });
+    return out.size() - before;
+}
@@ -0,0 +1,38 @@
+#ifndef TRADERMADE_RESAMPLE_H
+#define TRADERMADE_RESAMPLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TraderMadeTypes.h"
+
+// Local OHLC resampling, so one tick or minute-bar download serves every bar width:
+//
+//   TickSeries ticks;
+//   decodeTicks(tm.getTickHistoricalData("EURUSD", start, end, "json"), ticks);
+//   BarSeries m1, m5, h1;
+//   resampleTicks(ticks, PriceField::Mid, 60000, m1);
+//   resampleBars(m1, 5 * 60000, m5);        // coarser bars from finer ones
+//   resampleBars(m1, 3600000, h1);
+//
+// Input must be ascending by time. Bars are aligned to originMs (UTC midnight of the
+// epoch by default, which aligns minute, hourly and daily bars the way the API does),
+// stamped with their open time, and only emitted for buckets that contain data.
+// Results are appended to out.
+
+enum class PriceField { Bid, Ask, Mid };
+
+size_t resampleTicks(const int64_t* timestampMs, const double* price, size_t count,
+                     int64_t intervalMs, BarSeries& out, int64_t originMs = 0);
+size_t resampleTicks(const TickSeries& ticks, PriceField field,
+                     int64_t intervalMs, BarSeries& out, int64_t originMs = 0);
+
+size_t resampleBars(const BarSeries& bars, int64_t intervalMs, BarSeries& out, int64_t originMs = 0);
+
+// Bucket open time for t.
+inline int64_t bucketStart(int64_t t, int64_t intervalMs, int64_t originMs = 0) {
+    int64_t offset = (t - originMs) % intervalMs;
+    return t - (offset < 0 ? offset + intervalMs : offset);
+}
+
+#endif
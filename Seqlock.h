@@ -0,0 +1,78 @@
+#ifndef TRADERMADE_SEQLOCK_H
+#define TRADERMADE_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock holding a trivially copyable T. Readers never block
+// the writer and never allocate; a read that overlaps a write is detected and retried.
+// The payload is stored as relaxed atomic words so concurrent access is well defined.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock requires a trivially copyable type.");
+
+public:
+    Seqlock() : seq(0) {
+        for (auto& w : words) w.store(0, std::memory_order_relaxed);
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // Writer side; only one thread may call store() at a time.
+    void store(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        uint64_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Single read attempt. Fails if a write was in progress or completed meanwhile.
+    // version is even and equals 2 * (number of completed stores).
+    bool tryLoad(T& out, uint64_t& version) const {
+        uint64_t s1 = seq.load(std::memory_order_acquire);
+        if (s1 & 1) {
+            return false;
+        }
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != s1) {
+            return false;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        version = s1;
+        return true;
+    }
+
+    // Spins until a consistent snapshot is read.
+    T load() const {
+        T out;
+        uint64_t version;
+        while (!tryLoad(out, version)) {
+        }
+        return out;
+    }
+
+    uint64_t version() const { return seq.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> words[WORDS];
+};
+
+template <typename T>
+constexpr size_t Seqlock<T>::WORDS;
+
+#endif
@@ -0,0 +1,591 @@
+#include "StreamingClient.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include "TraderMadeSDK.h"
+#include "WebSocketProtocol.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef TRADERMADE_WITH_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+namespace {
+
+const int READ_TIMEOUT_MS = 200;
+
+struct WsUrl {
+    bool secure = false;
+    std::string host;
+    std::string port;
+    std::string path;
+};
+
+WsUrl parseUrl(const std::string& url) {
+    WsUrl u;
+    size_t rest = 0;
+    if (url.compare(0, 6, "wss://") == 0) {
+        u.secure = true;
+        rest = 6;
+    } else if (url.compare(0, 5, "ws://") == 0) {
+        rest = 5;
+    } else {
+        throw std::invalid_argument("Streaming url must start with ws:// or wss://");
+    }
+    size_t slash = url.find('/', rest);
+    std::string authority = url.substr(rest, slash == std::string::npos ? std::string::npos : slash - rest);
+    u.path = slash == std::string::npos ? "/" : url.substr(slash);
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        u.host = authority.substr(0, colon);
+        u.port = authority.substr(colon + 1);
+    } else {
+        u.host = authority;
+        u.port = u.secure ? "443" : "80";
+    }
+    if (u.host.empty()) {
+        throw std::invalid_argument("Streaming url has no host.");
+    }
+    return u;
+}
+
+bool startsWithIgnoreCase(const char* text, const char* prefix) {
+    for (; *prefix; ++text, ++prefix) {
+        if (std::tolower(static_cast<unsigned char>(*text)) != std::tolower(static_cast<unsigned char>(*prefix))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds "key": in a flat JSON object and returns a pointer to the value.
+const char* findValue(const char* data, size_t length, const char* key) {
+    size_t keyLength = std::strlen(key);
+    const char* end = data + length;
+    for (const char* p = data; p + keyLength + 2 <= end; ++p) {
+        if (*p != '"' || p[keyLength + 1] != '"' || std::memcmp(p + 1, key, keyLength) != 0) {
+            continue;
+        }
+        const char* v = p + keyLength + 2;
+        while (v < end && (*v == ' ' || *v == '\t')) ++v;
+        if (v == end || *v != ':') continue;
+        ++v;
+        while (v < end && (*v == ' ' || *v == '\t')) ++v;
+        return v < end ? v : nullptr;
+    }
+    return nullptr;
+}
+
+// Bounded number parse (accepts quoted numbers, as the feed sends "ts" as a string).
+bool parseNumber(const char* value, const char* end, double& out) {
+    if (value < end && *value == '"') ++value;
+    char buffer[40];
+    size_t n = 0;
+    while (value + n < end && n < sizeof(buffer) - 1 &&
+           (std::isdigit(static_cast<unsigned char>(value[n])) || value[n] == '.' || value[n] == '-' ||
+            value[n] == '+' || value[n] == 'e' || value[n] == 'E')) {
+        buffer[n] = value[n];
+        ++n;
+    }
+    if (n == 0) return false;
+    buffer[n] = '\0';
+    char* parsedEnd = nullptr;
+    out = std::strtod(buffer, &parsedEnd);
+    return parsedEnd != buffer;
+}
+
+} // namespace
+
+// One TCP (optionally TLS) connection. Used only from the streaming thread.
+class StreamingClient::Session {
+public:
+    ~Session() { close(); }
+
+    int fd() const { return sock; }
+
+    void open(const WsUrl& url) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        int rc = getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &results);
+        if (rc != 0) {
+            throw std::runtime_error("Cannot resolve " + url.host + ": " + gai_strerror(rc));
+        }
+        for (addrinfo* ai = results; ai && sock < 0; ai = ai->ai_next) {
+            int s = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (s < 0) continue;
+            if (::connect(s, ai->ai_addr, ai->ai_addrlen) == 0) {
+                sock = s;
+            } else {
+                ::close(s);
+            }
+        }
+        freeaddrinfo(results);
+        if (sock < 0) {
+            throw std::runtime_error("Cannot connect to " + url.host + ":" + url.port);
+        }
+        int one = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        timeval tv{};
+        tv.tv_sec = READ_TIMEOUT_MS / 1000;
+        tv.tv_usec = (READ_TIMEOUT_MS % 1000) * 1000;
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+        if (url.secure) {
+#ifdef TRADERMADE_WITH_OPENSSL
+            ctx = SSL_CTX_new(TLS_client_method());
+            if (!ctx) throw std::runtime_error("SSL_CTX_new failed.");
+            SSL_CTX_set_default_verify_paths(ctx);
+            SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+            ssl = SSL_new(ctx);
+            SSL_set_fd(ssl, sock);
+            SSL_set_tlsext_host_name(ssl, url.host.c_str());
+            SSL_set1_host(ssl, url.host.c_str());
+            while (true) {
+                int r = SSL_connect(ssl);
+                if (r == 1) break;
+                int err = SSL_get_error(ssl, r);
+                if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+                    throw std::runtime_error("TLS handshake with " + url.host + " failed.");
+                }
+            }
+#else
+            throw std::runtime_error("wss:// requires the SDK to be built with OpenSSL.");
+#endif
+        }
+    }
+
+    // > 0: bytes read, 0: timeout, -1: connection closed or failed
+    long read(char* buffer, size_t length) {
+#ifdef TRADERMADE_WITH_OPENSSL
+        if (ssl) {
+            int n = SSL_read(ssl, buffer, static_cast<int>(length));
+            if (n > 0) return n;
+            int err = SSL_get_error(ssl, n);
+            if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) return 0;
+            if (err == SSL_ERROR_SYSCALL && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+            return -1;
+        }
+#endif
+        ssize_t n = ::recv(sock, buffer, length, 0);
+        if (n > 0) return static_cast<long>(n);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+        return -1;
+    }
+
+    bool writeAll(const char* data, size_t length) {
+        while (length > 0) {
+            long n;
+#ifdef TRADERMADE_WITH_OPENSSL
+            if (ssl) {
+                n = SSL_write(ssl, data, static_cast<int>(length));
+            } else
+#endif
+            {
+                n = static_cast<long>(::send(sock, data, length, MSG_NOSIGNAL));
+            }
+            if (n <= 0) return false;
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef TRADERMADE_WITH_OPENSSL
+        if (ssl) {
+            SSL_free(ssl);
+            ssl = nullptr;
+        }
+        if (ctx) {
+            SSL_CTX_free(ctx);
+            ctx = nullptr;
+        }
+#endif
+        if (sock >= 0) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+private:
+    int sock = -1;
+#ifdef TRADERMADE_WITH_OPENSSL
+    SSL_CTX* ctx = nullptr;
+    SSL* ssl = nullptr;
+#endif
+};
+
+StreamingClient::StreamingClient(const std::string& streamingApiKey)
+    : StreamingClient(streamingApiKey, Options()) {}
+
+StreamingClient::StreamingClient(const std::string& streamingApiKey, const Options& options)
+    : apiKey(streamingApiKey), options(options) {
+    if (apiKey.empty()) {
+        throw std::invalid_argument("Streaming api key must be a non empty string.");
+    }
+    parseUrl(options.url); // validate early
+}
+
+StreamingClient::~StreamingClient() {
+    stop();
+}
+
+void StreamingClient::onQuote(QuoteHandler handler) {
+    quoteHandler = std::move(handler);
+}
+
+void StreamingClient::onStatus(StatusHandler handler) {
+    statusHandler = std::move(handler);
+}
+
+void StreamingClient::subscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::string& s : symbols) {
+        if (!s.empty() && std::find(subscribed.begin(), subscribed.end(), s) == subscribed.end()) {
+            subscribed.push_back(s);
+        }
+    }
+    subscriptionDirty.store(true);
+}
+
+void StreamingClient::unsubscribe(const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::string& s : symbols) {
+        subscribed.erase(std::remove(subscribed.begin(), subscribed.end(), s), subscribed.end());
+    }
+    subscriptionDirty.store(true);
+}
+
+std::vector<std::string> StreamingClient::symbols() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscribed;
+}
+
+void StreamingClient::subscribeStreamingList(TraderMade& tm) {
+    nlohmann::json list = tm.getStreamingCurrencyList();
+    std::vector<std::string> symbols;
+    auto it = list.find("available_currencies");
+    if (it != list.end() && it->is_object()) {
+        for (auto entry = it->begin(); entry != it->end(); ++entry) {
+            symbols.push_back(entry.key());
+        }
+    } else if (it != list.end() && it->is_array()) {
+        for (const nlohmann::json& entry : *it) {
+            if (entry.is_string()) symbols.push_back(entry.get<std::string>());
+        }
+    }
+    if (symbols.empty()) {
+        throw std::runtime_error("Streaming currency list is empty or has an unexpected format.");
+    }
+    subscribe(symbols);
+}
+
+void StreamingClient::start() {
+    if (worker.joinable()) {
+        return;
+    }
+    stopping.store(false);
+    worker = std::thread(&StreamingClient::run, this);
+}
+
+void StreamingClient::start(const CancellationToken& token) {
+    if (worker.joinable()) {
+        return;
+    }
+    start();
+    startToken = token;
+    startSubscription = token.subscribe([this] { interrupt(); });
+}
+
+void StreamingClient::interrupt() {
+    stopping.store(true);
+    int fd = socketFd.load();
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+}
+
+void StreamingClient::stop() {
+    startToken.unsubscribe(startSubscription);
+    startSubscription = 0;
+    interrupt();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void StreamingClient::status(const std::string& message) {
+    if (statusHandler) {
+        statusHandler(message);
+    }
+}
+
+std::string StreamingClient::subscriptionMessage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string symbolList;
+    for (const std::string& s : subscribed) {
+        if (!symbolList.empty()) symbolList += ',';
+        symbolList += s;
+    }
+    return nlohmann::json{{"userKey", apiKey}, {"symbol", symbolList}}.dump();
+}
+
+bool StreamingClient::decodeQuote(const char* data, size_t length, LiveQuote& out) {
+    const char* end = data + length;
+    const char* symbol = findValue(data, length, "symbol");
+    if (!symbol || *symbol != '"') {
+        return false;
+    }
+    ++symbol;
+    size_t n = 0;
+    while (symbol + n < end && symbol[n] != '"' && n < sizeof(out.symbol) - 1) {
+        out.symbol[n] = symbol[n];
+        ++n;
+    }
+    if (n == 0) {
+        return false;
+    }
+    std::memset(out.symbol + n, 0, sizeof(out.symbol) - n);
+
+    const char* bid = findValue(data, length, "bid");
+    const char* ask = findValue(data, length, "ask");
+    if (!bid || !ask || !parseNumber(bid, end, out.bid) || !parseNumber(ask, end, out.ask)) {
+        return false;
+    }
+    const char* mid = findValue(data, length, "mid");
+    if (!mid || !parseNumber(mid, end, out.mid)) {
+        out.mid = (out.bid + out.ask) / 2.0;
+    }
+    double ts = 0.0;
+    const char* tsValue = findValue(data, length, "ts");
+    out.timestampMs = tsValue && parseNumber(tsValue, end, ts) ? static_cast<int64_t>(ts) : 0;
+    return true;
+}
+
+void StreamingClient::run() {
+    WsUrl url = parseUrl(options.url);
+    std::mt19937_64 rng(std::random_device{}());
+    std::chrono::milliseconds backoff = options.reconnectMin;
+    bool first = true;
+
+    while (!stopping.load()) {
+        if (!first) {
+            reconnectCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        first = false;
+        uint64_t before = messageCount.load(std::memory_order_relaxed);
+        try {
+            Session session;
+            session.open(url);
+            socketFd.store(session.fd());
+            if (stopping.load()) {
+                break;
+            }
+            runSession(session);
+        } catch (const std::exception& e) {
+            if (!stopping.load()) {
+                status(std::string("Streaming connection error: ") + e.what());
+            }
+        }
+        socketFd.store(-1);
+        isConnected.store(false);
+        if (stopping.load()) {
+            break;
+        }
+
+        // A session that delivered data resets the backoff.
+        if (messageCount.load(std::memory_order_relaxed) != before) {
+            backoff = options.reconnectMin;
+        }
+        std::uniform_real_distribution<double> jitter(0.5, 1.0);
+        auto wait = std::chrono::milliseconds(static_cast<int64_t>(backoff.count() * jitter(rng)));
+        status("Reconnecting in " + std::to_string(wait.count()) + " ms");
+        auto until = std::chrono::steady_clock::now() + wait;
+        while (!stopping.load() && std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        backoff = std::min(options.reconnectMax, backoff * 2);
+    }
+}
+
+void StreamingClient::runSession(Session& s) {
+    WsUrl url = parseUrl(options.url);
+    std::mt19937 rng(std::random_device{}());
+
+    // --- Handshake ---
+    uint8_t keyBytes[16];
+    for (uint8_t& b : keyBytes) b = static_cast<uint8_t>(rng());
+    std::string key = WebSocket::base64Encode(keyBytes, sizeof(keyBytes));
+    bool defaultPort = (url.secure && url.port == "443") || (!url.secure && url.port == "80");
+    std::string request = "GET " + url.path + " HTTP/1.1\r\n"
+                          "Host: " + url.host + (defaultPort ? "" : ":" + url.port) + "\r\n"
+                          "Upgrade: websocket\r\n"
+                          "Connection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: " + key + "\r\n"
+                          "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (!s.writeAll(request.data(), request.size())) {
+        throw std::runtime_error("Failed to send WebSocket handshake.");
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    size_t used = 0;
+    size_t headerEnd = std::string::npos;
+    auto deadline = std::chrono::steady_clock::now() + options.idleTimeout;
+    while (headerEnd == std::string::npos) {
+        if (stopping.load()) return;
+        if (std::chrono::steady_clock::now() > deadline || used == buffer.size()) {
+            throw std::runtime_error("WebSocket handshake timed out.");
+        }
+        long n = s.read(buffer.data() + used, buffer.size() - used);
+        if (n < 0) throw std::runtime_error("Connection closed during WebSocket handshake.");
+        used += static_cast<size_t>(n);
+        std::string head(buffer.data(), used);
+        size_t pos = head.find("\r\n\r\n");
+        if (pos != std::string::npos) headerEnd = pos + 4;
+    }
+
+    std::string head(buffer.data(), headerEnd);
+    if (head.compare(0, 12, "HTTP/1.1 101") != 0) {
+        throw std::runtime_error("WebSocket upgrade rejected: " + head.substr(0, head.find("\r\n")));
+    }
+    std::string expectedAccept = WebSocket::acceptKey(key);
+    bool acceptOk = false;
+    for (size_t pos = head.find("\r\n"); pos != std::string::npos && pos + 2 < head.size();
+         pos = head.find("\r\n", pos + 2)) {
+        const char* line = head.c_str() + pos + 2;
+        if (startsWithIgnoreCase(line, "sec-websocket-accept:")) {
+            std::string value = head.substr(pos + 2 + 21, head.find("\r\n", pos + 2) - (pos + 2 + 21));
+            value.erase(0, value.find_first_not_of(' '));
+            acceptOk = value == expectedAccept;
+        }
+    }
+    if (!acceptOk) {
+        throw std::runtime_error("Invalid Sec-WebSocket-Accept from server.");
+    }
+    std::memmove(buffer.data(), buffer.data() + headerEnd, used - headerEnd);
+    used -= headerEnd;
+
+    isConnected.store(true);
+    status("Connected to " + options.url);
+
+    // --- Frames ---
+    std::string out;       // reused outgoing frame buffer
+    std::string message;   // reused fragmented-message buffer
+    LiveQuote quote;
+    auto send = [&](WebSocket::Opcode opcode, const char* payload, size_t length) {
+        out.clear();
+        WebSocket::appendFrame(out, opcode, payload, length, true, static_cast<uint32_t>(rng()));
+        if (!s.writeAll(out.data(), out.size())) {
+            throw std::runtime_error("Failed to write to streaming connection.");
+        }
+    };
+    auto handleMessage = [&](const char* data, size_t length) {
+        if (decodeQuote(data, length, quote)) {
+            messageCount.fetch_add(1, std::memory_order_relaxed);
+            if (quoteHandler) quoteHandler(quote);
+        } else if (length > 0 && data[0] == '{') {
+            decodeErrorCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            status(std::string(data, length)); // e.g. "Connected"
+        }
+    };
+
+    subscriptionDirty.store(true);
+    auto lastReceive = std::chrono::steady_clock::now();
+    auto lastPing = lastReceive;
+    bool fragmented = false;
+    WebSocket::Opcode fragmentOpcode = WebSocket::TEXT;
+
+    while (!stopping.load()) {
+        if (subscriptionDirty.exchange(false)) {
+            std::string sub = subscriptionMessage();
+            send(WebSocket::TEXT, sub.data(), sub.size());
+        }
+
+        // Parse whatever complete frames are buffered.
+        size_t offset = 0;
+        while (true) {
+            WebSocket::Frame frame;
+            long consumed = WebSocket::parseFrame(buffer.data() + offset, used - offset, frame, options.maxMessageSize);
+            if (consumed < 0) throw std::runtime_error("Invalid or oversized WebSocket frame.");
+            if (consumed == 0) break;
+            offset += static_cast<size_t>(consumed);
+
+            switch (frame.opcode) {
+            case WebSocket::PING:
+                send(WebSocket::PONG, frame.payload, frame.length);
+                break;
+            case WebSocket::PONG:
+                break;
+            case WebSocket::CLOSE:
+                send(WebSocket::CLOSE, frame.payload, std::min<size_t>(frame.length, 2));
+                status("Server closed the streaming connection.");
+                return;
+            case WebSocket::TEXT:
+            case WebSocket::BINARY:
+                if (frame.fin) {
+                    handleMessage(frame.payload, frame.length);
+                } else {
+                    fragmented = true;
+                    fragmentOpcode = frame.opcode;
+                    message.assign(frame.payload, frame.length);
+                }
+                break;
+            case WebSocket::CONTINUATION:
+                if (!fragmented) throw std::runtime_error("Unexpected WebSocket continuation frame.");
+                message.append(frame.payload, frame.length);
+                if (message.size() > options.maxMessageSize) throw std::runtime_error("WebSocket message too large.");
+                if (frame.fin) {
+                    fragmented = false;
+                    (void)fragmentOpcode;
+                    handleMessage(message.data(), message.size());
+                }
+                break;
+            default:
+                throw std::runtime_error("Unknown WebSocket opcode.");
+            }
+        }
+        if (offset > 0) {
+            std::memmove(buffer.data(), buffer.data() + offset, used - offset);
+            used -= offset;
+        }
+        if (used == buffer.size()) {
+            buffer.resize(std::min(buffer.size() * 2, options.maxMessageSize + 16));
+        }
+
+        long n = s.read(buffer.data() + used, buffer.size() - used);
+        auto now = std::chrono::steady_clock::now();
+        if (n < 0) {
+            throw std::runtime_error("Streaming connection closed.");
+        }
+        if (n > 0) {
+            used += static_cast<size_t>(n);
+            lastReceive = now;
+            continue;
+        }
+        if (now - lastReceive > options.idleTimeout) {
+            throw std::runtime_error("Streaming connection idle timeout.");
+        }
+        if (now - lastReceive > options.pingInterval && now - lastPing > options.pingInterval) {
+            send(WebSocket::PING, nullptr, 0);
+            lastPing = now;
+        }
+    }
+
+    send(WebSocket::CLOSE, "\x03\xe8", 2); // 1000 normal closure
+}
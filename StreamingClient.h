@@ -0,0 +1,106 @@
+#ifndef TRADERMADE_STREAMING_CLIENT_H
+#define TRADERMADE_STREAMING_CLIENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CancellationToken.h"
+#include "TraderMadeTypes.h"
+
+class TraderMade;
+
+// WebSocket client for the TraderMade streaming feed. Runs on its own thread,
+// decodes each price message into a LiveQuote and hands it to the quote handler.
+// Reconnects with exponential backoff and re-sends the subscription after every
+// connect.
+//
+//   StreamingClient stream("streaming_api_key");
+//   stream.subscribe({"EURUSD", "GBPUSD"});
+//   stream.onQuote([](const LiveQuote& q) { ... });
+//   stream.start();
+//
+// wss:// URLs need the SDK built with OpenSSL (TRADERMADE_WITH_OPENSSL); ws:// always
+// works, e.g. against tradermade_mock_server at ws://127.0.0.1:8080/feedadv.
+class StreamingClient {
+public:
+    struct Options {
+        std::string url = "wss://marketdata.tradermade.com/feedadv";
+        std::chrono::milliseconds reconnectMin{500};
+        std::chrono::milliseconds reconnectMax{30000};
+        std::chrono::milliseconds idleTimeout{30000};  // reconnect if nothing arrives for this long
+        std::chrono::milliseconds pingInterval{10000}; // keep-alive ping while idle
+        size_t maxMessageSize = 1 << 20;
+    };
+
+    using QuoteHandler = std::function<void(const LiveQuote&)>;
+    using StatusHandler = std::function<void(const std::string&)>;
+
+    explicit StreamingClient(const std::string& streamingApiKey);
+    StreamingClient(const std::string& streamingApiKey, const Options& options);
+    ~StreamingClient();
+
+    StreamingClient(const StreamingClient&) = delete;
+    StreamingClient& operator=(const StreamingClient&) = delete;
+
+    // Handlers run on the streaming thread; set them before start().
+    void onQuote(QuoteHandler handler);
+    void onStatus(StatusHandler handler);
+
+    // Subscription changes are re-sent by the streaming thread (within ~200 ms when connected).
+    void subscribe(const std::vector<std::string>& symbols);
+    void unsubscribe(const std::vector<std::string>& symbols);
+    std::vector<std::string> symbols() const;
+
+    // Subscribes to every instrument returned by getStreamingCurrencyList().
+    void subscribeStreamingList(TraderMade& tm);
+
+    void start();
+    // Runs until stop() or until token is cancelled, which interrupts a blocking read
+    // or reconnect wait at once (join with stop() or the destructor).
+    void start(const CancellationToken& token);
+    void stop();
+
+    bool connected() const { return isConnected.load(std::memory_order_relaxed); }
+    uint64_t messages() const { return messageCount.load(std::memory_order_relaxed); }
+    uint64_t reconnects() const { return reconnectCount.load(std::memory_order_relaxed); }
+    uint64_t decodeErrors() const { return decodeErrorCount.load(std::memory_order_relaxed); }
+
+    // Decodes one feed message ({"symbol","ts","bid","ask","mid"}) without allocating.
+    static bool decodeQuote(const char* data, size_t length, LiveQuote& out);
+
+private:
+    class Session;
+
+    std::string apiKey;
+    Options options;
+    QuoteHandler quoteHandler;
+    StatusHandler statusHandler;
+
+    mutable std::mutex mutex;
+    std::vector<std::string> subscribed;
+
+    std::atomic<bool> subscriptionDirty{false}; // resend the subscription on the stream thread
+    std::atomic<int> socketFd{-1};              // lets stop() interrupt a blocking read
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> isConnected{false};
+    std::atomic<uint64_t> messageCount{0};
+    std::atomic<uint64_t> reconnectCount{0};
+    std::atomic<uint64_t> decodeErrorCount{0};
+    std::thread worker;
+    CancellationToken startToken;
+    size_t startSubscription = 0;
+
+    void interrupt();
+    void run();
+    void runSession(Session& s);
+    std::string subscriptionMessage() const;
+    void status(const std::string& message);
+};
+
+#endif
@@ -0,0 +1,604 @@
+#include "TickArchive.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "Resample.h"
+#include "TraderMadeDecode.h"
+#include "TraderMadeSDK.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static_assert(sizeof(TickFileHeader) == 32, "TickFileHeader layout");
+static_assert(sizeof(TickBlockHeader) == 40, "TickBlockHeader layout");
+static_assert(sizeof(TickIndexEntry) == 32, "TickIndexEntry layout");
+
+namespace {
+
+const int64_t MS_PER_DAY = 86400000;
+
+// MSB-first bit stream. write() takes at most 32 bits at a time.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void write(uint64_t value, int bits) {
+        acc = (acc << bits) | (value & ((1ULL << bits) - 1));
+        used += bits;
+        while (used >= 8) {
+            used -= 8;
+            out.push_back(static_cast<uint8_t>(acc >> used));
+        }
+    }
+    void write64(uint64_t value) {
+        write(value >> 32, 32);
+        write(value & 0xffffffffULL, 32);
+    }
+    void finish() {
+        if (used > 0) {
+            out.push_back(static_cast<uint8_t>(acc << (8 - used)));
+            used = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t acc = 0;
+    int used = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    uint64_t read(int bits) {
+        if (bits == 0) return 0;
+        uint64_t word = peek(pos >> 3) << (pos & 7);
+        pos += static_cast<size_t>(bits);
+        return word >> (64 - bits);
+    }
+    uint64_t read64() {
+        uint64_t hi = read(32);
+        return (hi << 32) | read(32);
+    }
+    bool overrun() const { return pos > size * 8; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+
+    uint64_t peek(size_t byte) const {
+        uint64_t word = 0;
+        if (byte + 8 <= size) {
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            std::memcpy(&word, data + byte, sizeof(word));
+            word = __builtin_bswap64(word);
+#else
+            for (int i = 0; i < 8; ++i) word = (word << 8) | data[byte + static_cast<size_t>(i)];
+#endif
+        } else {
+            for (size_t i = 0; i < 8; ++i) word = (word << 8) | (byte + i < size ? data[byte + i] : 0);
+        }
+        return word;
+    }
+};
+
+bool fitsSigned(int64_t v, int bits) {
+    return v >= -(1LL << (bits - 1)) && v < (1LL << (bits - 1));
+}
+
+int64_t signExtend(uint64_t v, int bits) {
+    const uint64_t sign = 1ULL << (bits - 1);
+    return static_cast<int64_t>((v ^ sign) - sign);
+}
+
+// Delta-of-delta buckets: '0' | '10'+7 | '110'+12 | '1110'+20 | '1111'+64 bits.
+void encodeTimestamps(BitWriter& w, const int64_t* t, size_t count) {
+    w.write64(static_cast<uint64_t>(t[0]));
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        int64_t delta = t[i] - t[i - 1];
+        int64_t dod = delta - prevDelta;
+        prevDelta = delta;
+        if (dod == 0) {
+            w.write(0, 1);
+        } else if (fitsSigned(dod, 7)) {
+            w.write(0x2, 2);
+            w.write(static_cast<uint64_t>(dod), 7);
+        } else if (fitsSigned(dod, 12)) {
+            w.write(0x6, 3);
+            w.write(static_cast<uint64_t>(dod), 12);
+        } else if (fitsSigned(dod, 20)) {
+            w.write(0xe, 4);
+            w.write(static_cast<uint64_t>(dod), 20);
+        } else {
+            w.write(0xf, 4);
+            w.write64(static_cast<uint64_t>(dod));
+        }
+    }
+}
+
+void decodeTimestamps(BitReader& r, int64_t* t, size_t count) {
+    t[0] = static_cast<int64_t>(r.read64());
+    int64_t delta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (r.read(1) != 0) {
+            if (r.read(1) == 0) {
+                delta += signExtend(r.read(7), 7);
+            } else if (r.read(1) == 0) {
+                delta += signExtend(r.read(12), 12);
+            } else if (r.read(1) == 0) {
+                delta += signExtend(r.read(20), 20);
+            } else {
+                delta += static_cast<int64_t>(r.read64());
+            }
+        }
+        t[i] = t[i - 1] + delta;
+    }
+}
+
+uint64_t bitsOf(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+double doubleOf(uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+int leadingZeros(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+    while (!(v & (1ULL << 63))) {
+        v <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+int trailingZeros(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Gorilla value encoding: '0' repeats the previous value; '10' + meaningful bits
+// reuses the previous leading/trailing zero window; '11' + 5 bits leading zeros +
+// 6 bits (length - 1) + meaningful bits opens a new window.
+void encodeValues(BitWriter& w, const double* v, size_t count) {
+    uint64_t prev = bitsOf(v[0]);
+    w.write64(prev);
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (size_t i = 1; i < count; ++i) {
+        uint64_t cur = bitsOf(v[i]);
+        uint64_t x = cur ^ prev;
+        prev = cur;
+        if (x == 0) {
+            w.write(0, 1);
+            continue;
+        }
+        int leading = leadingZeros(x);
+        int trailing = trailingZeros(x);
+        if (leading > 31) leading = 31;
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            int length = 64 - prevLeading - prevTrailing;
+            w.write(0x2, 2);
+            if (length > 32) {
+                w.write((x >> prevTrailing) >> 32, length - 32);
+                w.write((x >> prevTrailing) & 0xffffffffULL, 32);
+            } else {
+                w.write(x >> prevTrailing, length);
+            }
+            continue;
+        }
+        int length = 64 - leading - trailing;
+        w.write(0x3, 2);
+        w.write(static_cast<uint64_t>(leading), 5);
+        w.write(static_cast<uint64_t>(length - 1), 6);
+        if (length > 32) {
+            w.write((x >> trailing) >> 32, length - 32);
+            w.write((x >> trailing) & 0xffffffffULL, 32);
+        } else {
+            w.write(x >> trailing, length);
+        }
+        prevLeading = leading;
+        prevTrailing = trailing;
+    }
+}
+
+uint64_t readBits(BitReader& r, int length) {
+    if (length > 32) {
+        uint64_t hi = r.read(length - 32);
+        return (hi << 32) | r.read(32);
+    }
+    return r.read(length);
+}
+
+bool decodeValues(BitReader& r, double* v, size_t count) {
+    uint64_t prev = r.read64();
+    v[0] = doubleOf(prev);
+    int leading = 0;
+    int trailing = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (r.read(1) != 0) {
+            if (r.read(1) != 0) {
+                leading = static_cast<int>(r.read(5));
+                int length = static_cast<int>(r.read(6)) + 1;
+                trailing = 64 - leading - length;
+                if (trailing < 0) return false;
+            }
+            prev ^= readBits(r, 64 - leading - trailing) << trailing;
+        }
+        v[i] = doubleOf(prev);
+    }
+    return true;
+}
+
+void padTo8(std::vector<uint8_t>& payload) {
+    while (payload.size() % 8 != 0) payload.push_back(0);
+}
+
+void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+    int rc = _mkdir(path.c_str());
+#else
+    int rc = ::mkdir(path.c_str(), 0755);
+#endif
+    if (rc != 0 && errno != EEXIST) {
+        throw std::runtime_error("Cannot create directory " + path + ": " + std::strerror(errno));
+    }
+}
+
+void makeDirectories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+        makeDirectory(path.substr(0, slash));
+    }
+    makeDirectory(path);
+}
+
+void writeAll(std::FILE* f, const void* data, size_t size, const std::string& what) {
+    if (size > 0 && std::fwrite(data, 1, size, f) != size) {
+        throw std::runtime_error("Write failed: " + what);
+    }
+}
+
+std::string manifestPath(const std::string& root) {
+    return root + "/MANIFEST";
+}
+
+bool validSymbol(const std::string& symbol) {
+    if (symbol.empty() || symbol.size() > 15) return false;
+    for (char c : symbol) {
+        bool ok = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int64_t readTickArchivePartitionMs(const std::string& root) {
+    const std::string path = manifestPath(root);
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return 0;
+    }
+    char text[256];
+    size_t n = std::fread(text, 1, sizeof(text) - 1, f);
+    std::fclose(f);
+    text[n] = '\0';
+    const char* value = std::strstr(text, "\npartitionMs=");
+    char* end = nullptr;
+    long long partitionMs = value ? std::strtoll(value + 13, &end, 10) : 0;
+    if (std::strncmp(text, TICK_FILE_MAGIC, 8) != 0 || partitionMs <= 0 || (*end != '\n' && *end != '\0')) {
+        throw std::runtime_error("Malformed tick archive manifest: " + path);
+    }
+    return partitionMs;
+}
+
+uint32_t tickPayloadChecksum(const uint8_t* payload, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ payload[i]) * 16777619u;
+    }
+    return h;
+}
+
+TickBlockHeader encodeTickBlock(const TickSeries& ticks, size_t begin, size_t count, TickCodec codec,
+                                std::vector<uint8_t>& payload) {
+    if (count == 0 || begin + count > ticks.size()) {
+        throw std::invalid_argument("encodeTickBlock: empty or out of range block.");
+    }
+    const int64_t* t = ticks.timestampMs.data() + begin;
+    const double* bid = ticks.bid.data() + begin;
+    const double* ask = ticks.ask.data() + begin;
+    const double* mid = ticks.mid.data() + begin;
+
+    bool derivedMid = true;
+    for (size_t i = 0; i < count && derivedMid; ++i) {
+        derivedMid = bitsOf(mid[i]) == bitsOf((bid[i] + ask[i]) / 2.0);
+    }
+
+    payload.clear();
+    if (codec == TickCodec::Raw) {
+        const size_t column = count * 8;
+        payload.resize(column * (derivedMid ? 3 : 4));
+        std::memcpy(payload.data(), t, column);
+        std::memcpy(payload.data() + column, bid, column);
+        std::memcpy(payload.data() + 2 * column, ask, column);
+        if (!derivedMid) std::memcpy(payload.data() + 3 * column, mid, column);
+    } else {
+        payload.reserve(count * 6 + 32);
+        BitWriter w(payload);
+        encodeTimestamps(w, t, count);
+        encodeValues(w, bid, count);
+        encodeValues(w, ask, count);
+        if (!derivedMid) encodeValues(w, mid, count);
+        w.finish();
+        padTo8(payload);
+    }
+
+    TickBlockHeader h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = TICK_BLOCK_MAGIC;
+    h.count = static_cast<uint32_t>(count);
+    h.firstTs = t[0];
+    h.lastTs = t[count - 1];
+    h.payloadBytes = static_cast<uint32_t>(payload.size());
+    h.codec = static_cast<uint8_t>(codec);
+    h.flags = derivedMid ? TICK_BLOCK_DERIVED_MID : 0;
+    h.checksum = tickPayloadChecksum(payload.data(), payload.size());
+    return h;
+}
+
+bool decodeTickBlock(const TickBlockHeader& header, const uint8_t* payload, TickSeries& out) {
+    const size_t count = header.count;
+    const bool derivedMid = (header.flags & TICK_BLOCK_DERIVED_MID) != 0;
+    if (header.magic != TICK_BLOCK_MAGIC || count == 0) {
+        return false;
+    }
+    const size_t base = out.size();
+    out.timestampMs.resize(base + count);
+    out.bid.resize(base + count);
+    out.ask.resize(base + count);
+    out.mid.resize(base + count);
+    int64_t* t = out.timestampMs.data() + base;
+    double* bid = out.bid.data() + base;
+    double* ask = out.ask.data() + base;
+    double* mid = out.mid.data() + base;
+
+    bool ok = true;
+    if (header.codec == static_cast<uint8_t>(TickCodec::Raw)) {
+        const size_t column = count * 8;
+        ok = header.payloadBytes >= column * (derivedMid ? 3 : 4);
+        if (ok) {
+            std::memcpy(t, payload, column);
+            std::memcpy(bid, payload + column, column);
+            std::memcpy(ask, payload + 2 * column, column);
+            if (!derivedMid) std::memcpy(mid, payload + 3 * column, column);
+        }
+    } else if (header.codec == static_cast<uint8_t>(TickCodec::Gorilla)) {
+        BitReader r(payload, header.payloadBytes);
+        decodeTimestamps(r, t, count);
+        ok = decodeValues(r, bid, count) && decodeValues(r, ask, count) &&
+             (derivedMid || decodeValues(r, mid, count)) && !r.overrun();
+    } else {
+        ok = false;
+    }
+    if (!ok) {
+        out.timestampMs.resize(base);
+        out.bid.resize(base);
+        out.ask.resize(base);
+        out.mid.resize(base);
+        return false;
+    }
+    if (derivedMid) {
+        for (size_t i = 0; i < count; ++i) mid[i] = (bid[i] + ask[i]) / 2.0;
+    }
+    return true;
+}
+
+TickArchiveWriter::TickArchiveWriter(const std::string& root) : TickArchiveWriter(root, Options()) {}
+
+TickArchiveWriter::TickArchiveWriter(const std::string& root, const Options& options)
+    : root(root), options(options) {
+    if (root.empty()) {
+        throw std::invalid_argument("TickArchiveWriter root must not be empty.");
+    }
+    if (options.partitionMs <= 0 ||
+        (MS_PER_DAY % options.partitionMs != 0 && options.partitionMs % MS_PER_DAY != 0)) {
+        throw std::invalid_argument("partitionMs must divide a day or be a whole number of days.");
+    }
+    if (options.blockTicks == 0 || options.blockTicks > 1000000) {
+        throw std::invalid_argument("blockTicks must be between 1 and 1000000.");
+    }
+    makeDirectories(root);
+
+    const int64_t recorded = readTickArchivePartitionMs(root);
+    if (recorded != 0 && recorded != options.partitionMs) {
+        throw std::invalid_argument("Tick archive " + root + " uses partitionMs=" + std::to_string(recorded) +
+                                    ", not " + std::to_string(options.partitionMs) + ".");
+    }
+    if (recorded == 0) {
+        const std::string path = manifestPath(root);
+        const std::string text =
+            std::string(TICK_FILE_MAGIC) + "\npartitionMs=" + std::to_string(options.partitionMs) + "\n";
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) {
+            throw std::runtime_error("Cannot create " + path + ": " + std::strerror(errno));
+        }
+        bool written = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        if (std::fclose(f) != 0 || !written) {
+            throw std::runtime_error("Write failed: " + path);
+        }
+    }
+}
+
+TickArchiveWriter::~TickArchiveWriter() {
+    try {
+        flush();
+    } catch (...) {
+    }
+    for (auto& kv : streams) {
+        close(kv.second);
+    }
+}
+
+std::string TickArchiveWriter::partitionPath(const std::string& root, const std::string& symbol,
+                                             int64_t partitionStart, int64_t partitionMs) {
+    std::string name = formatApiTime(partitionStart, partitionMs % MS_PER_DAY != 0);
+    for (char& c : name) {
+        if (c == ' ') c = 'T';
+        if (c == ':') c = '-';
+    }
+    return root + "/" + symbol + "/" + name;
+}
+
+size_t TickArchiveWriter::append(const std::string& symbol, const TickSeries& series) {
+    if (!validSymbol(symbol)) {
+        throw std::invalid_argument("Invalid archive symbol: " + symbol);
+    }
+    Stream& s = streams[symbol];
+    size_t accepted = 0;
+    for (size_t i = 0; i < series.size(); ++i) {
+        int64_t t = series.timestampMs[i];
+        if (t < s.lastTs) {
+            ++dropped;
+            continue;
+        }
+        int64_t partition = partitionOf(t);
+        if (partition != s.partition) {
+            if (!s.pending.empty()) writeBlock(s);
+            open(symbol, s, partition);
+            if (t < s.lastTs) { // older than what the existing partition file holds
+                ++dropped;
+                continue;
+            }
+        }
+        s.pending.push_back(t, series.bid[i], series.ask[i], series.mid[i]);
+        s.lastTs = t;
+        ++accepted;
+        if (s.pending.size() >= options.blockTicks) {
+            writeBlock(s);
+        }
+    }
+    ticks += accepted;
+    return accepted;
+}
+
+size_t TickArchiveWriter::appendResponse(const std::string& symbol, const nlohmann::json& body) {
+    TickSeries series;
+    decodeTicks(body, series);
+    return append(symbol, series);
+}
+
+Result<size_t> TickArchiveWriter::ingest(TraderMade& tm, const std::string& symbol, const std::string& startDate,
+                                         const std::string& endDate) {
+    if (!validSymbol(symbol)) {
+        return RequestError{ErrorCode::InvalidArgument, 0, "Invalid archive symbol: " + symbol};
+    }
+    Result<nlohmann::json> body = tm.tryGetTickHistoricalData(symbol, startDate, endDate, "json");
+    if (!body) {
+        return body.error();
+    }
+    return appendResponse(symbol, body.value());
+}
+
+void TickArchiveWriter::flush() {
+    for (auto& kv : streams) {
+        Stream& s = kv.second;
+        if (!s.pending.empty()) writeBlock(s);
+        if (s.data) std::fflush(s.data);
+        if (s.index) std::fflush(s.index);
+    }
+}
+
+int64_t TickArchiveWriter::partitionOf(int64_t t) const {
+    return bucketStart(t, options.partitionMs);
+}
+
+void TickArchiveWriter::open(const std::string& symbol, Stream& s, int64_t partition) {
+    close(s);
+    s.partition = partition;
+    makeDirectory(root + "/" + symbol);
+    const std::string base = partitionPath(root, symbol, partition, options.partitionMs);
+
+    s.data = std::fopen((base + ".ticks").c_str(), "ab");
+    s.index = s.data ? std::fopen((base + ".tidx").c_str(), "a+b") : nullptr;
+    if (!s.data || !s.index) {
+        close(s);
+        throw std::runtime_error("Cannot open tick archive " + base + ": " + std::strerror(errno));
+    }
+    std::fseek(s.data, 0, SEEK_END);
+    s.offset = static_cast<uint64_t>(std::ftell(s.data));
+    if (s.offset == 0) {
+        TickFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, TICK_FILE_MAGIC, sizeof(header.magic));
+        std::memcpy(header.symbol, symbol.data(), symbol.size());
+        header.partitionStart = partition;
+        writeAll(s.data, &header, sizeof(header), base);
+        s.offset = sizeof(header);
+        return;
+    }
+    // Appending to an existing partition: keep time order with what it already holds.
+    std::fseek(s.index, 0, SEEK_END);
+    long indexSize = std::ftell(s.index);
+    if (indexSize >= static_cast<long>(sizeof(TickIndexEntry))) {
+        TickIndexEntry last;
+        long lastEntry = indexSize - indexSize % static_cast<long>(sizeof(TickIndexEntry)) -
+                         static_cast<long>(sizeof(TickIndexEntry));
+        std::fseek(s.index, lastEntry, SEEK_SET);
+        if (std::fread(&last, sizeof(last), 1, s.index) == 1 && last.lastTs > s.lastTs) {
+            s.lastTs = last.lastTs;
+        }
+        std::fseek(s.index, 0, SEEK_END);
+    }
+}
+
+void TickArchiveWriter::close(Stream& s) {
+    if (s.data) std::fclose(s.data);
+    if (s.index) std::fclose(s.index);
+    s.data = nullptr;
+    s.index = nullptr;
+}
+
+void TickArchiveWriter::writeBlock(Stream& s) {
+    TickBlockHeader header = encodeTickBlock(s.pending, 0, s.pending.size(), options.codec, scratch);
+    TickIndexEntry entry;
+    entry.firstTs = header.firstTs;
+    entry.lastTs = header.lastTs;
+    entry.offset = s.offset;
+    entry.count = header.count;
+    entry.payloadBytes = header.payloadBytes;
+
+    writeAll(s.data, &header, sizeof(header), "tick block header");
+    writeAll(s.data, scratch.data(), scratch.size(), "tick block payload");
+    std::fflush(s.data);
+    writeAll(s.index, &entry, sizeof(entry), "tick index");
+
+    s.offset += sizeof(header) + scratch.size();
+    bytes += sizeof(header) + scratch.size() + sizeof(entry);
+    ++blocks;
+    s.pending.clear();
+}
@@ -0,0 +1,148 @@
+#ifndef TRADERMADE_TICK_ARCHIVE_H
+#define TRADERMADE_TICK_ARCHIVE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "TraderMadeTypes.h"
+#include "TraderMadeResult.h"
+
+class TraderMade;
+
+// Append-only on-disk tick archive. Ticks are stored per symbol and time partition
+// (one UTC day by default) in columnar blocks of up to a few thousand ticks:
+//
+//   <root>/MANIFEST                     format and partition size, for readers
+//   <root>/<SYMBOL>/<partition>.ticks   file header, then blocks (header + payload)
+//   <root>/<SYMBOL>/<partition>.tidx    one TickIndexEntry per complete block
+//
+//   TickArchiveWriter archive("/data/ticks");
+//   archive.ingest(tm, "EURUSD", "2026-01-08 10:00", "2026-01-08 11:00");
+//   archive.append("GBPUSD", ticks);   // a TickSeries from decodeTicks()
+//   archive.flush();
+//
+// TickCodec::Gorilla blocks store timestamps as delta-of-deltas and prices XORed
+// with the previous value (Facebook's Gorilla scheme): roughly 12-16 bytes per FX
+// tick instead of ~80 bytes of JSON. TickCodec::Raw stores plain 8-byte aligned
+// columns that a reader can use in place. The mid column is omitted when every mid
+// equals (bid + ask) / 2. Files use the host byte order (little-endian targets).
+//
+// An index entry is written only after its block, so a crash leaves at most an
+// unindexed tail that readers ignore. Ticks must arrive in time order per symbol;
+// ticks older than the last one archived for the symbol are dropped and counted.
+
+enum class TickCodec : uint8_t {
+    Raw = 0,
+    Gorilla = 1
+};
+
+// On-disk layouts (all multiples of 8 bytes).
+struct TickFileHeader {
+    char magic[8];          // "TMTICK01"
+    char symbol[16];        // NUL padded
+    int64_t partitionStart; // UTC ms
+};
+
+struct TickBlockHeader {
+    uint32_t magic;        // TICK_BLOCK_MAGIC
+    uint32_t count;
+    int64_t firstTs;
+    int64_t lastTs;
+    uint32_t payloadBytes; // padded to a multiple of 8
+    uint8_t codec;         // TickCodec
+    uint8_t flags;         // TICK_BLOCK_DERIVED_MID
+    uint16_t reserved;
+    uint32_t checksum;     // FNV-1a of the payload
+    uint32_t reserved2;
+};
+
+struct TickIndexEntry {
+    int64_t firstTs;
+    int64_t lastTs;
+    uint64_t offset; // of the TickBlockHeader in the .ticks file
+    uint32_t count;
+    uint32_t payloadBytes;
+};
+
+const char TICK_FILE_MAGIC[9] = "TMTICK01";
+const uint32_t TICK_BLOCK_MAGIC = 0x4b4c4254; // "TBLK"
+const uint8_t TICK_BLOCK_DERIVED_MID = 1;
+
+// The partition size recorded in <root>/MANIFEST, or 0 if the root has no manifest.
+// Throws std::runtime_error if the manifest is malformed.
+int64_t readTickArchivePartitionMs(const std::string& root);
+
+// Encodes ticks[begin, begin + count) as one block; payload is padded to 8 bytes.
+TickBlockHeader encodeTickBlock(const TickSeries& ticks, size_t begin, size_t count, TickCodec codec,
+                                std::vector<uint8_t>& payload);
+// Appends the block's ticks to out; false if the payload is malformed.
+bool decodeTickBlock(const TickBlockHeader& header, const uint8_t* payload, TickSeries& out);
+uint32_t tickPayloadChecksum(const uint8_t* payload, size_t size);
+
+class TickArchiveWriter {
+public:
+    struct Options {
+        int64_t partitionMs = 86400000; // must divide a day or be a whole number of days,
+                                        // and match the manifest of an existing archive
+        size_t blockTicks = 4096;
+        TickCodec codec = TickCodec::Gorilla;
+    };
+
+    // Creates root and its manifest if needed. Throws std::invalid_argument if the
+    // archive already exists with a different partitionMs.
+    explicit TickArchiveWriter(const std::string& root);
+    TickArchiveWriter(const std::string& root, const Options& options);
+    ~TickArchiveWriter(); // flushes
+
+    TickArchiveWriter(const TickArchiveWriter&) = delete;
+    TickArchiveWriter& operator=(const TickArchiveWriter&) = delete;
+
+    // Returns the number of ticks accepted. Throws std::runtime_error on I/O errors.
+    size_t append(const std::string& symbol, const TickSeries& ticks);
+    // A /tick_historical response (format=json), via decodeTicks().
+    size_t appendResponse(const std::string& symbol, const nlohmann::json& body);
+    // Fetches one tick range and appends it.
+    Result<size_t> ingest(TraderMade& tm, const std::string& symbol, const std::string& startDate,
+                          const std::string& endDate);
+
+    // Writes buffered ticks as (possibly short) blocks and flushes the files.
+    void flush();
+
+    uint64_t ticksWritten() const { return ticks; }
+    uint64_t ticksDropped() const { return dropped; }
+    uint64_t blocksWritten() const { return blocks; }
+    uint64_t bytesWritten() const { return bytes; }
+
+    // <root>/<SYMBOL>/<partition> without extension, e.g. ".../EURUSD/2026-01-08".
+    static std::string partitionPath(const std::string& root, const std::string& symbol, int64_t partitionStart,
+                                     int64_t partitionMs);
+
+private:
+    struct Stream {
+        TickSeries pending;
+        int64_t partition = INT64_MIN;
+        int64_t lastTs = INT64_MIN;
+        std::FILE* data = nullptr;
+        std::FILE* index = nullptr;
+        uint64_t offset = 0; // end of the data file
+    };
+
+    std::string root;
+    Options options;
+    std::map<std::string, Stream> streams;
+    std::vector<uint8_t> scratch;
+    uint64_t ticks = 0;
+    uint64_t dropped = 0;
+    uint64_t blocks = 0;
+    uint64_t bytes = 0;
+
+    int64_t partitionOf(int64_t t) const;
+    void open(const std::string& symbol, Stream& s, int64_t partition);
+    static void close(Stream& s);
+    void writeBlock(Stream& s);
+};
+
+#endif
@@ -0,0 +1,303 @@
+#include "TickArchiveReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "Resample.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+template <typename T>
+ColumnSpan<T> spanAt(const uint8_t* base, size_t column, size_t count) {
+    ColumnSpan<T> s;
+    s.data = reinterpret_cast<const T*>(base + column * count * sizeof(T));
+    s.size = count;
+    return s;
+}
+
+} // namespace
+
+TickArchiveReader::TickArchiveReader(const std::string& root) : TickArchiveReader(root, Options()) {}
+
+TickArchiveReader::TickArchiveReader(const std::string& root, const Options& options)
+    : root(root), options(options) {
+    if (options.partitionMs < 0) {
+        throw std::invalid_argument("partitionMs must be positive, or 0 to use the archive's.");
+    }
+}
+
+TickArchiveReader::~TickArchiveReader() {
+    close();
+}
+
+size_t TickArchiveReader::open(const std::string& symbol, int64_t fromMs, int64_t toMs) {
+    close();
+    openSymbol = symbol;
+    if (toMs <= fromMs) {
+        return 0;
+    }
+    const int64_t recorded = readTickArchivePartitionMs(root);
+    if (recorded != 0 && options.partitionMs != 0 && recorded != options.partitionMs) {
+        throw std::runtime_error("Tick archive " + root + " uses partitionMs=" + std::to_string(recorded) +
+                                 ", not " + std::to_string(options.partitionMs) + ".");
+    }
+    partitionMs = recorded ? recorded : options.partitionMs ? options.partitionMs : 86400000;
+    for (int64_t p = bucketStart(fromMs, partitionMs); p < toMs; p += partitionMs) {
+        const std::string base = TickArchiveWriter::partitionPath(root, symbol, p, partitionMs);
+        Partition part;
+        if (!mapFile(base + ".ticks", part.data)) {
+            continue;
+        }
+        if (part.data.size < sizeof(TickFileHeader) ||
+            std::memcmp(part.data.data, TICK_FILE_MAGIC, 8) != 0) {
+            unmapFile(part.data);
+            close();
+            throw std::runtime_error("Not a tick archive file: " + base + ".ticks");
+        }
+        TickFileHeader header;
+        std::memcpy(&header, part.data.data, sizeof(header));
+        if (header.partitionStart != p) {
+            unmapFile(part.data);
+            close();
+            throw std::runtime_error("Tick archive file is from another partitioning: " + base + ".ticks");
+        }
+        mapFile(base + ".tidx", part.index); // no index yet: no complete blocks
+        partitions.push_back(part);
+        addBlocks(partitions.back(), base);
+    }
+    return blocks.size();
+}
+
+void TickArchiveReader::close() {
+    for (Partition& p : partitions) {
+        unmapFile(p.data);
+        unmapFile(p.index);
+    }
+    partitions.clear();
+    blocks.clear();
+    ticks = 0;
+}
+
+void TickArchiveReader::addBlocks(const Partition& p, const std::string& path) {
+    const size_t entries = p.index.size / sizeof(TickIndexEntry);
+    for (size_t i = 0; i < entries; ++i) {
+        TickIndexEntry e;
+        std::memcpy(&e, p.index.data + i * sizeof(e), sizeof(e));
+        if (e.offset % 8 != 0 || e.offset + sizeof(TickBlockHeader) > p.data.size ||
+            e.payloadBytes > p.data.size - e.offset - sizeof(TickBlockHeader)) {
+            break; // index ahead of data: truncated file
+        }
+        const TickBlockHeader* h = reinterpret_cast<const TickBlockHeader*>(p.data.data + e.offset);
+        if (h->magic != TICK_BLOCK_MAGIC || h->count != e.count || h->payloadBytes != e.payloadBytes) {
+            throw std::runtime_error("Tick archive index does not match its data: " + path);
+        }
+        if (!blocks.empty() && h->firstTs < blocks.back().header->lastTs) {
+            break; // out of order: not written by TickArchiveWriter
+        }
+        blocks.push_back(BlockRef{h, p.data.data + e.offset + sizeof(TickBlockHeader)});
+        ticks += h->count;
+    }
+}
+
+int64_t TickArchiveReader::firstTimestamp() const {
+    return blocks.empty() ? INT64_MIN : blocks.front().header->firstTs;
+}
+
+int64_t TickArchiveReader::lastTimestamp() const {
+    return blocks.empty() ? INT64_MAX : blocks.back().header->lastTs;
+}
+
+TickArchiveReader::BlockView TickArchiveReader::block(size_t i) const {
+    const TickBlockHeader& h = *blocks.at(i).header;
+    BlockView v;
+    v.firstTs = h.firstTs;
+    v.lastTs = h.lastTs;
+    v.count = h.count;
+    v.codec = static_cast<TickCodec>(h.codec);
+    const bool derivedMid = (h.flags & TICK_BLOCK_DERIVED_MID) != 0;
+    if (v.codec == TickCodec::Raw && h.payloadBytes >= h.count * 8 * (derivedMid ? 3 : 4)) {
+        const uint8_t* payload = blocks[i].payload;
+        v.timestampMs = spanAt<int64_t>(payload, 0, h.count);
+        v.bid = spanAt<double>(payload, 1, h.count);
+        v.ask = spanAt<double>(payload, 2, h.count);
+        if (!derivedMid) v.mid = spanAt<double>(payload, 3, h.count);
+    }
+    return v;
+}
+
+bool TickArchiveReader::decode(size_t i, TickSeries& out) const {
+    const BlockRef& b = blocks.at(i);
+    if (options.verifyChecksums && tickPayloadChecksum(b.payload, b.header->payloadBytes) != b.header->checksum) {
+        return false;
+    }
+    return decodeTickBlock(*b.header, b.payload, out);
+}
+
+size_t TickArchiveReader::seek(int64_t timeMs) const {
+    auto it = std::lower_bound(blocks.begin(), blocks.end(), timeMs,
+                               [](const BlockRef& b, int64_t t) { return b.header->lastTs < t; });
+    return static_cast<size_t>(it - blocks.begin());
+}
+
+size_t TickArchiveReader::read(int64_t fromMs, int64_t toMs, TickSeries& out) const {
+    const size_t before = out.size();
+    const size_t firstBlock = seek(fromMs);
+    size_t upperBound = 0;
+    for (size_t i = firstBlock; i < blocks.size() && blocks[i].header->firstTs < toMs; ++i) {
+        upperBound += blocks[i].header->count;
+    }
+    out.reserve(before + upperBound);
+    TickSeries scratch;
+    for (size_t i = firstBlock; i < blocks.size() && blocks[i].header->firstTs < toMs; ++i) {
+        const TickBlockHeader& h = *blocks[i].header;
+        if (h.firstTs >= fromMs && h.lastTs < toMs && !options.verifyChecksums) {
+            decodeTickBlock(h, blocks[i].payload, out); // whole block in range
+            continue;
+        }
+        scratch.clear();
+        if (!decode(i, scratch)) {
+            continue;
+        }
+        auto first = std::lower_bound(scratch.timestampMs.begin(), scratch.timestampMs.end(), fromMs);
+        auto last = std::lower_bound(first, scratch.timestampMs.end(), toMs);
+        for (size_t k = static_cast<size_t>(first - scratch.timestampMs.begin());
+             k < static_cast<size_t>(last - scratch.timestampMs.begin()); ++k) {
+            out.push_back(scratch.timestampMs[k], scratch.bid[k], scratch.ask[k], scratch.mid[k]);
+        }
+    }
+    return out.size() - before;
+}
+
+TickArchiveReader::Range TickArchiveReader::range(int64_t fromMs, int64_t toMs) const {
+    return Range(*this, fromMs, toMs);
+}
+
+bool TickArchiveReader::mapFile(const std::string& path, MappedFile& file) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return false;
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(errno));
+    }
+    file.size = static_cast<size_t>(st.st_size);
+    if (file.size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* p = ::mmap(nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        file.size = 0;
+        throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+    }
+    file.data = static_cast<const uint8_t*>(p);
+    file.mapped = true;
+    return true;
+#else
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    uint8_t* copy = new uint8_t[size > 0 ? size : 1];
+    file.size = std::fread(copy, 1, static_cast<size_t>(size > 0 ? size : 0), f);
+    std::fclose(f);
+    file.data = copy;
+    file.mapped = false;
+    return true;
+#endif
+}
+
+void TickArchiveReader::unmapFile(MappedFile& file) {
+    if (file.data) {
+#ifndef _WIN32
+        if (file.mapped) ::munmap(const_cast<uint8_t*>(file.data), file.size);
+#endif
+        if (!file.mapped) delete[] file.data;
+    }
+    file.data = nullptr;
+    file.size = 0;
+    file.mapped = false;
+}
+
+// --- Range ---
+
+TickArchiveReader::Range::Range(const TickArchiveReader& reader, int64_t fromMs, int64_t toMs)
+    : reader(&reader), fromMs(fromMs), toMs(toMs), nextBlock(reader.seek(fromMs)) {}
+
+TickArchiveReader::Range::iterator TickArchiveReader::Range::begin() {
+    if (!started) {
+        started = true;
+        pos = limit = 0;
+        advance();
+    }
+    return iterator(this);
+}
+
+// Points t/bid/ask/mid at the next block with ticks in range: in place for raw
+// blocks, otherwise decoded into buffer.
+bool TickArchiveReader::Range::loadBlock() {
+    while (nextBlock < reader->blockCount()) {
+        const size_t i = nextBlock++;
+        const BlockRef& b = reader->blocks[i];
+        if (b.header->firstTs >= toMs) {
+            return false;
+        }
+        BlockView v = reader->block(i);
+        if (!v.timestampMs.empty() && !reader->options.verifyChecksums) {
+            t = v.timestampMs.data;
+            bid = v.bid.data;
+            ask = v.ask.data;
+            mid = v.mid.empty() ? nullptr : v.mid.data;
+        } else {
+            buffer.clear();
+            if (!reader->decode(i, buffer)) continue;
+            t = buffer.timestampMs.data();
+            bid = buffer.bid.data();
+            ask = buffer.ask.data();
+            mid = buffer.mid.data();
+        }
+        pos = static_cast<size_t>(std::lower_bound(t, t + v.count, fromMs) - t);
+        limit = static_cast<size_t>(std::lower_bound(t + pos, t + v.count, toMs) - t);
+        if (pos < limit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TickArchiveReader::Range::advance() {
+    if (finished) {
+        return;
+    }
+    if (pos + 1 < limit) {
+        ++pos;
+    } else if (!loadBlock()) {
+        finished = true;
+        return;
+    }
+    setCurrent();
+}
+
+void TickArchiveReader::Range::setCurrent() {
+    current.timestampMs = t[pos];
+    current.bid = bid[pos];
+    current.ask = ask[pos];
+    current.mid = mid ? mid[pos] : (bid[pos] + ask[pos]) / 2.0;
+}
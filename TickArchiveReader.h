@@ -0,0 +1,183 @@
+#ifndef TRADERMADE_TICK_ARCHIVE_READER_H
+#define TRADERMADE_TICK_ARCHIVE_READER_H
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "TickArchive.h"
+#include "TraderMadeTypes.h"
+
+// Read-only view of a contiguous column inside a mapped archive file or a buffer.
+template <typename T>
+struct ColumnSpan {
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
+// Memory-mapped reader for files written by TickArchiveWriter. open() maps the
+// partition files and their block indexes without reading or decoding any ticks,
+// so a month of data is queryable as soon as it returns; time-range lookups are a
+// binary search over the mapped index:
+//
+//   TickArchiveReader archive("/data/ticks");
+//   archive.open("EURUSD", fromMs, toMs);
+//   for (const TickArchiveReader::Tick& t : archive.range(fromMs, toMs)) { ... }
+//
+//   TickSeries ticks;
+//   archive.read(fromMs, toMs, ticks);   // columnar copy, as decodeTicks() produces
+//
+// TickCodec::Raw blocks are served in place (block() returns spans into the
+// mapping); Gorilla blocks are decoded one block at a time as they are reached.
+// Blocks past a truncated or corrupt tail are ignored. After open() the const
+// members are safe to call from several threads.
+class TickArchiveReader {
+public:
+    struct Options {
+        int64_t partitionMs = 0;        // 0: from the archive's manifest (one day if it has none)
+        bool verifyChecksums = false;   // check each block's payload before decoding it
+    };
+
+    struct Tick {
+        int64_t timestampMs;
+        double bid;
+        double ask;
+        double mid;
+    };
+
+    struct BlockView {
+        int64_t firstTs = 0;
+        int64_t lastTs = 0;
+        size_t count = 0;
+        TickCodec codec = TickCodec::Raw;
+        // Zero-copy columns; empty for compressed blocks. mid is also empty when the
+        // block derives it from bid and ask.
+        ColumnSpan<int64_t> timestampMs;
+        ColumnSpan<double> bid;
+        ColumnSpan<double> ask;
+        ColumnSpan<double> mid;
+    };
+
+    class Range;
+
+    explicit TickArchiveReader(const std::string& root);
+    TickArchiveReader(const std::string& root, const Options& options);
+    ~TickArchiveReader();
+
+    TickArchiveReader(const TickArchiveReader&) = delete;
+    TickArchiveReader& operator=(const TickArchiveReader&) = delete;
+
+    // Maps the partitions of symbol that overlap [fromMs, toMs), replacing anything
+    // mapped before. Missing partitions are skipped. Returns the number of blocks.
+    // Throws std::runtime_error if a file exists but cannot be mapped or is not an
+    // archive, or if Options::partitionMs contradicts the archive's manifest.
+    size_t open(const std::string& symbol, int64_t fromMs, int64_t toMs);
+    void close();
+
+    const std::string& symbol() const { return openSymbol; }
+    size_t partitionCount() const { return partitions.size(); }
+    size_t blockCount() const { return blocks.size(); }
+    size_t tickCount() const { return ticks; }
+    int64_t firstTimestamp() const; // INT64_MIN / INT64_MAX when nothing is mapped
+    int64_t lastTimestamp() const;
+
+    BlockView block(size_t i) const;
+    // Appends the ticks of block i; false if the block is corrupt.
+    bool decode(size_t i, TickSeries& out) const;
+    // Index of the first block that may hold ticks at or after timeMs (blockCount() if none).
+    size_t seek(int64_t timeMs) const;
+
+    // Appends ticks with fromMs <= t < toMs; returns the number appended.
+    size_t read(int64_t fromMs, int64_t toMs, TickSeries& out) const;
+    // Single-pass iteration over ticks with fromMs <= t < toMs.
+    Range range(int64_t fromMs, int64_t toMs) const;
+
+private:
+    struct MappedFile {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        bool mapped = false; // false: heap copy (no mmap on this platform)
+    };
+
+    struct Partition {
+        MappedFile data;
+        MappedFile index;
+    };
+
+    struct BlockRef {
+        const TickBlockHeader* header;
+        const uint8_t* payload;
+    };
+
+    std::string root;
+    Options options;
+    int64_t partitionMs = 0; // in effect since the last open()
+    std::string openSymbol;
+    std::vector<Partition> partitions;
+    std::vector<BlockRef> blocks; // time order
+    size_t ticks = 0;
+
+    static bool mapFile(const std::string& path, MappedFile& file);
+    static void unmapFile(MappedFile& file);
+    void addBlocks(const Partition& p, const std::string& path);
+};
+
+class TickArchiveReader::Range {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Tick;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Tick*;
+        using reference = const Tick&;
+
+        const Tick& operator*() const { return range->current; }
+        const Tick* operator->() const { return &range->current; }
+        iterator& operator++() {
+            range->advance();
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return done() == other.done(); }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class Range;
+        explicit iterator(Range* range) : range(range) {}
+        bool done() const { return !range || range->finished; }
+        Range* range;
+    };
+
+    iterator begin();
+    iterator end() { return iterator(nullptr); }
+
+private:
+    friend class TickArchiveReader;
+    Range(const TickArchiveReader& reader, int64_t fromMs, int64_t toMs);
+
+    const TickArchiveReader* reader;
+    int64_t fromMs;
+    int64_t toMs;
+    size_t nextBlock;
+    bool started = false;
+    bool finished = false;
+    TickSeries buffer;
+    const int64_t* t = nullptr;
+    const double* bid = nullptr;
+    const double* ask = nullptr;
+    const double* mid = nullptr; // null: derived
+    size_t pos = 0;
+    size_t limit = 0;
+    Tick current{};
+
+    bool loadBlock();
+    void advance();
+    void setCurrent();
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "TimeSeriesStore.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "Resample.h"
+#include "TraderMadeDecode.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TimeSeriesStore::TimeSeriesStore(TraderMade& tm) : TimeSeriesStore(tm, Options()) {}
+
+TimeSeriesStore::TimeSeriesStore(TraderMade& tm, const Options& options) : tm(tm), options(options) {
+    if (options.maxDailyRangeMs <= 0 || options.maxHourlyRangeMs <= 0 || options.maxMinuteRangeMs <= 0) {
+        throw std::invalid_argument("TimeSeriesStore range limits must be positive.");
+    }
+}
+
+int64_t TimeSeriesStore::barWidthMs(TimeSeriesInterval interval, int period) {
+    switch (interval) {
+    case TimeSeriesInterval::Daily:
+        return 86400000LL;
+    case TimeSeriesInterval::Hourly:
+        return period * 3600000LL;
+    case TimeSeriesInterval::Minute:
+        return period * 60000LL;
+    }
+    return 86400000LL;
+}
+
+Result<BarSeries> TimeSeriesStore::get(const std::string& symbol, TimeSeriesInterval interval, int period,
+                                       const std::string& startDate, const std::string& endDate) {
+    int64_t start = 0;
+    int64_t end = 0;
+    if (!parseApiTime(startDate, start) || !parseApiTime(endDate, end)) {
+        return RequestError{ErrorCode::InvalidArgument, 0, "startDate and endDate must be YYYY-MM-DD[ HH:MM]."};
+    }
+    return get(symbol, interval, period, start, end);
+}
+
+Result<BarSeries> TimeSeriesStore::get(const std::string& symbol, TimeSeriesInterval interval, int period,
+                                       int64_t startMs, int64_t endMs) {
+    if (symbol.empty() || !isValidTimeSeriesPeriod(interval, period) || endMs < startMs) {
+        return RequestError{ErrorCode::InvalidArgument, 0, "symbol, a valid period and startMs <= endMs are required."};
+    }
+    const int64_t width = barWidthMs(interval, period);
+    const bool intraday = interval != TimeSeriesInterval::Daily;
+    const Range query(bucketStart(startMs, width), bucketStart(endMs, width) + width);
+    const std::string seriesKey = key(symbol, interval, period);
+    const std::string periodText = std::to_string(period);
+
+    // The bar in progress is never held, so it is refreshed on every query.
+    const int64_t settled = bucketStart(nowMs(), width);
+
+    std::shared_ptr<std::mutex> gate;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Series& s = series[seriesKey];
+        if (subtract(s.held, query).empty()) {
+            return slice(s.bars, query); // cache hit: no request, never waits for one
+        }
+        if (!s.fetching) s.fetching = std::make_shared<std::mutex>();
+        gate = s.fetching;
+    }
+
+    // One fetcher per series. The store lock is released during each request, so other
+    // series, cache hits and insert() carry on while this one waits for the network.
+    std::lock_guard<std::mutex> fetchLock(*gate);
+    std::vector<Range> gaps;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        gaps = subtract(series[seriesKey].held, query); // a fetcher we waited for may have filled some
+    }
+    for (const Range& gap : gaps) {
+        for (int64_t chunk = gap.first; chunk < gap.second;) {
+            int64_t chunkEnd = std::min(gap.second, chunk + std::max(width, bucketStart(maxRangeMs(interval), width)));
+            Result<nlohmann::json> body = tm.tryGetTimeSeriesData(symbol, formatApiTime(chunk, intraday),
+                                                                   formatApiTime(chunkEnd - width, intraday),
+                                                                   toApiString(interval), periodText, "records");
+            BarSeries fetched;
+            if (body) {
+                decodeBars(body.value(), fetched);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ++requestCount;
+            if (!body) {
+                return body.error();
+            }
+            downloaded += fetched.size();
+            Series& s = series[seriesKey]; // re-created if clear() ran meanwhile
+            mergeBars(s.bars, fetched, Range(chunk, chunkEnd));
+            if (chunk < settled) {
+                addHeld(s.held, Range(chunk, std::min(chunkEnd, settled)));
+            }
+            chunk = chunkEnd;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return slice(series[seriesKey].bars, query);
+}
+
+BarSeries TimeSeriesStore::slice(const BarSeries& bars, Range query) {
+    BarSeries out;
+    auto first = std::lower_bound(bars.timestampMs.begin(), bars.timestampMs.end(), query.first);
+    auto last = std::lower_bound(first, bars.timestampMs.end(), query.second);
+    size_t begin = static_cast<size_t>(first - bars.timestampMs.begin());
+    size_t end = static_cast<size_t>(last - bars.timestampMs.begin());
+    out.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        out.push_back(bars.timestampMs[i], bars.open[i], bars.high[i], bars.low[i], bars.close[i]);
+    }
+    return out;
+}
+
+std::vector<TimeSeriesStore::Range> TimeSeriesStore::missing(const std::string& symbol, TimeSeriesInterval interval,
+                                                             int period, int64_t startMs, int64_t endMs) const {
+    const int64_t width = barWidthMs(interval, period);
+    const Range query(bucketStart(startMs, width), bucketStart(endMs, width) + width);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = series.find(key(symbol, interval, period));
+    return subtract(it == series.end() ? std::vector<Range>() : it->second.held, query);
+}
+
+void TimeSeriesStore::insert(const std::string& symbol, TimeSeriesInterval interval, int period,
+                             const BarSeries& bars, int64_t coveredBegin, int64_t coveredEnd) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Series& s = series[key(symbol, interval, period)];
+    mergeBars(s.bars, bars, Range(coveredBegin, coveredEnd));
+    if (coveredBegin < coveredEnd) {
+        addHeld(s.held, Range(coveredBegin, coveredEnd));
+    }
+}
+
+void TimeSeriesStore::clear(const std::string& symbol, TimeSeriesInterval interval, int period) {
+    std::lock_guard<std::mutex> lock(mutex);
+    series.erase(key(symbol, interval, period));
+}
+
+void TimeSeriesStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    series.clear();
+}
+
+size_t TimeSeriesStore::barCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t n = 0;
+    for (const auto& kv : series) {
+        n += kv.second.bars.size();
+    }
+    return n;
+}
+
+uint64_t TimeSeriesStore::requests() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return requestCount;
+}
+
+uint64_t TimeSeriesStore::barsDownloaded() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return downloaded;
+}
+
+std::string TimeSeriesStore::key(const std::string& symbol, TimeSeriesInterval interval, int period) {
+    return symbol + '/' + toApiString(interval) + '/' + std::to_string(period);
+}
+
+int64_t TimeSeriesStore::maxRangeMs(TimeSeriesInterval interval) const {
+    return interval == TimeSeriesInterval::Daily  ? options.maxDailyRangeMs
+         : interval == TimeSeriesInterval::Hourly ? options.maxHourlyRangeMs
+         :                                          options.maxMinuteRangeMs;
+}
+
+std::vector<TimeSeriesStore::Range> TimeSeriesStore::subtract(const std::vector<Range>& held, Range query) {
+    std::vector<Range> gaps;
+    int64_t cursor = query.first;
+    for (const Range& h : held) {
+        if (h.second <= cursor) continue;
+        if (h.first >= query.second) break;
+        if (h.first > cursor) gaps.emplace_back(cursor, h.first);
+        cursor = std::max(cursor, h.second);
+        if (cursor >= query.second) break;
+    }
+    if (cursor < query.second) gaps.emplace_back(cursor, query.second);
+    return gaps;
+}
+
+void TimeSeriesStore::addHeld(std::vector<Range>& held, Range r) {
+    auto it = std::lower_bound(held.begin(), held.end(), r);
+    held.insert(it, r);
+    std::vector<Range> merged;
+    merged.reserve(held.size());
+    for (const Range& h : held) {
+        if (!merged.empty() && h.first <= merged.back().second) {
+            merged.back().second = std::max(merged.back().second, h.second);
+        } else {
+            merged.push_back(h);
+        }
+    }
+    held.swap(merged);
+}
+
+// Replaces the bars of `into` inside `replaced` with `bars` (both sorted by time).
+void TimeSeriesStore::mergeBars(BarSeries& into, const BarSeries& bars, Range replaced) {
+    const std::vector<int64_t>& t = into.timestampMs;
+    size_t cut = static_cast<size_t>(std::lower_bound(t.begin(), t.end(), replaced.first) - t.begin());
+    size_t resume = static_cast<size_t>(std::lower_bound(t.begin() + cut, t.end(), replaced.second) - t.begin());
+    if (cut == into.size() && (bars.empty() || into.empty() || bars.timestampMs.front() > t.back())) {
+        // Common case: appending newer bars.
+        for (size_t i = 0; i < bars.size(); ++i) {
+            if (bars.timestampMs[i] < replaced.first || bars.timestampMs[i] >= replaced.second) continue;
+            into.push_back(bars.timestampMs[i], bars.open[i], bars.high[i], bars.low[i], bars.close[i]);
+        }
+        return;
+    }
+    BarSeries merged;
+    merged.reserve(into.size() - (resume - cut) + bars.size());
+    for (size_t i = 0; i < cut; ++i) {
+        merged.push_back(into.timestampMs[i], into.open[i], into.high[i], into.low[i], into.close[i]);
+    }
+    for (size_t i = 0; i < bars.size(); ++i) {
+        if (bars.timestampMs[i] < replaced.first || bars.timestampMs[i] >= replaced.second) continue;
+        merged.push_back(bars.timestampMs[i], bars.open[i], bars.high[i], bars.low[i], bars.close[i]);
+    }
+    for (size_t i = resume; i < into.size(); ++i) {
+        merged.push_back(into.timestampMs[i], into.open[i], into.high[i], into.low[i], into.close[i]);
+    }
+    into = std::move(merged);
+}
@@ -0,0 +1,94 @@
+#ifndef TRADERMADE_TIME_SERIES_STORE_H
+#define TRADERMADE_TIME_SERIES_STORE_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TraderMadeTypes.h"
+#include "TraderMadeResult.h"
+
+class TraderMade;
+
+// Local cache of /timeseries bars per (symbol, interval, period). It remembers which
+// time ranges it already holds, and a query only fetches the missing ranges, so a
+// rolling daily refresh downloads just the newest bars:
+//
+//   TimeSeriesStore store(tm);
+//   Result<BarSeries> bars = store.get("EURUSD", TimeSeriesInterval::Daily, 1, "2025-01-01", "2026-01-01");
+//   // tomorrow: only the new day(s) are requested
+//
+// Ranges are [startMs, endMs] inclusive of the bar that starts at endMs, like the
+// API's start_date/end_date. A bar whose period has not finished yet is returned but
+// not marked as held, so it is fetched again next time. Missing ranges longer than
+// the API allows per request are split into several requests.
+// All members are thread-safe. No lock is held during a request: a get() that has to
+// fetch only waits for another get() fetching the same series, and cache hits never wait.
+class TimeSeriesStore {
+public:
+    struct Options {
+        int64_t maxDailyRangeMs = 365LL * 86400000;  // per-request limits
+        int64_t maxHourlyRangeMs = 30LL * 86400000;
+        int64_t maxMinuteRangeMs = 2LL * 86400000;
+    };
+
+    using Range = std::pair<int64_t, int64_t>; // [begin, end) in ms
+
+    explicit TimeSeriesStore(TraderMade& tm);
+    TimeSeriesStore(TraderMade& tm, const Options& options);
+
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+
+    // Bars in [startMs, endMs], fetching whatever is not held yet.
+    Result<BarSeries> get(const std::string& symbol, TimeSeriesInterval interval, int period,
+                          int64_t startMs, int64_t endMs);
+    // Same with API date strings ("YYYY-MM-DD" or "YYYY-MM-DD HH:MM").
+    Result<BarSeries> get(const std::string& symbol, TimeSeriesInterval interval, int period,
+                          const std::string& startDate, const std::string& endDate);
+
+    // Ranges get() would have to fetch for this query.
+    std::vector<Range> missing(const std::string& symbol, TimeSeriesInterval interval, int period,
+                               int64_t startMs, int64_t endMs) const;
+
+    // Adds bars fetched elsewhere; [coveredBegin, coveredEnd) is marked as held.
+    void insert(const std::string& symbol, TimeSeriesInterval interval, int period,
+                const BarSeries& bars, int64_t coveredBegin, int64_t coveredEnd);
+
+    // Drops one series, or everything.
+    void clear(const std::string& symbol, TimeSeriesInterval interval, int period);
+    void clear();
+
+    size_t barCount() const;
+    uint64_t requests() const;        // /timeseries calls made
+    uint64_t barsDownloaded() const;
+
+    static int64_t barWidthMs(TimeSeriesInterval interval, int period);
+
+private:
+    struct Series {
+        BarSeries bars;
+        std::vector<Range> held;             // sorted, non-overlapping
+        std::shared_ptr<std::mutex> fetching; // held by the get() fetching for this series
+    };
+
+    TraderMade& tm;
+    Options options;
+    mutable std::mutex mutex;
+    std::map<std::string, Series> series;
+    uint64_t requestCount = 0;
+    uint64_t downloaded = 0;
+
+    static std::string key(const std::string& symbol, TimeSeriesInterval interval, int period);
+    int64_t maxRangeMs(TimeSeriesInterval interval) const;
+    static std::vector<Range> subtract(const std::vector<Range>& held, Range query);
+    static void addHeld(std::vector<Range>& held, Range r);
+    static void mergeBars(BarSeries& into, const BarSeries& bars, Range replaced);
+    static BarSeries slice(const BarSeries& bars, Range query);
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include "TraderMadeDecode.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+// The decoders are templates over the document type: nlohmann::json or ArenaJson.
+
+template <typename Json>
+double numberOr(const Json& j, const char* key, double fallback) {
+    auto it = j.find(key);
+    return it != j.end() && it->is_number() ? it->template get<double>() : fallback;
+}
+
+template <typename Json>
+std::string stringOr(const Json& j, const char* key) {
+    auto it = j.find(key);
+    if (it == j.end() || !it->is_string()) {
+        return std::string();
+    }
+    const auto& text = it->template get_ref<const typename Json::string_t&>();
+    return std::string(text.data(), text.size());
+}
+
+const int64_t MS_PER_DAY = 86400000;
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+int daysInMonth(int y, int m) {
+    static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return m == 2 && leap ? 29 : DAYS[m - 1];
+}
+
+// Reads exactly `digits` decimal digits.
+bool readDigits(const char* p, int digits, int& value) {
+    value = 0;
+    for (int i = 0; i < digits; ++i) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+}
+
+template <typename Json>
+bool timeOf(const Json& q, int64_t& ms) {
+    auto it = q.find("date");
+    if (it == q.end() || !it->is_string()) {
+        return false;
+    }
+    const auto& text = it->template get_ref<const typename Json::string_t&>();
+    return parseApiTime(text.data(), text.size(), ms);
+}
+
+template <typename Json>
+size_t decodeLiveQuotesIn(const Json& body, std::vector<LiveQuote>& out) {
+    if (!body.is_object()) {
+        return 0;
+    }
+    auto quotes = body.find("quotes");
+    if (quotes == body.end() || !quotes->is_array()) {
+        return 0;
+    }
+    int64_t timestampMs = static_cast<int64_t>(numberOr(body, "timestamp", 0.0) * 1000.0);
+
+    size_t added = 0;
+    for (const Json& q : *quotes) {
+        if (!q.is_object() || q.contains("error")) {
+            continue;
+        }
+        std::string symbol = stringOr(q, "instrument");
+        if (symbol.empty()) {
+            symbol = stringOr(q, "base_currency") + stringOr(q, "quote_currency");
+        }
+        if (symbol.empty()) {
+            continue;
+        }
+        LiveQuote quote;
+        quote.setSymbol(symbol);
+        quote.bid = numberOr(q, "bid", 0.0);
+        quote.ask = numberOr(q, "ask", 0.0);
+        quote.mid = numberOr(q, "mid", (quote.bid + quote.ask) / 2.0);
+        quote.timestampMs = timestampMs;
+        out.push_back(quote);
+        ++added;
+    }
+    return added;
+}
+
+template <typename Json>
+size_t decodeTicksIn(const Json& body, TickSeries& out) {
+    auto quotes = body.is_object() ? body.find("quotes") : body.end();
+    if (quotes == body.end() || !quotes->is_array()) {
+        return 0;
+    }
+    out.reserve(out.size() + quotes->size());
+    size_t added = 0;
+    for (const Json& q : *quotes) {
+        int64_t t = 0;
+        if (!q.is_object() || !timeOf(q, t)) {
+            continue;
+        }
+        double bid = numberOr(q, "bid", 0.0);
+        double ask = numberOr(q, "ask", 0.0);
+        out.push_back(t, bid, ask, numberOr(q, "mid", (bid + ask) / 2.0));
+        ++added;
+    }
+    return added;
+}
+
+template <typename Json>
+size_t decodeBarsIn(const Json& body, BarSeries& out) {
+    auto quotes = body.is_object() ? body.find("quotes") : body.end();
+    if (quotes == body.end() || !quotes->is_array()) {
+        return 0;
+    }
+    out.reserve(out.size() + quotes->size());
+    size_t added = 0;
+    for (const Json& q : *quotes) {
+        int64_t t = 0;
+        if (!q.is_object() || q.contains("error") || !timeOf(q, t)) {
+            continue;
+        }
+        double close = numberOr(q, "close", 0.0);
+        out.push_back(t, numberOr(q, "open", close), numberOr(q, "high", close), numberOr(q, "low", close), close);
+        ++added;
+    }
+    return added;
+}
+
+} // namespace
+
+size_t decodeLiveQuotes(const nlohmann::json& body, std::vector<LiveQuote>& out) {
+    return decodeLiveQuotesIn(body, out);
+}
+
+size_t decodeLiveQuotes(const ArenaJson& body, std::vector<LiveQuote>& out) {
+    return decodeLiveQuotesIn(body, out);
+}
+
+size_t decodeTicks(const nlohmann::json& body, TickSeries& out) {
+    return decodeTicksIn(body, out);
+}
+
+size_t decodeTicks(const ArenaJson& body, TickSeries& out) {
+    return decodeTicksIn(body, out);
+}
+
+size_t decodeBars(const nlohmann::json& body, BarSeries& out) {
+    return decodeBarsIn(body, out);
+}
+
+size_t decodeBars(const ArenaJson& body, BarSeries& out) {
+    return decodeBarsIn(body, out);
+}
+
+bool parseApiTime(const char* text, size_t length, int64_t& ms) {
+    if (length != 10 && length != 16 && length != 19 && length != 23) {
+        return false;
+    }
+    int y, mo, d, h = 0, mi = 0, sec = 0, milli = 0;
+    if (!readDigits(text, 4, y) || text[4] != '-' || !readDigits(text + 5, 2, mo) || text[7] != '-' ||
+        !readDigits(text + 8, 2, d) || mo < 1 || mo > 12 || d < 1 || d > daysInMonth(y, mo)) {
+        return false;
+    }
+    if (length >= 16) {
+        char sep = text[10];
+        if ((sep != ' ' && sep != 'T' && sep != '-') || !readDigits(text + 11, 2, h) || text[13] != ':' ||
+            !readDigits(text + 14, 2, mi) || mi > 59) {
+            return false;
+        }
+    }
+    if (length >= 19 && (text[16] != ':' || !readDigits(text + 17, 2, sec) || sec > 60)) {
+        return false;
+    }
+    if (length == 23 && (text[19] != '.' || !readDigits(text + 20, 3, milli))) {
+        return false;
+    }
+    if (h > 24 || (h == 24 && (mi != 0 || sec != 0 || milli != 0))) {
+        return false; // 24:00 is the end of the day, nothing later
+    }
+    ms = daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * MS_PER_DAY +
+         h * 3600000LL + mi * 60000LL + sec * 1000LL + milli;
+    return true;
+}
+
+std::string formatApiTime(int64_t ms, bool withTime) {
+    int64_t days = ms / MS_PER_DAY - (ms % MS_PER_DAY < 0 ? 1 : 0);
+    int64_t rem = ms - days * MS_PER_DAY;
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    char buf[32];
+    if (withTime) {
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d", static_cast<int>(y), m, d,
+                      static_cast<int>(rem / 3600000), static_cast<int>(rem / 60000 % 60));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", static_cast<int>(y), m, d);
+    }
+    return buf;
+}
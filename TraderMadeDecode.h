@@ -0,0 +1,36 @@
+#ifndef TRADERMADE_DECODE_H
+#define TRADERMADE_DECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "JsonArena.h"
+#include "TraderMadeTypes.h"
+
+// Typed decoders for API responses. Each appends to out and returns the number of
+// records appended; entries the API flagged as errors are skipped. Each also takes an
+// ArenaJson (see JsonArena.h).
+
+// /live response: {"quotes": [{"base_currency", "quote_currency" | "instrument", "bid", "ask", "mid"}], "timestamp"}
+size_t decodeLiveQuotes(const nlohmann::json& body, std::vector<LiveQuote>& out);
+size_t decodeLiveQuotes(const ArenaJson& body, std::vector<LiveQuote>& out);
+
+// /tick_historical (format=json): {"quotes": [{"date": "YYYY-MM-DD HH:MM:SS.mmm", "bid", "ask", "mid"}]}
+size_t decodeTicks(const nlohmann::json& body, TickSeries& out);
+size_t decodeTicks(const ArenaJson& body, TickSeries& out);
+
+// /timeseries (format=records): {"quotes": [{"date", "open", "high", "low", "close"}]}
+size_t decodeBars(const nlohmann::json& body, BarSeries& out);
+size_t decodeBars(const ArenaJson& body, BarSeries& out);
+
+// API timestamps: "YYYY-MM-DD", "YYYY-MM-DD HH:MM[:SS[.mmm]]", also with 'T' or '-' before the time.
+// UTC milliseconds since the epoch; false if the text is not exactly one of these forms or
+// not a real date and time (2024-02-30, 10:60; 24:00 only as 24:00[:00[.000]]).
+bool parseApiTime(const char* text, size_t length, int64_t& ms);
+inline bool parseApiTime(const std::string& text, int64_t& ms) { return parseApiTime(text.data(), text.size(), ms); }
+
+// Inverse of parseApiTime: "YYYY-MM-DD" or "YYYY-MM-DD HH:MM" (the time series request format).
+std::string formatApiTime(int64_t ms, bool withTime);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TRADERMADE_RESULT_H
+#define TRADERMADE_RESULT_H
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+
+// Error categories reported by the non-throwing (try*) API
+enum class ErrorCode {
+    InvalidArgument, // request rejected before it was sent
+    NotConfigured,   // setRestApiKey() has not been called
+    Transport,       // curl could not be started or could not reach the server
+    HttpStatus,      // server answered with a 4xx/5xx status
+    ApiError,        // 2xx response whose body is an API error object
+    Parse,           // response body is not valid JSON
+    QuotaExhausted,  // every API key has used its quota (setRestApiKeys)
+    CircuitOpen,     // failed fast: the endpoint family's circuit breaker is open
+    Cancelled        // the thread's CancellationScope token was cancelled
+};
+
+struct RequestError {
+    ErrorCode code;
+    int status;          // HTTP status, API error code or curl exit code (0 if not applicable)
+    std::string message;
+};
+
+// expected-style holder: either a value or a RequestError, never throws on construction
+template <typename T>
+class Result {
+public:
+    Result(T value) : hasValue(true), val(std::move(value)), err{ErrorCode::InvalidArgument, 0, std::string()} {}
+    Result(RequestError error) : hasValue(false), val(), err(std::move(error)) {}
+
+    bool ok() const { return hasValue; }
+    explicit operator bool() const { return hasValue; }
+
+    // Calling value() on an error result is a programming error and throws std::logic_error
+    T& value() {
+        if (!hasValue) throw std::logic_error("Result has no value: " + err.message);
+        return val;
+    }
+    const T& value() const {
+        if (!hasValue) throw std::logic_error("Result has no value: " + err.message);
+        return val;
+    }
+
+    T* operator->() { return &value(); }
+    const T* operator->() const { return &value(); }
+
+    T valueOr(T fallback) const { return hasValue ? val : std::move(fallback); }
+
+    // Only meaningful when ok() is false
+    const RequestError& error() const { return err; }
+
+private:
+    bool hasValue;
+    T val;
+    RequestError err;
+};
+
+#endif
@@ -3,15 +3,30 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <map>
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <limits>
 #include <cstdio>
 #include <array>
 #include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
 #include <nlohmann/json.hpp> 
 
 
@@ -20,31 +35,124 @@
 namespace Constants {
     const std::string DEFAULT_BASE_URL = "https://marketdata.tradermade.com/api/v1";
 
-    const std::vector<std::string> TIME_SERIES_FORMAT = {
-        "records", "csv", "index", "columns", "split"
-    };
+    constexpr std::array<TimeSeriesFormat, 5> TIME_SERIES_FORMAT = {{
+        TimeSeriesFormat::Records, TimeSeriesFormat::Csv, TimeSeriesFormat::Index,
+        TimeSeriesFormat::Columns, TimeSeriesFormat::Split
+    }};
 
-    const std::vector<std::string> TIME_SERIES_INTERVAL = {
-        "daily", "hourly", "minute"
-    };
+    constexpr std::array<TimeSeriesInterval, 3> TIME_SERIES_INTERVAL = {{
+        TimeSeriesInterval::Daily, TimeSeriesInterval::Hourly, TimeSeriesInterval::Minute
+    }};
 
-    std::map<std::string, std::vector<int>> createPeriodMap() {
-        std::map<std::string, std::vector<int>> m;
-        m["daily"]  = {1};
-        m["hourly"] = {1, 2, 4, 6, 8, 24};
-        m["minute"] = {1, 5, 10, 15, 30};
-        return m;
-    }
+    // Union of all periods; isValidTimeSeriesPeriod() decides per interval
+    constexpr std::array<int, 10> TIME_SERIES_PERIOD = {{1, 2, 4, 5, 6, 8, 10, 15, 24, 30}};
 
-    const std::map<std::string, std::vector<int>> TIME_SERIES_PERIOD = createPeriodMap();
+    constexpr std::array<PandasFields, 2> DATA_EXPORTS_PANDAS_DF_FIELDS = {{
+        PandasFields::Close, PandasFields::Ohlc
+    }};
+
+    constexpr std::array<PandasFormat, 4> DATA_EXPORTS_PANDAS_DF_FORMAT = {{
+        PandasFormat::Records, PandasFormat::Columns, PandasFormat::Index, PandasFormat::Split
+    }};
+}
 
-    const std::vector<std::string> DATA_EXPORTS_PANDAS_DF_FIELDS = {
-        "close", "ohlc"
+// Endpoint descriptors: path, number of path segments and query parameter names are
+// fixed at compile time, so a call site passing the wrong number of values fails to build.
+namespace Endpoints {
+    enum Id : std::size_t {
+        LIVE_ID,
+        LIVE_CURRENCIES_LIST_ID,
+        STREAMING_CURRENCIES_LIST_ID,
+        LIVE_CRYPTO_LIST_ID,
+        HISTORICAL_CURRENCIES_LIST_ID,
+        CFD_LIST_ID,
+        HISTORICAL_ID,
+        HOUR_HISTORICAL_ID,
+        MINUTE_HISTORICAL_ID,
+        TICK_HISTORICAL_ID,
+        TICK_HISTORICAL_SAMPLE_ID,
+        TIMESERIES_ID,
+        MARKET_OPEN_STATUS_ID,
+        MARKET_OPENING_TIMES_ID,
+        CONVERT_ID,
+        PANDAS_DF_ID,
+        COUNT
     };
 
-    const std::vector<std::string> DATA_EXPORTS_PANDAS_DF_FORMAT = {
-        "records", "columns", "index", "split"
+    constexpr std::array<const char*, COUNT> PATHS = {{
+        "/live",
+        "/live_currencies_list",
+        "/streaming_currencies_list",
+        "/live_crypto_list",
+        "/historical_currencies_list",
+        "/cfd_list",
+        "/historical",
+        "/hour_historical",
+        "/minute_historical",
+        "/tick_historical",
+        "/tick_historical_sample",
+        "/timeseries",
+        "/market_open_status",
+        "/market_opening_times",
+        "/convert",
+        "/pandasDF"
+    }};
+
+    template <std::size_t Segments, std::size_t Params>
+    struct Endpoint {
+        Id id;
+        std::array<const char*, Params> params;
     };
+
+    constexpr Endpoint<0, 1> LIVE{LIVE_ID, {{"currency"}}};
+    constexpr Endpoint<0, 0> LIVE_CURRENCIES_LIST{LIVE_CURRENCIES_LIST_ID, {}};
+    constexpr Endpoint<0, 0> STREAMING_CURRENCIES_LIST{STREAMING_CURRENCIES_LIST_ID, {}};
+    constexpr Endpoint<0, 0> LIVE_CRYPTO_LIST{LIVE_CRYPTO_LIST_ID, {}};
+    constexpr Endpoint<0, 0> HISTORICAL_CURRENCIES_LIST{HISTORICAL_CURRENCIES_LIST_ID, {}};
+    constexpr Endpoint<0, 0> CFD_LIST{CFD_LIST_ID, {}};
+    constexpr Endpoint<0, 2> HISTORICAL{HISTORICAL_ID, {{"currency", "date"}}};
+    constexpr Endpoint<0, 2> HOUR_HISTORICAL{HOUR_HISTORICAL_ID, {{"date_time", "currency"}}};
+    constexpr Endpoint<0, 2> MINUTE_HISTORICAL{MINUTE_HISTORICAL_ID, {{"date_time", "currency"}}};
+    constexpr Endpoint<3, 1> TICK_HISTORICAL{TICK_HISTORICAL_ID, {{"format"}}};
+    constexpr Endpoint<3, 1> TICK_HISTORICAL_SAMPLE{TICK_HISTORICAL_SAMPLE_ID, {{"format"}}};
+    constexpr Endpoint<0, 6> TIMESERIES{TIMESERIES_ID,
+        {{"currency", "start_date", "end_date", "interval", "period", "format"}}};
+    constexpr std::array<EndpointFamily, COUNT> FAMILIES = {{
+        EndpointFamily::Live,
+        EndpointFamily::Reference,
+        EndpointFamily::Reference,
+        EndpointFamily::Reference,
+        EndpointFamily::Reference,
+        EndpointFamily::Reference,
+        EndpointFamily::Historical,
+        EndpointFamily::Historical,
+        EndpointFamily::Historical,
+        EndpointFamily::Tick,
+        EndpointFamily::Tick,
+        EndpointFamily::TimeSeries,
+        EndpointFamily::Market,
+        EndpointFamily::Market,
+        EndpointFamily::Convert,
+        EndpointFamily::Pandas
+    }};
+
+    constexpr Endpoint<0, 0> MARKET_OPEN_STATUS{MARKET_OPEN_STATUS_ID, {}};
+    constexpr Endpoint<0, 0> MARKET_OPENING_TIMES{MARKET_OPENING_TIMES_ID, {}};
+    constexpr Endpoint<0, 3> CONVERT{CONVERT_ID, {{"from", "to", "amount"}}};
+    constexpr Endpoint<0, 5> PANDAS_DF{PANDAS_DF_ID,
+        {{"currency", "start_date", "end_date", "format", "fields"}}};
+}
+
+// Map an API string onto its enum using the toApiString() names
+template <typename Enum, std::size_t N>
+bool parseApiString(const std::string& text, const std::array<Enum, N>& values, Enum& out) {
+    for (Enum v : values) {
+        if (text == toApiString(v)) {
+            out = v;
+            return true;
+        }
+    }
+    return false;
 }
 
 // trim whitespace (for API key check)
@@ -60,69 +168,738 @@ inline std::string trim(const std::string &s) {
     return s.substr(start, end - start);
 }
 
-// URL encoder (similar to encodeURIComponent)
-std::string urlEncode(const std::string &value) {
-    std::ostringstream escaped;
-    escaped.fill('0');
-    escaped << std::hex;
+// True for "http[s]://host[:port][/path]" with host, port and path limited to letters,
+// digits and "-._~/". The base URL is pasted into a shell command, so nothing the
+// shell would interpret (quotes, $, backticks, spaces) may get through.
+bool isSafeBaseUrl(const std::string& url) {
+    size_t i = url.compare(0, 8, "https://") == 0 ? 8 : url.compare(0, 7, "http://") == 0 ? 7 : 0;
+    if (i == 0) {
+        return false;
+    }
+    const size_t hostStart = i;
+    while (i < url.size() && (std::isalnum(static_cast<unsigned char>(url[i])) || url[i] == '-' || url[i] == '.')) {
+        ++i;
+    }
+    if (i == hostStart) {
+        return false;
+    }
+    if (i < url.size() && url[i] == ':') {
+        const size_t portStart = ++i;
+        while (i < url.size() && std::isdigit(static_cast<unsigned char>(url[i]))) {
+            ++i;
+        }
+        if (i == portStart || i - portStart > 5) {
+            return false;
+        }
+    }
+    if (i < url.size() && url[i] != '/') {
+        return false;
+    }
+    for (; i < url.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(url[i]);
+        if (!std::isalnum(c) && c != '-' && c != '.' && c != '_' && c != '~' && c != '/') {
+            return false;
+        }
+    }
+    return true;
+}
 
-    for (unsigned char c : value) {
-        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-            escaped << c;
+// URL encoding table: true for RFC 3986 unreserved characters (similar to encodeURIComponent)
+const std::array<bool, 256> URL_UNRESERVED = [] {
+    std::array<bool, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~';
+    }
+    return table;
+}();
+
+// Append the URL encoded form of value to out (no temporaries)
+void appendUrlEncoded(std::string& out, const char* value, size_t length) {
+    static const char HEX[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (URL_UNRESERVED[c]) {
+            out += static_cast<char>(c);
         } else {
-            escaped << std::uppercase;
-            escaped << '%' << std::setw(2) << int(c);
-            escaped << std::nouppercase;
+            out += '%';
+            out += HEX[c >> 4];
+            out += HEX[c & 0x0F];
         }
     }
-    return escaped.str();
 }
 
+// URL encoder (similar to encodeURIComponent)
+std::string urlEncode(const std::string &value) {
+    std::string escaped;
+    escaped.reserve(value.size() * 3);
+    appendUrlEncoded(escaped, value.data(), value.size());
+    return escaped;
+}
+
+// Outcome of the last curl invocation on a thread
+struct Transfer {
+    bool started = false;
+    int exitCode = 0;
+    int httpStatus = 0; // 0 when no HTTP response was received
+};
+
+// Non-owning string reference (C++14 stand-in for std::string_view)
+struct ValueRef {
+    const char* data;
+    size_t size;
+
+    ValueRef(const std::string& s) : data(s.data()), size(s.size()) {}
+    ValueRef(const char* s) : data(s), size(std::strlen(s)) {}
+};
+
 // CLIENT CLASS IMPLEMENTATION
+// Immutable once constructed: TraderMade publishes a new KeyPool (one Client per key)
+// when the keys or base URL change, so requests read it without locking.
 class Client {
 private:
-    std::string apiKey;
+    const std::string apiKey;
+    const std::string baseUrl;
+
+    // curl command prefix per endpoint and "?api_key=<key>", built once per client
+    std::array<std::string, Endpoints::COUNT> prefixes;
+    std::string keyQuery;
+
+    // Per-thread buffers reused across requests so the steady state allocates nothing
+    struct Buffers {
+        std::string command;
+        std::string response;
+        Transfer transfer;
+    };
 
-    std::string exec(const char* cmd) {
-        std::array<char, 256> buffer{};
-        std::string result;
+    static Buffers& buffers() {
+        thread_local Buffers b;
+        return b;
+    }
+
+    // Runs cmd and reads its whole stdout into out, reusing out's capacity.
+    // Returns false if the process could not be started. On POSIX, cancelling the
+    // calling thread's CancellationScope token kills the transfer.
+    static bool exec(const char* cmd, std::string& out, int& exitCode) {
+        const size_t MIN_CAPACITY = 16 * 1024;
+        out.clear();
 
     #ifdef _WIN32
         std::unique_ptr<FILE, decltype(&_pclose)> pipe(_popen(cmd, "r"), _pclose);
+
+        if (!pipe) {
+            return false;
+        }
+        out.resize(std::max(out.capacity(), MIN_CAPACITY));
+        size_t used = 0;
+        while (true) {
+            size_t n = fread(&out[used], 1, out.size() - used, pipe.get());
+            used += n;
+            if (used == out.size()) {
+                out.resize(out.size() * 2);
+            } else if (n == 0) {
+                break;
+            }
+        }
+        out.resize(used);
+        exitCode = _pclose(pipe.release());
+    #else
+        // popen() without a pid to kill: spawn "sh -c cmd" with stdout on a
+        // close-on-exec pipe. The command execs curl, so the pid is curl's. It stays in
+        // the caller's process group, so a terminal Ctrl-C reaches it too.
+        int fds[2];
+    #ifdef __linux__
+        if (pipe2(fds, O_CLOEXEC) != 0) {
+            return false;
+        }
     #else
-        std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), pclose);
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
     #endif
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+        char shell[] = "sh";
+        char flag[] = "-c";
+        char* argv[] = {shell, flag, const_cast<char*>(cmd), nullptr};
+        pid_t pid = 0;
+        int spawned = posix_spawn(&pid, "/bin/sh", &actions, nullptr, argv, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(fds[1]);
+        if (spawned != 0) {
+            ::close(fds[0]);
+            return false;
+        }
 
-        if (!pipe) {
-            throw std::runtime_error("Failed to run curl command.");
+        // The child is reaped only after unsubscribing, so the pid cannot be reused
+        // while the callback may still signal it.
+        const CancellationToken* token = CancellationScope::current();
+        size_t subscription = token ? token->subscribe([pid] { ::kill(pid, SIGTERM); }) : 0;
+
+        out.resize(std::max(out.capacity(), MIN_CAPACITY));
+        size_t used = 0;
+        while (true) {
+            ssize_t n = ::read(fds[0], &out[used], out.size() - used);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            used += static_cast<size_t>(n);
+            if (used == out.size()) {
+                out.resize(out.size() * 2);
+            }
+        }
+        out.resize(used);
+        ::close(fds[0]);
+
+        if (token) {
+            token->unsubscribe(subscription);
         }
-        while (fgets(buffer.data(), static_cast<int>(buffer.size()), pipe.get()) != nullptr) {
-            result += buffer.data();
+        int status = 0;
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    #endif
+        return true;
+    }
+
+    // Strips the "\n<http_code>" trailer written by curl -w
+    static int takeHttpStatus(std::string& response) {
+        size_t pos = response.rfind('\n');
+        if (pos == std::string::npos) {
+            return 0;
         }
-        return result;
+        int status = std::atoi(response.c_str() + pos + 1);
+        response.resize(pos);
+        return status;
     }
 
 public:
-    explicit Client(const std::string& key) : apiKey(key) {}
+    Client(const std::string& key, const std::string& url) : apiKey(key), baseUrl(url) {
+        // Use -s for silent. Remove -k to enforce SSL validation.
+        for (size_t i = 0; i < Endpoints::COUNT; ++i) {
+        #ifdef _WIN32
+            prefixes[i] = "curl -s -w \"\\n%{http_code}\" \"" + baseUrl + Endpoints::PATHS[i];
+        #else
+            // exec: curl replaces the shell, so the pid exec() waits on (and kills) is curl's
+            prefixes[i] = "exec curl -s -w \"\\n%{http_code}\" \"" + baseUrl + Endpoints::PATHS[i];
+        #endif
+        }
+        keyQuery = "?api_key=" + urlEncode(apiKey);
+    }
 
-    std::string get(const std::string& endpoint,
-                    const std::map<std::string, std::string>& params = {}) {
-        std::string fullUrl = Constants::DEFAULT_BASE_URL + endpoint + "?api_key=" + urlEncode(apiKey);
+    // Fills the endpoint template with path segments followed by query values, in
+    // descriptor order, and runs the request. Empty query values are omitted. Returns
+    // false only if curl could not be started; see response() and transfer().
+    template <std::size_t Segments, std::size_t Params, typename... Values>
+    bool fetch(const Endpoints::Endpoint<Segments, Params>& endpoint, const Values&... values) const {
+        static_assert(sizeof...(Values) == Segments + Params,
+                      "Number of values does not match the endpoint descriptor.");
+        const ValueRef refs[] = {ValueRef(values)..., ValueRef("")};
 
-        for (const auto& kv : params) {
-            fullUrl += "&" + urlEncode(kv.first) + "=" + urlEncode(kv.second);
+        Buffers& b = buffers();
+        std::string& command = b.command;
+        command.assign(prefixes[endpoint.id]);
+        for (size_t i = 0; i < Segments; ++i) {
+            command += '/';
+            appendUrlEncoded(command, refs[i].data, refs[i].size);
         }
+        command.append(keyQuery);
+        for (size_t i = 0; i < Params; ++i) {
+            const ValueRef& v = refs[Segments + i];
+            if (v.size == 0) {
+                continue;
+            }
+            command += '&';
+            command.append(endpoint.params[i]);
+            command += '=';
+            appendUrlEncoded(command, v.data, v.size);
+        }
+        command += '"';
 
-        // Use -s for silent. Remove -k to enforce SSL validation.
-        std::string command = "curl -s \"" + fullUrl + "\"";
-        return exec(command.c_str());
+        b.transfer = Transfer();
+        if (!exec(command.c_str(), b.response, b.transfer.exitCode)) {
+            b.transfer.started = false;
+            return false;
+        }
+        b.transfer.started = true;
+        b.transfer.httpStatus = takeHttpStatus(b.response);
+        return true;
+    }
+
+    const std::string& key() const { return apiKey; }
+    const std::string& url() const { return baseUrl; }
+
+    // Body and status of the last request made on the calling thread
+    static const std::string& response() { return buffers().response; }
+    static const Transfer& transfer() { return buffers().transfer; }
+};
+
+template <typename Json>
+std::string textOf(const Json& j) {
+    const auto& text = j.template get_ref<const typename Json::string_t&>();
+    return std::string(text.data(), text.size());
+}
+
+// Classifies the last transfer on this thread without throwing. Json is nlohmann::json
+// or ArenaJson; for ArenaJson the caller holds a JsonArena::Scope.
+template <typename Json = nlohmann::json>
+Result<Json> toResult(const Transfer& transfer, const std::string& body) {
+    if (!transfer.started) {
+        return RequestError{ErrorCode::Transport, -1, "Failed to run curl command."};
+    }
+    if (transfer.httpStatus == 0) {
+        return RequestError{ErrorCode::Transport, transfer.exitCode,
+                            "Request failed (curl exit code " + std::to_string(transfer.exitCode) + ")."};
+    }
+
+    Json j = Json::parse(body, nullptr, false);
+    if (transfer.httpStatus >= 400) {
+        std::string message = "HTTP " + std::to_string(transfer.httpStatus);
+        if (!j.is_discarded() && j.is_object()) {
+            auto it = j.find("message");
+            if (it != j.end() && it->is_string()) {
+                message += ": " + textOf(*it);
+            }
+        }
+        return RequestError{ErrorCode::HttpStatus, transfer.httpStatus, message};
+    }
+    if (j.is_discarded()) {
+        return RequestError{ErrorCode::Parse, transfer.httpStatus, "Response is not valid JSON."};
+    }
+    if (j.is_object()) {
+        // API level errors: {"error": 400, "message": "..."} or {"errors": {"code": .., "message": ..}}
+        const Json* detail = nullptr;
+        auto it = j.find("error");
+        if (it == j.end()) it = j.find("errors");
+        if (it != j.end()) {
+            detail = it->is_object() ? &*it : &j;
+            int code = 0;
+            if (it->is_number_integer()) code = it->template get<int>();
+            auto codeIt = detail->find("code");
+            if (codeIt != detail->end() && codeIt->is_number_integer()) code = codeIt->template get<int>();
+            std::string message = "API error";
+            auto msgIt = detail->find("message");
+            if (msgIt != detail->end() && msgIt->is_string()) message = textOf(*msgIt);
+            return RequestError{ErrorCode::ApiError, code, message};
+        }
+    }
+    return j;
+}
+
+RequestError cancelledError() {
+    return RequestError{ErrorCode::Cancelled, 0, "Request cancelled."};
+}
+
+// KEY POOL
+// The API keys in use, one Client each. Like Client, the key list is immutable once
+// published; only the per-key usage counters and rate limiter state change, all of
+// them atomics, so concurrent requests choose and account keys without locks.
+class KeyPool {
+private:
+    using Nanos = int64_t;
+
+    // Usage and rate limiter state of one key. Shared with the pool that replaces
+    // this one when only the base URL changes, so quota and cooldowns carry over.
+    struct State {
+        std::atomic<Nanos> tat{0};       // GCRA theoretical arrival time
+        std::atomic<Nanos> coolUntil{0}; // avoided until then after a 429
+        std::atomic<uint64_t> used{0};   // quota consumed
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> succeeded{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> rateLimited{0};
+        std::atomic<uint64_t> failovers{0};
+        std::atomic<Nanos> throttled{0};
+        std::atomic<unsigned> inFlight{0};
+    };
+
+    struct Key {
+        Client client;
+        ApiKey options;
+        Nanos interval;  // between requests at the rate limit; 0 = no limit
+        Nanos tolerance; // (burst - 1) * interval
+        std::shared_ptr<State> state;
+
+        Key(const ApiKey& key, const std::string& url, std::shared_ptr<State> shared)
+            : client(key.key, url), options(key),
+              interval(key.requestsPerSecond > 0 ? static_cast<Nanos>(1e9 / key.requestsPerSecond) : 0),
+              tolerance(static_cast<Nanos>((std::max(key.burst, 1.0) - 1.0) * static_cast<double>(interval))),
+              state(shared ? std::move(shared) : std::make_shared<State>()) {}
+    };
+
+    std::string baseUrl;
+    std::vector<std::unique_ptr<Key>> keys;
+    CircuitBreaker* breakers; // ENDPOINT_FAMILY_COUNT, owned by TraderMade
+
+    static Nanos now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Takes one unit of quota and one rate limit slot, or neither.
+    static bool reserve(const Key& k, Nanos t) {
+        if (k.options.quota && k.state->used.fetch_add(1, std::memory_order_relaxed) >= k.options.quota) {
+            k.state->used.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (k.interval) {
+            Nanos tat = k.state->tat.load(std::memory_order_relaxed);
+            do {
+                if (tat - k.tolerance > t) {
+                    if (k.options.quota) k.state->used.fetch_sub(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } while (!k.state->tat.compare_exchange_weak(tat, std::max(tat, t) + k.interval, std::memory_order_relaxed));
+        }
+        k.state->requests.fetch_add(1, std::memory_order_relaxed);
+        k.state->inFlight.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Picks the key with the most headroom: keys out of quota are skipped, keys
+    // cooling down after a 429 are used only if nothing else is available, then the
+    // largest share of quota left wins, then the fewest requests in flight. Waits
+    // when every remaining key is at its rate limit.
+    const Key* lease(RequestError& error) const {
+        const Nanos started = now();
+        while (true) {
+            const Nanos t = now();
+            const Key* best = nullptr;
+            bool bestCooling = true;
+            double bestHeadroom = -1.0;
+            unsigned bestInFlight = 0;
+            Nanos earliest = std::numeric_limits<Nanos>::max();
+            bool anyQuota = false;
+
+            for (const auto& p : keys) {
+                const Key& k = *p;
+                uint64_t used = k.state->used.load(std::memory_order_relaxed);
+                if (k.options.quota && used >= k.options.quota) continue;
+                anyQuota = true;
+                Nanos ready = k.interval ? k.state->tat.load(std::memory_order_relaxed) - k.tolerance : 0;
+                if (ready > t) {
+                    earliest = std::min(earliest, ready);
+                    continue;
+                }
+                bool cooling = k.state->coolUntil.load(std::memory_order_relaxed) > t;
+                double headroom = k.options.quota
+                    ? static_cast<double>(k.options.quota - used) / static_cast<double>(k.options.quota) : 1.0;
+                unsigned inFlight = k.state->inFlight.load(std::memory_order_relaxed);
+                if (!best || (bestCooling && !cooling) ||
+                    (bestCooling == cooling && (headroom > bestHeadroom ||
+                                                (headroom == bestHeadroom && inFlight < bestInFlight)))) {
+                    best = &k;
+                    bestCooling = cooling;
+                    bestHeadroom = headroom;
+                    bestInFlight = inFlight;
+                }
+            }
+
+            if (!anyQuota) {
+                error = RequestError{ErrorCode::QuotaExhausted, 0, "All API keys have used their quota."};
+                return nullptr;
+            }
+            if (!best) {
+                const CancellationToken* token = CancellationScope::current();
+                if (token ? token->waitFor(std::chrono::nanoseconds(earliest - t))
+                          : (std::this_thread::sleep_for(std::chrono::nanoseconds(earliest - t)), false)) {
+                    error = cancelledError();
+                    return nullptr;
+                }
+                continue;
+            }
+            if (reserve(*best, t)) {
+                best->state->throttled.fetch_add(t - started, std::memory_order_relaxed);
+                return best;
+            }
+        }
+    }
+
+    // Accounts a finished request. Returns true if it got a 429 and should be
+    // retried on another key.
+    bool finish(const Key& k, const Transfer& transfer, size_t attempt) const {
+        k.state->inFlight.fetch_sub(1, std::memory_order_relaxed);
+        int status = transfer.started ? transfer.httpStatus : 0;
+        (status >= 200 && status < 400 ? k.state->succeeded : k.state->failed).fetch_add(1, std::memory_order_relaxed);
+        if (status != 429) {
+            return false;
+        }
+        k.state->rateLimited.fetch_add(1, std::memory_order_relaxed);
+        k.state->coolUntil.store(now() + std::chrono::duration_cast<std::chrono::nanoseconds>(k.options.cooldown).count(),
+                          std::memory_order_relaxed);
+        if (attempt + 1 >= keys.size()) {
+            return false;
+        }
+        k.state->failovers.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Runs the request on the best key (failing over on HTTP 429) through the
+    // endpoint family's circuit breaker. Returns false with error set if nothing was
+    // sent; otherwise the outcome is in Client::transfer() and Client::response().
+    template <std::size_t Segments, std::size_t Params, typename... Values>
+    bool send(RequestError& error, const Endpoints::Endpoint<Segments, Params>& endpoint,
+              const Values&... values) const {
+        const EndpointFamily family = Endpoints::FAMILIES[endpoint.id];
+        CircuitBreaker& breaker = breakers[static_cast<size_t>(family)];
+        const CancellationToken* token = CancellationScope::current();
+        if (token && token->cancelled()) {
+            error = cancelledError();
+            return false;
+        }
+        const CircuitBreaker::Admission admission = breaker.admit();
+        if (admission == CircuitBreaker::Admission::Rejected) {
+            error = RequestError{ErrorCode::CircuitOpen, 0,
+                                 std::string("Circuit open for ") + toString(family) + " endpoints."};
+            return false;
+        }
+        Nanos started = 0; // after the first lease: waiting for a rate limit slot is not latency
+        for (size_t attempt = 0;; ++attempt) {
+            const Key* k = lease(error);
+            if (!k && attempt > 0) {
+                break; // no key left to fail over to: report the 429 already received
+            }
+            if (!k) {
+                breaker.record(admission, CircuitBreaker::Outcome::NotSent, std::chrono::nanoseconds(0));
+                return false;
+            }
+            if (attempt == 0) started = now();
+            k->client.fetch(endpoint, values...);
+            if (token && token->cancelled()) {
+                finish(*k, Client::transfer(), keys.size()); // accounting only, no failover
+                breaker.record(admission, CircuitBreaker::Outcome::NotSent, std::chrono::nanoseconds(0));
+                error = cancelledError();
+                return false;
+            }
+            if (!finish(*k, Client::transfer(), attempt)) break;
+        }
+        const Transfer& transfer = Client::transfer();
+        bool failed = !transfer.started || transfer.httpStatus == 0 || transfer.httpStatus >= 500;
+        breaker.record(admission, failed ? CircuitBreaker::Outcome::Failure : CircuitBreaker::Outcome::Success,
+                       std::chrono::nanoseconds(now() - started));
+        return true;
+    }
+
+public:
+    // With `previous` (same keys, other URL), the keys keep its usage and cooldowns.
+    KeyPool(const std::vector<ApiKey>& apiKeys, const std::string& url, CircuitBreaker* breakers,
+            const KeyPool* previous = nullptr)
+        : baseUrl(url), breakers(breakers) {
+        for (size_t i = 0; i < apiKeys.size(); ++i) {
+            std::shared_ptr<State> state = previous && i < previous->keys.size() ? previous->keys[i]->state : nullptr;
+            keys.emplace_back(new Key(apiKeys[i], url, std::move(state)));
+        }
+    }
+
+    bool empty() const { return keys.empty(); }
+    const std::string& url() const { return baseUrl; }
+    std::string firstKey() const { return keys.empty() ? std::string() : keys.front()->client.key(); }
+
+    std::vector<ApiKey> options() const {
+        std::vector<ApiKey> out;
+        for (const auto& k : keys) out.push_back(k->options);
+        return out;
+    }
+
+    // Non-throwing request; see send().
+    template <typename Json = nlohmann::json, std::size_t Segments, std::size_t Params, typename... Values>
+    Result<Json> fetch(const Endpoints::Endpoint<Segments, Params>& endpoint, const Values&... values) const {
+        RequestError error{ErrorCode::NotConfigured, 0, std::string()};
+        if (!send(error, endpoint, values...)) {
+            return error;
+        }
+        return toResult<Json>(Client::transfer(), Client::response());
+    }
+
+    // Throwing variant. The returned reference points at a per-thread buffer that is
+    // overwritten by the next request on the same thread.
+    template <std::size_t Segments, std::size_t Params, typename... Values>
+    const std::string& get(const Endpoints::Endpoint<Segments, Params>& endpoint, const Values&... values) const {
+        RequestError error{ErrorCode::NotConfigured, 0, std::string()};
+        if (!send(error, endpoint, values...)) {
+            if (error.code == ErrorCode::Cancelled) {
+                throw OperationCancelled(error.message);
+            }
+            throw std::runtime_error(error.message);
+        }
+        if (!Client::transfer().started) {
+            throw std::runtime_error("Failed to run curl command.");
+        }
+        return Client::response();
+    }
+
+    std::vector<ApiKeyStats> stats() const {
+        std::vector<ApiKeyStats> out;
+        for (const auto& p : keys) {
+            const Key& k = *p;
+            const std::string& key = k.client.key();
+            ApiKeyStats s;
+            s.key = "****" + (key.size() > 4 ? key.substr(key.size() - 4) : std::string());
+            s.requests = k.state->requests.load(std::memory_order_relaxed);
+            s.succeeded = k.state->succeeded.load(std::memory_order_relaxed);
+            s.failed = k.state->failed.load(std::memory_order_relaxed);
+            s.rateLimited = k.state->rateLimited.load(std::memory_order_relaxed);
+            s.failovers = k.state->failovers.load(std::memory_order_relaxed);
+            s.quota = k.options.quota;
+            s.quotaRemaining = k.options.quota ? k.options.quota - std::min(k.options.quota, k.state->used.load()) : 0;
+            s.throttledMs = static_cast<double>(k.state->throttled.load(std::memory_order_relaxed)) / 1e6;
+            s.inFlight = k.state->inFlight.load(std::memory_order_relaxed);
+            out.push_back(s);
+        }
+        return out;
+    }
+};
+
+template <typename Json = nlohmann::json, std::size_t Segments, std::size_t Params, typename... Values>
+Result<Json> fetchResult(const KeyPool& pool, const Endpoints::Endpoint<Segments, Params>& endpoint,
+                         const Values&... values) {
+    if (pool.empty()) {
+        return RequestError{ErrorCode::NotConfigured, 0, "API key not set. Call setRestApiKey() first."};
+    }
+    return pool.fetch<Json>(endpoint, values...);
+}
+
+// Same, with the document built in arena.
+template <std::size_t Segments, std::size_t Params, typename... Values>
+Result<ArenaJson> fetchResult(JsonArena& arena, const KeyPool& pool,
+                              const Endpoints::Endpoint<Segments, Params>& endpoint, const Values&... values) {
+    JsonArena::Scope scope(arena);
+    return fetchResult<ArenaJson>(pool, endpoint, values...);
+}
+
+RequestError invalidArgument(std::string message) {
+    return RequestError{ErrorCode::InvalidArgument, 0, std::move(message)};
+}
+
+// Request validation shared by the throwing and try* APIs. Each returns nullptr
+// (or an empty string) when the arguments are valid, otherwise the error message.
+
+const char* checkLiveRates(const std::string& currency) {
+    return currency.empty() ? "currency is required." : nullptr;
+}
+
+const char* checkHistorical(const std::string& date, const std::string& symbol) {
+    return date.empty() || symbol.empty() ? "date and symbol are required." : nullptr;
+}
+
+const char* checkIntraday(const std::string& date_time, const std::string& symbol) {
+    return date_time.empty() || symbol.empty() ? "date_time and symbol are required." : nullptr;
+}
+
+const char* checkTick(const std::string& symbol, const std::string& startDate, const std::string& endDate) {
+    return symbol.empty() || startDate.empty() || endDate.empty()
+        ? "symbol, startDate and endDate are required." : nullptr;
+}
+
+const char* checkTickSample(const std::string& symbol, const std::string& startDate,
+                            const std::string& endDate, const std::string& format) {
+    return symbol.empty() || startDate.empty() || endDate.empty() || format.empty()
+        ? "symbol, startDate, endDate and format are required." : nullptr;
+}
+
+std::string checkTimeSeries(const std::string& format, const std::string& interval, const std::string& period,
+                            TimeSeriesFormat& formatValue, TimeSeriesInterval& intervalValue, int& periodNum) {
+    // Validate format
+    if (!parseApiString(format, Constants::TIME_SERIES_FORMAT, formatValue)) {
+        return "Invalid format. Use one of: records,csv,index,columns,split.";
+    }
+
+    // Validate interval
+    if (!parseApiString(interval, Constants::TIME_SERIES_INTERVAL, intervalValue)) {
+        return "Invalid interval. Use one of: daily,hourly,minute.";
     }
+
+    // Validate period
+    char* end = nullptr;
+    long parsed = std::strtol(period.c_str(), &end, 10);
+    if (end == period.c_str()) {
+        return "period must be numeric.";
+    }
+    periodNum = static_cast<int>(parsed);
+
+    if (!isValidTimeSeriesPeriod(intervalValue, periodNum)) {
+        std::ostringstream oss;
+        oss << "Invalid period for interval " << interval << ". Valid values: ";
+        bool first = true;
+        for (int p : Constants::TIME_SERIES_PERIOD) {
+            if (!isValidTimeSeriesPeriod(intervalValue, p)) continue;
+            if (!first) oss << ", ";
+            oss << p;
+            first = false;
+        }
+        return oss.str();
+    }
+    return std::string();
+}
+
+const char* checkPandas(const std::string& format, const std::string& fields,
+                        PandasFormat& formatValue, PandasFields& fieldsValue) {
+    if (!parseApiString(format, Constants::DATA_EXPORTS_PANDAS_DF_FORMAT, formatValue)) {
+        return "Invalid format for pandasDF.";
+    }
+    if (!parseApiString(fields, Constants::DATA_EXPORTS_PANDAS_DF_FIELDS, fieldsValue)) {
+        return "Invalid fields for pandasDF.";
+    }
+    return nullptr;
+}
+
+namespace {
+
+// Versions of published KeyPools, unique across TraderMade instances.
+std::atomic<uint64_t> poolVersions{0};
+
+// The KeyPools the calling thread used last, by version. Entries are only replaced
+// when no PoolRef is alive on the thread, so a pool an enclosing call is using is
+// never freed under it.
+struct PoolCache {
+    struct Entry {
+        uint64_t version = 0;
+        std::shared_ptr<const KeyPool> pool;
+    };
+    std::array<Entry, 4> entries;
+    size_t next = 0;
+    unsigned depth = 0; // PoolRefs alive on this thread
+};
+
+thread_local PoolCache poolCache;
+
+} // namespace
+
+class TraderMade::PoolRef {
+public:
+    PoolRef(const KeyPool* pool, std::shared_ptr<const KeyPool> owner) : p(pool), owner(std::move(owner)) {
+        ++poolCache.depth;
+    }
+    PoolRef(PoolRef&& other) noexcept : p(other.p), owner(std::move(other.owner)), pinned(other.pinned) {
+        other.pinned = false;
+    }
+    PoolRef(const PoolRef&) = delete;
+    PoolRef& operator=(const PoolRef&) = delete;
+    ~PoolRef() {
+        if (pinned) --poolCache.depth;
+    }
+
+    const KeyPool& operator*() const { return *p; }
+    const KeyPool* operator->() const { return p; }
+
+private:
+    const KeyPool* p;
+    std::shared_ptr<const KeyPool> owner; // set when the pool is not in the thread's cache
+    bool pinned = true;
 };
 
 // TRADERMADE CLASS IMPLEMENTATION
 
-TraderMade::TraderMade() = default;
-TraderMade::~TraderMade() = default; // Defined here where Client is fully known
+TraderMade::TraderMade() {
+    publish(std::vector<ApiKey>(), Constants::DEFAULT_BASE_URL);
+}
+
+TraderMade::~TraderMade() = default; // Defined here where KeyPool is fully known
 
 void TraderMade::validateApiKey(const std::string& key) {
     std::string t = trim(key);
@@ -131,20 +908,112 @@ void TraderMade::validateApiKey(const std::string& key) {
     }
 }
 
-void TraderMade::ensureClient() const {
-    if (!client) {
+// Builds an immutable KeyPool and makes it current. Calls already running keep the
+// one they loaded alive until they return.
+void TraderMade::publish(const std::vector<ApiKey>& keys, const std::string& url, const KeyPool* previous) {
+    std::atomic_store(&pool, std::make_shared<const KeyPool>(keys, url, breakers.data(), previous));
+    poolVersion.store(poolVersions.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// One acquire load while the thread's cache holds the current version. On a miss
+// the pool is loaded under the shared_ptr atomics' lock and cached for later calls.
+TraderMade::PoolRef TraderMade::currentPool() const {
+    const uint64_t version = poolVersion.load(std::memory_order_acquire);
+    PoolCache& cache = poolCache;
+    for (const PoolCache::Entry& e : cache.entries) {
+        if (e.version == version) {
+            return PoolRef(e.pool.get(), nullptr);
+        }
+    }
+    std::shared_ptr<const KeyPool> loaded = std::atomic_load(&pool);
+    const KeyPool* raw = loaded.get();
+    if (cache.depth > 0) {
+        return PoolRef(raw, std::move(loaded)); // an enclosing call may use any entry
+    }
+    PoolCache::Entry& slot = cache.entries[cache.next++ % cache.entries.size()];
+    slot.version = version;
+    slot.pool = std::move(loaded); // frees the evicted pool if no other thread has it
+    return PoolRef(raw, nullptr);
+}
+
+TraderMade::PoolRef TraderMade::ensureClient() const {
+    PoolRef p = currentPool();
+    if (p->empty()) {
         throw std::runtime_error("API key not set. Call setRestApiKey() first.");
     }
+    return p;
 }
 
 void TraderMade::setRestApiKey(const std::string& key) {
     validateApiKey(key);
-    this->apiKey = trim(key);
-    this->client = std::make_unique<Client>(this->apiKey);
+    ApiKey only;
+    only.key = trim(key);
+    std::lock_guard<std::mutex> lock(configMutex);
+    publish({only}, currentPool()->url());
+}
+
+void TraderMade::setRestApiKeys(const std::vector<ApiKey>& keys) {
+    if (keys.empty()) {
+        throw std::invalid_argument("At least one API key is required.");
+    }
+    std::vector<ApiKey> checked = keys;
+    for (ApiKey& k : checked) {
+        validateApiKey(k.key);
+        k.key = trim(k.key);
+        if (k.requestsPerSecond < 0 || k.burst < 1 || k.cooldown.count() < 0) {
+            throw std::invalid_argument("Invalid rate limit for API key.");
+        }
+    }
+    std::lock_guard<std::mutex> lock(configMutex);
+    publish(checked, currentPool()->url());
 }
 
 std::string TraderMade::getRestApiKey() const {
-    return this->apiKey;
+    return currentPool()->firstKey();
+}
+
+std::vector<ApiKeyStats> TraderMade::getApiKeyStats() const {
+    return currentPool()->stats();
+}
+
+void TraderMade::setBaseUrl(const std::string& url) {
+    std::string t = trim(url);
+    if (t.empty()) {
+        throw std::invalid_argument("Base url must be a non empty string.");
+    }
+    while (!t.empty() && t.back() == '/') {
+        t.pop_back();
+    }
+    if (!isSafeBaseUrl(t)) {
+        throw std::invalid_argument("Base url must be http[s]://host[:port][/path] (letters, digits and -._~ only).");
+    }
+    std::lock_guard<std::mutex> lock(configMutex);
+    const PoolRef current = currentPool();
+    publish(current->options(), t, &*current); // same keys: quota and cooldowns carry over
+}
+
+std::string TraderMade::getBaseUrl() const {
+    return currentPool()->url();
+}
+
+void TraderMade::setCircuitBreaker(const CircuitBreakerOptions& options) {
+    for (CircuitBreaker& b : breakers) {
+        b.configure(options);
+    }
+}
+
+void TraderMade::setCircuitBreaker(EndpointFamily family, const CircuitBreakerOptions& options) {
+    breakers[static_cast<size_t>(family)].configure(options);
+}
+
+std::vector<CircuitBreakerStats> TraderMade::getCircuitBreakerStats() const {
+    std::vector<CircuitBreakerStats> out;
+    for (size_t i = 0; i < breakers.size(); ++i) {
+        CircuitBreakerStats s = breakers[i].stats();
+        s.family = static_cast<EndpointFamily>(i);
+        out.push_back(s);
+    }
+    return out;
 }
 
 // --- CHANGED FUNCTIONS START HERE ---
@@ -152,98 +1021,86 @@ std::string TraderMade::getRestApiKey() const {
 // All return statements wrapped in nlohmann::json::parse()
 
 nlohmann::json TraderMade::getLiveRates(const std::string& currency) {
-    ensureClient();
-    if (currency.empty()) {
-        throw std::invalid_argument("currency is required.");
+    return nlohmann::json::parse(getLiveRatesRaw(currency));
+}
+
+const std::string& TraderMade::getLiveRatesRaw(const std::string& currency) {
+    const PoolRef c = ensureClient();
+    if (const char* error = checkLiveRates(currency)) {
+        throw std::invalid_argument(error);
     }
-    return nlohmann::json::parse(client->get("/live", {{"currency", currency}}));
+    return c->get(Endpoints::LIVE, currency);
 }
 
 nlohmann::json TraderMade::getLiveCurrencyList() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/live_currencies_list"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::LIVE_CURRENCIES_LIST));
 }
 
 nlohmann::json TraderMade::getStreamingCurrencyList() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/streaming_currencies_list"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::STREAMING_CURRENCIES_LIST));
 }
 
 nlohmann::json TraderMade::getCryptoList() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/live_crypto_list"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::LIVE_CRYPTO_LIST));
 }
 
 nlohmann::json TraderMade::getHistoricalCurrencyList() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/historical_currencies_list"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::HISTORICAL_CURRENCIES_LIST));
 }
 
 nlohmann::json TraderMade::getCfdList() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/cfd_list"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::CFD_LIST));
 }
 
 nlohmann::json TraderMade::getHistoricalRates(const std::string& date, const std::string& symbol) {
-    ensureClient();
-    if (date.empty() || symbol.empty()) {
-        throw std::invalid_argument("date and symbol are required.");
+    const PoolRef c = ensureClient();
+    if (const char* error = checkHistorical(date, symbol)) {
+        throw std::invalid_argument(error);
     }
-    return nlohmann::json::parse(client->get("/historical", {{"currency", symbol}, {"date", date}}));
+    return nlohmann::json::parse(c->get(Endpoints::HISTORICAL, symbol, date));
 }
 
 nlohmann::json TraderMade::getHourlyHistoricalData(const std::string& date_time, const std::string& symbol) {
-    ensureClient();
-    if (date_time.empty() || symbol.empty()) {
-        throw std::invalid_argument("date_time and symbol are required.");
+    const PoolRef c = ensureClient();
+    if (const char* error = checkIntraday(date_time, symbol)) {
+        throw std::invalid_argument(error);
     }
-    return nlohmann::json::parse(client->get("/hour_historical", {
-        {"date_time", date_time},
-        {"currency",  symbol}
-    }));
+    return nlohmann::json::parse(c->get(Endpoints::HOUR_HISTORICAL, date_time, symbol));
 }
 
 nlohmann::json TraderMade::getMinuteHistoricalData(const std::string& date_time, const std::string& symbol) {
-    ensureClient();
-    if (date_time.empty() || symbol.empty()) {
-        throw std::invalid_argument("date_time and symbol are required.");
+    const PoolRef c = ensureClient();
+    if (const char* error = checkIntraday(date_time, symbol)) {
+        throw std::invalid_argument(error);
     }
-    return nlohmann::json::parse(client->get("/minute_historical", {
-        {"date_time", date_time},
-        {"currency",  symbol}
-    }));
+    return nlohmann::json::parse(c->get(Endpoints::MINUTE_HISTORICAL, date_time, symbol));
 }
 
 nlohmann::json TraderMade::getTickHistoricalData(const std::string& symbol,
                                                  const std::string& startDate,
                                                  const std::string& endDate,
                                                  const std::string& format) {
-    ensureClient();
-    if (symbol.empty() || startDate.empty() || endDate.empty()) {
-        throw std::invalid_argument("symbol, startDate and endDate are required.");
+    const PoolRef c = ensureClient();
+    if (const char* error = checkTick(symbol, startDate, endDate)) {
+        throw std::invalid_argument(error);
     }
-    std::string start = urlEncode(startDate);
-    std::string end   = urlEncode(endDate);
-    std::string endpoint = "/tick_historical/" + symbol + "/" + start + "/" + end;
-    std::map<std::string, std::string> params;
-    if (!format.empty()) {
-        params["format"] = format;
-    }
-    return nlohmann::json::parse(client->get(endpoint, params));
+    return nlohmann::json::parse(c->get(Endpoints::TICK_HISTORICAL, symbol, startDate, endDate, format));
 }
 
 nlohmann::json TraderMade::getTickHistoricalDataSample(const std::string& symbol,
                                                        const std::string& startDate,
                                                        const std::string& endDate,
                                                        const std::string& format) {
-    ensureClient();
-    if (symbol.empty() || startDate.empty() || endDate.empty() || format.empty()) {
-        throw std::invalid_argument("symbol, startDate, endDate and format are required.");
+    const PoolRef c = ensureClient();
+    if (const char* error = checkTickSample(symbol, startDate, endDate, format)) {
+        throw std::invalid_argument(error);
     }
-    std::string start = urlEncode(startDate);
-    std::string end   = urlEncode(endDate);
-    std::string endpoint = "/tick_historical_sample/" + symbol + "/" + start + "/" + end;
-    return nlohmann::json::parse(client->get(endpoint, {{"format", format}}));
+    return nlohmann::json::parse(c->get(Endpoints::TICK_HISTORICAL_SAMPLE, symbol, startDate, endDate, format));
 }
 
 nlohmann::json TraderMade::getTimeSeriesData(const std::string& currency,
@@ -254,73 +1111,45 @@ nlohmann::json TraderMade::getTimeSeriesData(const std::string& currency,
                                              const std::string& format) {
     ensureClient();
 
-    // Validate format
-    if (std::find(Constants::TIME_SERIES_FORMAT.begin(),
-                  Constants::TIME_SERIES_FORMAT.end(),
-                  format) == Constants::TIME_SERIES_FORMAT.end()) {
-        throw std::invalid_argument("Invalid format. Use one of: records,csv,index,columns,split.");
-    }
-
-    // Validate interval
-    if (std::find(Constants::TIME_SERIES_INTERVAL.begin(),
-                  Constants::TIME_SERIES_INTERVAL.end(),
-                  interval) == Constants::TIME_SERIES_INTERVAL.end()) {
-        throw std::invalid_argument("Invalid interval. Use one of: daily,hourly,minute.");
-    }
-
-    // Validate period
+    TimeSeriesFormat formatValue;
+    TimeSeriesInterval intervalValue;
     int periodNum = 0;
-    try {
-        periodNum = std::stoi(period);
-    } catch (...) {
-        throw std::invalid_argument("period must be numeric.");
+    std::string error = checkTimeSeries(format, interval, period, formatValue, intervalValue, periodNum);
+    if (!error.empty()) {
+        throw std::invalid_argument(error);
     }
 
-    auto it = Constants::TIME_SERIES_PERIOD.find(interval);
-    if (it == Constants::TIME_SERIES_PERIOD.end()) {
-        throw std::invalid_argument("No valid periods defined for interval: " + interval);
-    }
-
-    const auto& validPeriods = it->second;
-    if (std::find(validPeriods.begin(), validPeriods.end(), periodNum) == validPeriods.end()) {
-        std::ostringstream oss;
-        oss << "Invalid period for interval " << interval << ". Valid values: ";
-        for (size_t i = 0; i < validPeriods.size(); ++i) {
-            oss << validPeriods[i];
-            if (i + 1 < validPeriods.size()) oss << ", ";
-        }
-        throw std::invalid_argument(oss.str());
-    }
+    return fetchTimeSeries(currency, startDate, endDate, intervalValue, periodNum, formatValue);
+}
 
-    return nlohmann::json::parse(client->get("/timeseries", {
-        {"currency",   currency},
-        {"start_date", startDate},
-        {"end_date",   endDate},
-        {"interval",   interval},
-        {"period",     std::to_string(periodNum)},
-        {"format",     format}
-    }));
+nlohmann::json TraderMade::fetchTimeSeries(const std::string& currency,
+                                           const std::string& startDate,
+                                           const std::string& endDate,
+                                           TimeSeriesInterval interval,
+                                           int period,
+                                           TimeSeriesFormat format) {
+    const PoolRef c = ensureClient();
+    char periodText[16];
+    std::snprintf(periodText, sizeof(periodText), "%d", period);
+    return nlohmann::json::parse(c->get(Endpoints::TIMESERIES, currency, startDate, endDate,
+                                       toApiString(interval), periodText, toApiString(format)));
 }
 
 nlohmann::json TraderMade::getOpenMarketStatus() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/market_open_status"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::MARKET_OPEN_STATUS));
 }
 
 nlohmann::json TraderMade::getMarketOpenTiming() {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/market_opening_times"));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::MARKET_OPENING_TIMES));
 }
 
 nlohmann::json TraderMade::getCurrencyConversion(const std::string& from,
                                                  const std::string& to,
                                                  double amount) {
-    ensureClient();
-    return nlohmann::json::parse(client->get("/convert", {
-        {"from",   from},
-        {"to",     to},
-        {"amount", std::to_string(amount)}
-    }));
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::CONVERT, from, to, std::to_string(amount)));
 }
 
 nlohmann::json TraderMade::getDataAsPandasDataFrame(const std::string& symbol,
@@ -330,23 +1159,189 @@ nlohmann::json TraderMade::getDataAsPandasDataFrame(const std::string& symbol,
                                                     const std::string& fields) {
     ensureClient();
 
-    if (std::find(Constants::DATA_EXPORTS_PANDAS_DF_FORMAT.begin(),
-                  Constants::DATA_EXPORTS_PANDAS_DF_FORMAT.end(),
-                  format) == Constants::DATA_EXPORTS_PANDAS_DF_FORMAT.end()) {
-        throw std::invalid_argument("Invalid format for pandasDF.");
+    PandasFormat formatValue;
+    PandasFields fieldsValue;
+    if (const char* error = checkPandas(format, fields, formatValue, fieldsValue)) {
+        throw std::invalid_argument(error);
+    }
+
+    return getDataAsPandasDataFrame(symbol, startDate, endDate, formatValue, fieldsValue);
+}
+
+nlohmann::json TraderMade::getDataAsPandasDataFrame(const std::string& symbol,
+                                                    const std::string& startDate,
+                                                    const std::string& endDate,
+                                                    PandasFormat format,
+                                                    PandasFields fields) {
+    const PoolRef c = ensureClient();
+    return nlohmann::json::parse(c->get(Endpoints::PANDAS_DF, symbol, startDate, endDate,
+                                       toApiString(format), toApiString(fields)));
+}
+
+// --- NON-THROWING API ---
+// Same requests as above; every failure is returned as a RequestError.
+
+Result<nlohmann::json> TraderMade::tryGetLiveRates(const std::string& currency) {
+    if (const char* error = checkLiveRates(currency)) {
+        return invalidArgument(error);
     }
+    return fetchResult(*currentPool(), Endpoints::LIVE, currency);
+}
 
-    if (std::find(Constants::DATA_EXPORTS_PANDAS_DF_FIELDS.begin(),
-                  Constants::DATA_EXPORTS_PANDAS_DF_FIELDS.end(),
-                  fields) == Constants::DATA_EXPORTS_PANDAS_DF_FIELDS.end()) {
-        throw std::invalid_argument("Invalid fields for pandasDF.");
+Result<nlohmann::json> TraderMade::tryGetLiveCurrencyList() {
+    return fetchResult(*currentPool(), Endpoints::LIVE_CURRENCIES_LIST);
+}
+
+Result<nlohmann::json> TraderMade::tryGetStreamingCurrencyList() {
+    return fetchResult(*currentPool(), Endpoints::STREAMING_CURRENCIES_LIST);
+}
+
+Result<nlohmann::json> TraderMade::tryGetCryptoList() {
+    return fetchResult(*currentPool(), Endpoints::LIVE_CRYPTO_LIST);
+}
+
+Result<nlohmann::json> TraderMade::tryGetHistoricalCurrencyList() {
+    return fetchResult(*currentPool(), Endpoints::HISTORICAL_CURRENCIES_LIST);
+}
+
+Result<nlohmann::json> TraderMade::tryGetCfdList() {
+    return fetchResult(*currentPool(), Endpoints::CFD_LIST);
+}
+
+Result<nlohmann::json> TraderMade::tryGetHistoricalRates(const std::string& date, const std::string& symbol) {
+    if (const char* error = checkHistorical(date, symbol)) {
+        return invalidArgument(error);
     }
+    return fetchResult(*currentPool(), Endpoints::HISTORICAL, symbol, date);
+}
 
-    return nlohmann::json::parse(client->get("/pandasDF", {
-        {"currency",   symbol},
-        {"start_date", startDate},
-        {"end_date",   endDate},
-        {"format",     format},
-        {"fields",     fields}
-    }));
-}
\ No newline at end of file
+Result<nlohmann::json> TraderMade::tryGetHourlyHistoricalData(const std::string& date_time,
+                                                              const std::string& symbol) {
+    if (const char* error = checkIntraday(date_time, symbol)) {
+        return invalidArgument(error);
+    }
+    return fetchResult(*currentPool(), Endpoints::HOUR_HISTORICAL, date_time, symbol);
+}
+
+Result<nlohmann::json> TraderMade::tryGetMinuteHistoricalData(const std::string& date_time,
+                                                              const std::string& symbol) {
+    if (const char* error = checkIntraday(date_time, symbol)) {
+        return invalidArgument(error);
+    }
+    return fetchResult(*currentPool(), Endpoints::MINUTE_HISTORICAL, date_time, symbol);
+}
+
+Result<nlohmann::json> TraderMade::tryGetTickHistoricalData(const std::string& symbol,
+                                                            const std::string& startDate,
+                                                            const std::string& endDate,
+                                                            const std::string& format) {
+    if (const char* error = checkTick(symbol, startDate, endDate)) {
+        return invalidArgument(error);
+    }
+    return fetchResult(*currentPool(), Endpoints::TICK_HISTORICAL, symbol, startDate, endDate, format);
+}
+
+Result<ArenaJson> TraderMade::tryGetTickHistoricalData(JsonArena& arena,
+                                                       const std::string& symbol,
+                                                       const std::string& startDate,
+                                                       const std::string& endDate,
+                                                       const std::string& format) {
+    if (const char* error = checkTick(symbol, startDate, endDate)) {
+        return invalidArgument(error);
+    }
+    return fetchResult(arena, *currentPool(), Endpoints::TICK_HISTORICAL, symbol, startDate, endDate, format);
+}
+
+Result<nlohmann::json> TraderMade::tryGetTickHistoricalDataSample(const std::string& symbol,
+                                                                  const std::string& startDate,
+                                                                  const std::string& endDate,
+                                                                  const std::string& format) {
+    if (const char* error = checkTickSample(symbol, startDate, endDate, format)) {
+        return invalidArgument(error);
+    }
+    return fetchResult(*currentPool(), Endpoints::TICK_HISTORICAL_SAMPLE, symbol, startDate, endDate, format);
+}
+
+Result<nlohmann::json> TraderMade::tryGetTimeSeriesData(const std::string& currency,
+                                                        const std::string& startDate,
+                                                        const std::string& endDate,
+                                                        const std::string& interval,
+                                                        const std::string& period,
+                                                        const std::string& format) {
+    TimeSeriesFormat formatValue;
+    TimeSeriesInterval intervalValue;
+    int periodNum = 0;
+    std::string error = checkTimeSeries(format, interval, period, formatValue, intervalValue, periodNum);
+    if (!error.empty()) {
+        return invalidArgument(error);
+    }
+    return tryFetchTimeSeries(currency, startDate, endDate, intervalValue, periodNum, formatValue);
+}
+
+Result<ArenaJson> TraderMade::tryGetTimeSeriesData(JsonArena& arena,
+                                                   const std::string& currency,
+                                                   const std::string& startDate,
+                                                   const std::string& endDate,
+                                                   const std::string& interval,
+                                                   const std::string& period,
+                                                   const std::string& format) {
+    TimeSeriesFormat formatValue;
+    TimeSeriesInterval intervalValue;
+    int periodNum = 0;
+    std::string error = checkTimeSeries(format, interval, period, formatValue, intervalValue, periodNum);
+    if (!error.empty()) {
+        return invalidArgument(error);
+    }
+    char periodText[16];
+    std::snprintf(periodText, sizeof(periodText), "%d", periodNum);
+    return fetchResult(arena, *currentPool(), Endpoints::TIMESERIES, currency, startDate, endDate,
+                       toApiString(intervalValue), periodText, toApiString(formatValue));
+}
+
+Result<nlohmann::json> TraderMade::tryFetchTimeSeries(const std::string& currency,
+                                                      const std::string& startDate,
+                                                      const std::string& endDate,
+                                                      TimeSeriesInterval interval,
+                                                      int period,
+                                                      TimeSeriesFormat format) {
+    char periodText[16];
+    std::snprintf(periodText, sizeof(periodText), "%d", period);
+    return fetchResult(*currentPool(), Endpoints::TIMESERIES, currency, startDate, endDate,
+                       toApiString(interval), periodText, toApiString(format));
+}
+
+Result<nlohmann::json> TraderMade::tryGetOpenMarketStatus() {
+    return fetchResult(*currentPool(), Endpoints::MARKET_OPEN_STATUS);
+}
+
+Result<nlohmann::json> TraderMade::tryGetMarketOpenTiming() {
+    return fetchResult(*currentPool(), Endpoints::MARKET_OPENING_TIMES);
+}
+
+Result<nlohmann::json> TraderMade::tryGetCurrencyConversion(const std::string& from,
+                                                            const std::string& to,
+                                                            double amount) {
+    return fetchResult(*currentPool(), Endpoints::CONVERT, from, to, std::to_string(amount));
+}
+
+Result<nlohmann::json> TraderMade::tryGetDataAsPandasDataFrame(const std::string& symbol,
+                                                               const std::string& startDate,
+                                                               const std::string& endDate,
+                                                               const std::string& format,
+                                                               const std::string& fields) {
+    PandasFormat formatValue;
+    PandasFields fieldsValue;
+    if (const char* error = checkPandas(format, fields, formatValue, fieldsValue)) {
+        return invalidArgument(error);
+    }
+    return tryGetDataAsPandasDataFrame(symbol, startDate, endDate, formatValue, fieldsValue);
+}
+
+Result<nlohmann::json> TraderMade::tryGetDataAsPandasDataFrame(const std::string& symbol,
+                                                               const std::string& startDate,
+                                                               const std::string& endDate,
+                                                               PandasFormat format,
+                                                               PandasFields fields) {
+    return fetchResult(*currentPool(), Endpoints::PANDAS_DF, symbol, startDate, endDate,
+                       toApiString(format), toApiString(fields));
+}
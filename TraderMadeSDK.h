@@ -4,25 +4,90 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <nlohmann/json.hpp> // <--- NEW: Required for JSON types
+#include "TraderMadeTypes.h"
+#include "TraderMadeResult.h"
+#include "CircuitBreaker.h"
+#include "CancellationToken.h"
+#include "JsonArena.h"
 
-class Client;
+class KeyPool;
+
+// One key of a key pool (setRestApiKeys)
+struct ApiKey {
+    std::string key;
+    uint64_t quota = 0;                       // requests this key may still make; 0 = no limit
+    double requestsPerSecond = 0;             // client-side rate limit; 0 = no limit
+    double burst = 1;                         // requests allowed back to back
+    std::chrono::milliseconds cooldown{1000}; // avoided for this long after an HTTP 429
+};
+
+// Usage of one pool key since the keys were set (getApiKeyStats)
+struct ApiKeyStats {
+    std::string key;             // masked: "****" and the last 4 characters
+    uint64_t requests = 0;       // sent with this key
+    uint64_t succeeded = 0;      // HTTP 2xx/3xx
+    uint64_t failed = 0;         // transport errors and HTTP 4xx/5xx
+    uint64_t rateLimited = 0;    // HTTP 429 responses
+    uint64_t failovers = 0;      // of those, retried on another key
+    uint64_t quota = 0;          // 0 = no limit
+    uint64_t quotaRemaining = 0;
+    double throttledMs = 0;      // total time callers waited for this key's rate limit
+    unsigned inFlight = 0;
+};
 
 class TraderMade {
 public:
     TraderMade();
     ~TraderMade(); 
-    // Set REST API key
+    // Set REST API key. Safe to call while other threads make requests (key
+    // rotation): calls already running finish with the old key, later ones use the
+    // new key, and no caller waits for the swap.
     void setRestApiKey(const std::string& key);
 
-    // Get REST API key
+    // Spread requests over several keys. Each request goes to the key with the most
+    // headroom (see ApiKey): keys out of quota are skipped, a key that got HTTP 429
+    // is avoided for its cooldown and the request is retried once per other key, and
+    // callers wait only when every key is at its rate limit. When all quotas are used
+    // up, requests fail with ErrorCode::QuotaExhausted. setRestApiKey(key) is a pool
+    // of one unlimited key. Replacing the keys resets the counters; changing the base
+    // URL keeps them, along with the remaining quota and 429 cooldowns.
+    void setRestApiKeys(const std::vector<ApiKey>& keys);
+
+    // Get REST API key (the first one of a pool)
     std::string getRestApiKey() const;
 
+    // Per-key usage, in the order the keys were given
+    std::vector<ApiKeyStats> getApiKeyStats() const;
+
+    // Circuit breakers, one per EndpointFamily, disabled by default (see
+    // CircuitBreaker.h). While a family's circuit is open its calls fail fast without
+    // a request: try* calls return ErrorCode::CircuitOpen, the others throw
+    // std::runtime_error. Reconfiguring resets state and counters.
+    void setCircuitBreaker(const CircuitBreakerOptions& options); // every family
+    void setCircuitBreaker(EndpointFamily family, const CircuitBreakerOptions& options);
+    std::vector<CircuitBreakerStats> getCircuitBreakerStats() const; // one per family
+
+    // Override the API base URL (e.g. to point at tradermade_mock_server). Same
+    // thread safety as setRestApiKey. Throws std::invalid_argument unless the URL is
+    // http[s]://host[:port][/path] made of letters, digits and "-._~".
+    void setBaseUrl(const std::string& url);
+    std::string getBaseUrl() const;
+
     // --- RETURN TYPES CHANGED TO nlohmann::json BELOW ---
 
     // 1. Live Rates
     nlohmann::json getLiveRates(const std::string& currency);
 
+    // Raw response text of getLiveRates, without building a JSON document. The
+    // reference points at a per-thread buffer reused by the next call on the same thread.
+    const std::string& getLiveRatesRaw(const std::string& currency);
+
     // 2. Reference Data
     nlohmann::json getLiveCurrencyList();
     nlohmann::json getStreamingCurrencyList();
@@ -54,6 +119,17 @@ public:
                                      const std::string& period,
                                      const std::string& format);
 
+    // Typed variant: an invalid interval/period pair is a compile error, e.g.
+    //   tm.getTimeSeriesData<TimeSeriesInterval::Hourly, 4>("EURUSD", "2026-01-08", "2026-01-10");
+    template <TimeSeriesInterval Interval, int Period>
+    nlohmann::json getTimeSeriesData(const std::string& currency,
+                                     const std::string& startDate,
+                                     const std::string& endDate,
+                                     TimeSeriesFormat format = TimeSeriesFormat::Records) {
+        static_assert(isValidTimeSeriesPeriod(Interval, Period), "Invalid period for this interval.");
+        return fetchTimeSeries(currency, startDate, endDate, Interval, Period, format);
+    }
+
     // 6. Market Status
     nlohmann::json getOpenMarketStatus();
     nlohmann::json getMarketOpenTiming();
@@ -70,12 +146,121 @@ public:
                                             const std::string& format,
                                             const std::string& fields);
 
+    nlohmann::json getDataAsPandasDataFrame(const std::string& symbol,
+                                            const std::string& startDate,
+                                            const std::string& endDate,
+                                            PandasFormat format,
+                                            PandasFields fields);
+
+    // --- Non-throwing API ---
+    // Same requests as above, but validation, transport, HTTP status, API error body
+    // and JSON parse failures are returned as a RequestError instead of being thrown.
+
+    Result<nlohmann::json> tryGetLiveRates(const std::string& currency);
+
+    Result<nlohmann::json> tryGetLiveCurrencyList();
+    Result<nlohmann::json> tryGetStreamingCurrencyList();
+    Result<nlohmann::json> tryGetCryptoList();
+    Result<nlohmann::json> tryGetHistoricalCurrencyList();
+    Result<nlohmann::json> tryGetCfdList();
+
+    Result<nlohmann::json> tryGetHistoricalRates(const std::string& date, const std::string& symbol);
+    Result<nlohmann::json> tryGetHourlyHistoricalData(const std::string& date_time, const std::string& symbol);
+    Result<nlohmann::json> tryGetMinuteHistoricalData(const std::string& date_time, const std::string& symbol);
+
+    Result<nlohmann::json> tryGetTickHistoricalData(const std::string& symbol,
+                                                    const std::string& startDate,
+                                                    const std::string& endDate,
+                                                    const std::string& format = "");
+
+    Result<nlohmann::json> tryGetTickHistoricalDataSample(const std::string& symbol,
+                                                          const std::string& startDate,
+                                                          const std::string& endDate,
+                                                          const std::string& format);
+
+    Result<nlohmann::json> tryGetTimeSeriesData(const std::string& currency,
+                                                const std::string& startDate,
+                                                const std::string& endDate,
+                                                const std::string& interval,
+                                                const std::string& period,
+                                                const std::string& format);
+
+    template <TimeSeriesInterval Interval, int Period>
+    Result<nlohmann::json> tryGetTimeSeriesData(const std::string& currency,
+                                                const std::string& startDate,
+                                                const std::string& endDate,
+                                                TimeSeriesFormat format = TimeSeriesFormat::Records) {
+        static_assert(isValidTimeSeriesPeriod(Interval, Period), "Invalid period for this interval.");
+        return tryFetchTimeSeries(currency, startDate, endDate, Interval, Period, format);
+    }
+
+    // Arena variants of the bulk endpoints: the response is parsed into arena (see
+    // JsonArena.h) rather than onto the heap. Destroy the result before arena.reset().
+    Result<ArenaJson> tryGetTickHistoricalData(JsonArena& arena,
+                                               const std::string& symbol,
+                                               const std::string& startDate,
+                                               const std::string& endDate,
+                                               const std::string& format = "");
+
+    Result<ArenaJson> tryGetTimeSeriesData(JsonArena& arena,
+                                           const std::string& currency,
+                                           const std::string& startDate,
+                                           const std::string& endDate,
+                                           const std::string& interval,
+                                           const std::string& period,
+                                           const std::string& format);
+
+    Result<nlohmann::json> tryGetOpenMarketStatus();
+    Result<nlohmann::json> tryGetMarketOpenTiming();
+
+    Result<nlohmann::json> tryGetCurrencyConversion(const std::string& from,
+                                                    const std::string& to,
+                                                    double amount);
+
+    Result<nlohmann::json> tryGetDataAsPandasDataFrame(const std::string& symbol,
+                                                       const std::string& startDate,
+                                                       const std::string& endDate,
+                                                       const std::string& format,
+                                                       const std::string& fields);
+
+    Result<nlohmann::json> tryGetDataAsPandasDataFrame(const std::string& symbol,
+                                                       const std::string& startDate,
+                                                       const std::string& endDate,
+                                                       PandasFormat format,
+                                                       PandasFields fields);
+
 private:
-    std::string apiKey;
-    std::unique_ptr<Client> client;
+    // Keys, base URL and prebuilt request prefixes, published as one immutable
+    // KeyPool. A setter stores the new pool (std::atomic_store) and then bumps
+    // poolVersion. A request reads poolVersion with one acquire load and uses the
+    // pool its thread cached for that version; only the first request per thread
+    // after a change loads `pool` itself. Each thread keeps a few recent pools
+    // alive, so a replaced pool is freed once the threads that used it move on.
+    std::shared_ptr<const KeyPool> pool;
+    std::atomic<uint64_t> poolVersion{0};
+    std::mutex configMutex; // serializes setters only
+    std::array<CircuitBreaker, ENDPOINT_FAMILY_COUNT> breakers; // outlive every pool
 
     void validateApiKey(const std::string& key);
-    void ensureClient() const;
+    // With `previous`, the keys (which must be the same) keep its usage state.
+    void publish(const std::vector<ApiKey>& keys, const std::string& url, const KeyPool* previous = nullptr);
+    class PoolRef; // the current KeyPool, kept alive for one call
+    PoolRef currentPool() const;
+    PoolRef ensureClient() const; // throws until an API key is set
+
+    nlohmann::json fetchTimeSeries(const std::string& currency,
+                                   const std::string& startDate,
+                                   const std::string& endDate,
+                                   TimeSeriesInterval interval,
+                                   int period,
+                                   TimeSeriesFormat format);
+
+    Result<nlohmann::json> tryFetchTimeSeries(const std::string& currency,
+                                              const std::string& startDate,
+                                              const std::string& endDate,
+                                              TimeSeriesInterval interval,
+                                              int period,
+                                              TimeSeriesFormat format);
 };
 
 #endif
\ No newline at end of file
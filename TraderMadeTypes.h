@@ -0,0 +1,144 @@
+#ifndef TRADERMADE_TYPES_H
+#define TRADERMADE_TYPES_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Strongly-typed request options. The string based overloads on TraderMade
+// map onto these, so both styles are validated against the same tables.
+
+// Time Series "format" parameter
+enum class TimeSeriesFormat { Records, Csv, Index, Columns, Split };
+
+// Time Series "interval" parameter
+enum class TimeSeriesInterval { Daily, Hourly, Minute };
+
+// Pandas DataFrame export "format" parameter
+enum class PandasFormat { Records, Columns, Index, Split };
+
+// Pandas DataFrame export "fields" parameter
+enum class PandasFields { Close, Ohlc };
+
+constexpr const char* toApiString(TimeSeriesFormat format) {
+    return format == TimeSeriesFormat::Records ? "records"
+         : format == TimeSeriesFormat::Csv     ? "csv"
+         : format == TimeSeriesFormat::Index   ? "index"
+         : format == TimeSeriesFormat::Columns ? "columns"
+         :                                       "split";
+}
+
+constexpr const char* toApiString(TimeSeriesInterval interval) {
+    return interval == TimeSeriesInterval::Daily  ? "daily"
+         : interval == TimeSeriesInterval::Hourly ? "hourly"
+         :                                          "minute";
+}
+
+constexpr const char* toApiString(PandasFormat format) {
+    return format == PandasFormat::Records ? "records"
+         : format == PandasFormat::Columns ? "columns"
+         : format == PandasFormat::Index   ? "index"
+         :                                   "split";
+}
+
+constexpr const char* toApiString(PandasFields fields) {
+    return fields == PandasFields::Close ? "close" : "ohlc";
+}
+
+// Valid periods per interval: daily {1}, hourly {1,2,4,6,8,24}, minute {1,5,10,15,30}
+constexpr bool isValidTimeSeriesPeriod(TimeSeriesInterval interval, int period) {
+    switch (interval) {
+    case TimeSeriesInterval::Daily:
+        return period == 1;
+    case TimeSeriesInterval::Hourly:
+        return period == 1 || period == 2 || period == 4 || period == 6 || period == 8 || period == 24;
+    case TimeSeriesInterval::Minute:
+        return period == 1 || period == 5 || period == 10 || period == 15 || period == 30;
+    }
+    return false;
+}
+
+// Dense per-symbol index assigned by InstrumentRegistry / QuoteTable; -1 means unknown.
+using InstrumentId = int;
+
+// Decoded /live quote. Trivially copyable so it can travel through lock-free buffers.
+struct LiveQuote {
+    char symbol[16];     // e.g. "EURUSD" or "UK100", NUL terminated
+    double bid;
+    double ask;
+    double mid;
+    int64_t timestampMs; // quote time reported by the API, ms since epoch
+
+    void setSymbol(const std::string& s) {
+        size_t n = s.size() < sizeof(symbol) - 1 ? s.size() : sizeof(symbol) - 1;
+        std::memcpy(symbol, s.data(), n);
+        std::memset(symbol + n, 0, sizeof(symbol) - n);
+    }
+
+    std::string symbolString() const { return std::string(symbol); }
+};
+
+// Historical ticks in columnar (structure-of-arrays) form, ascending by time.
+struct TickSeries {
+    std::vector<int64_t> timestampMs;
+    std::vector<double> bid;
+    std::vector<double> ask;
+    std::vector<double> mid;
+
+    size_t size() const { return timestampMs.size(); }
+    bool empty() const { return timestampMs.empty(); }
+    void clear() {
+        timestampMs.clear();
+        bid.clear();
+        ask.clear();
+        mid.clear();
+    }
+    void reserve(size_t n) {
+        timestampMs.reserve(n);
+        bid.reserve(n);
+        ask.reserve(n);
+        mid.reserve(n);
+    }
+    void push_back(int64_t t, double b, double a, double m) {
+        timestampMs.push_back(t);
+        bid.push_back(b);
+        ask.push_back(a);
+        mid.push_back(m);
+    }
+};
+
+// OHLC bars in columnar form; timestampMs is the bar open time.
+struct BarSeries {
+    std::vector<int64_t> timestampMs;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+
+    size_t size() const { return timestampMs.size(); }
+    bool empty() const { return timestampMs.empty(); }
+    void clear() {
+        timestampMs.clear();
+        open.clear();
+        high.clear();
+        low.clear();
+        close.clear();
+    }
+    void reserve(size_t n) {
+        timestampMs.reserve(n);
+        open.reserve(n);
+        high.reserve(n);
+        low.reserve(n);
+        close.reserve(n);
+    }
+    void push_back(int64_t t, double o, double h, double l, double c) {
+        timestampMs.push_back(t);
+        open.push_back(o);
+        high.push_back(h);
+        low.push_back(l);
+        close.push_back(c);
+    }
+};
+
+#endif
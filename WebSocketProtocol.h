@@ -0,0 +1,194 @@
+#ifndef TRADERMADE_WEBSOCKET_PROTOCOL_H
+#define TRADERMADE_WEBSOCKET_PROTOCOL_H
+
+// Minimal RFC 6455 helpers shared by StreamingClient and tradermade_mock_server:
+// handshake key derivation (SHA-1 + base64) and frame encoding/decoding.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace WebSocket {
+
+    const char* const GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    enum Opcode : uint8_t {
+        CONTINUATION = 0x0,
+        TEXT = 0x1,
+        BINARY = 0x2,
+        CLOSE = 0x8,
+        PING = 0x9,
+        PONG = 0xA
+    };
+
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    inline std::array<uint8_t, 20> sha1(const std::string& input) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        std::string msg = input;
+        uint64_t bitLength = static_cast<uint64_t>(input.size()) * 8;
+        msg += static_cast<char>(0x80);
+        while (msg.size() % 64 != 56) {
+            msg += static_cast<char>(0);
+        }
+        for (int i = 7; i >= 0; --i) {
+            msg += static_cast<char>((bitLength >> (i * 8)) & 0xFF);
+        }
+
+        for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+            uint32_t w[80];
+            for (int i = 0; i < 16; ++i) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(msg.data() + chunk + i * 4);
+                w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+            }
+            for (int i = 16; i < 80; ++i) {
+                w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+            }
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; ++i) {
+                uint32_t f, k;
+                if (i < 20) {
+                    f = (b & c) | (~b & d);
+                    k = 0x5A827999;
+                } else if (i < 40) {
+                    f = b ^ c ^ d;
+                    k = 0x6ED9EBA1;
+                } else if (i < 60) {
+                    f = (b & c) | (b & d) | (c & d);
+                    k = 0x8F1BBCDC;
+                } else {
+                    f = b ^ c ^ d;
+                    k = 0xCA62C1D6;
+                }
+                uint32_t t = rotl(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotl(b, 30);
+                b = a;
+                a = t;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
+        }
+
+        std::array<uint8_t, 20> digest{};
+        for (int i = 0; i < 5; ++i) {
+            digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+            digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+            digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+            digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+        }
+        return digest;
+    }
+
+    inline std::string base64Encode(const uint8_t* data, size_t length) {
+        static const char TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        out.reserve((length + 2) / 3 * 4);
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t n = uint32_t(data[i]) << 16;
+            if (i + 1 < length) n |= uint32_t(data[i + 1]) << 8;
+            if (i + 2 < length) n |= uint32_t(data[i + 2]);
+            out += TABLE[(n >> 18) & 63];
+            out += TABLE[(n >> 12) & 63];
+            out += i + 1 < length ? TABLE[(n >> 6) & 63] : '=';
+            out += i + 2 < length ? TABLE[n & 63] : '=';
+        }
+        return out;
+    }
+
+    // Value the server must return in Sec-WebSocket-Accept for the client's key
+    inline std::string acceptKey(const std::string& clientKey) {
+        std::array<uint8_t, 20> digest = sha1(clientKey + GUID);
+        return base64Encode(digest.data(), digest.size());
+    }
+
+    // Appends one complete (FIN) frame. Clients must mask; servers must not.
+    inline void appendFrame(std::string& out, Opcode opcode, const char* payload, size_t length,
+                            bool mask, uint32_t maskKey = 0) {
+        out += static_cast<char>(0x80 | opcode);
+        uint8_t maskBit = mask ? 0x80 : 0x00;
+        if (length < 126) {
+            out += static_cast<char>(maskBit | length);
+        } else if (length <= 0xFFFF) {
+            out += static_cast<char>(maskBit | 126);
+            out += static_cast<char>((length >> 8) & 0xFF);
+            out += static_cast<char>(length & 0xFF);
+        } else {
+            out += static_cast<char>(maskBit | 127);
+            for (int i = 7; i >= 0; --i) {
+                out += static_cast<char>((static_cast<uint64_t>(length) >> (i * 8)) & 0xFF);
+            }
+        }
+        if (!mask) {
+            out.append(payload, length);
+            return;
+        }
+        uint8_t key[4] = {static_cast<uint8_t>(maskKey >> 24), static_cast<uint8_t>(maskKey >> 16),
+                          static_cast<uint8_t>(maskKey >> 8), static_cast<uint8_t>(maskKey)};
+        out.append(reinterpret_cast<const char*>(key), 4);
+        size_t start = out.size();
+        out.append(payload, length);
+        for (size_t i = 0; i < length; ++i) {
+            out[start + i] = static_cast<char>(out[start + i] ^ key[i & 3]);
+        }
+    }
+
+    struct Frame {
+        bool fin;
+        Opcode opcode;
+        char* payload;   // points into the caller's buffer, already unmasked
+        size_t length;
+    };
+
+    // Decodes one frame at data[0..available). Returns the number of bytes the frame
+    // occupies, 0 if more data is needed, or -1 if the frame is invalid/too large.
+    // Masked payloads are unmasked in place.
+    inline long parseFrame(char* data, size_t available, Frame& frame, size_t maxPayload) {
+        if (available < 2) return 0;
+        const uint8_t b0 = static_cast<uint8_t>(data[0]);
+        const uint8_t b1 = static_cast<uint8_t>(data[1]);
+        frame.fin = (b0 & 0x80) != 0;
+        frame.opcode = static_cast<Opcode>(b0 & 0x0F);
+        bool masked = (b1 & 0x80) != 0;
+        uint64_t length = b1 & 0x7F;
+        size_t pos = 2;
+        if (length == 126) {
+            if (available < 4) return 0;
+            length = (uint64_t(static_cast<uint8_t>(data[2])) << 8) | static_cast<uint8_t>(data[3]);
+            pos = 4;
+        } else if (length == 127) {
+            if (available < 10) return 0;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | static_cast<uint8_t>(data[2 + i]);
+            }
+            pos = 10;
+        }
+        if (length > maxPayload) return -1;
+        uint8_t key[4] = {0, 0, 0, 0};
+        if (masked) {
+            if (available < pos + 4) return 0;
+            std::memcpy(key, data + pos, 4);
+            pos += 4;
+        }
+        if (available < pos + length) return 0;
+        frame.payload = data + pos;
+        frame.length = static_cast<size_t>(length);
+        if (masked) {
+            for (size_t i = 0; i < frame.length; ++i) {
+                frame.payload[i] = static_cast<char>(frame.payload[i] ^ key[i & 3]);
+            }
+        }
+        return static_cast<long>(pos + length);
+    }
+
+}
+
+#endif
@@ -1,6 +1,6 @@
 #include <iostream>
 #include <cstdlib>
-#include "../../tradermade.cpp"
+#include "TraderMadeSDK.h"
 
 int main()
 {
@@ -1,6 +1,6 @@
 #include <iostream>
 #include <cstdlib>
-#include "../../tradermade.cpp"
+#include "TraderMadeSDK.h"
 
 int main() {
     const char* apiKey = std::getenv("TRADERMADE_API_KEY");
@@ -0,0 +1,18 @@
+#ifndef TRADERMADE_TESTS_CHECK_H
+#define TRADERMADE_TESTS_CHECK_H
+
+#include <cstdio>
+
+// Minimal assertion for the tests in this directory: reports the failed condition
+// and counts it, so one run lists every failure. main() returns checkFailures != 0.
+static int checkFailures = 0;
+
+#define CHECK(condition)                                                               \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            std::fprintf(stderr, "%s:%d: FAIL: %s\n", __FILE__, __LINE__, #condition); \
+            ++checkFailures;                                                           \
+        }                                                                              \
+    } while (0)
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef TRADERMADE_TESTS_MOCK_SERVER_PROCESS_H
+#define TRADERMADE_TESTS_MOCK_SERVER_PROCESS_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+// Runs tradermade_mock_server on a loopback port derived from the test's pid (plus
+// `offset`, for tests that start several) and stops it on destruction. The ports stay
+// below Linux's ephemeral range, so a client connection cannot already hold one.
+class MockServerProcess {
+public:
+    MockServerProcess(const std::string& path, std::vector<std::string> args = {}, int offset = 0)
+        : port(20000 + static_cast<int>((::getpid() + offset) % 10000)) {
+        args.insert(args.begin(), "--port=" + std::to_string(port));
+        args.insert(args.begin(), path);
+        std::vector<char*> argv;
+        for (std::string& a : args) argv.push_back(&a[0]);
+        argv.push_back(nullptr);
+        if (posix_spawn(&pid, path.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+            pid = 0;
+            return;
+        }
+        for (int i = 0; i < 100 && !acceptsConnections(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        // A server that could not bind exits; whatever accepted is not ours.
+        int status = 0;
+        if (::waitpid(pid, &status, WNOHANG) == pid) {
+            pid = 0;
+        }
+    }
+
+    MockServerProcess(const MockServerProcess&) = delete;
+    MockServerProcess& operator=(const MockServerProcess&) = delete;
+
+    ~MockServerProcess() {
+        if (pid > 0) {
+            ::kill(pid, SIGTERM);
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+        }
+    }
+
+    bool running() const { return pid > 0; }
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(port) + "/api/v1"; }
+
+private:
+    int port;
+    pid_t pid = 0;
+
+    bool acceptsConnections() const {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        ::close(fd);
+        return ok;
+    }
+};
+
+#endif
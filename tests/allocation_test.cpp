@@ -0,0 +1,103 @@
+// Checks that the steady-state getLiveRatesRaw path makes no heap allocations.
+//
+//   allocation_test <path to tradermade_mock_server>
+//
+// Starts the mock server on a loopback port, warms up the calling thread's buffers
+// with one request, then counts global operator new calls across further requests.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "MockServerProcess.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <tradermade_mock_server>\n", argv[0]);
+        return 2;
+    }
+    MockServerProcess server(argv[1], {"--threads=1"});
+    if (!server.running()) {
+        std::fprintf(stderr, "cannot start %s\n", argv[1]);
+        return 2;
+    }
+
+    const int REQUESTS = 50;
+    int failures = 0;
+    try {
+        TraderMade tm;
+        tm.setRestApiKey("allocation-test");
+        tm.setBaseUrl(server.baseUrl());
+
+        const std::string currencies = "EURUSD,GBPUSD,USDJPY";
+        size_t warmup = tm.getLiveRatesRaw(currencies).size(); // sizes the per-thread buffers
+        if (warmup == 0) {
+            std::fprintf(stderr, "FAIL: empty warm-up response\n");
+            ++failures;
+        }
+
+        counting.store(true);
+        size_t bytes = 0;
+        for (int i = 0; i < REQUESTS; ++i) {
+            bytes += tm.getLiveRatesRaw(currencies).size();
+        }
+        counting.store(false);
+
+        if (bytes < warmup * REQUESTS / 2) {
+            std::fprintf(stderr, "FAIL: short responses (%zu bytes over %d requests)\n", bytes, REQUESTS);
+            ++failures;
+        }
+        if (allocations.load() != 0) {
+            std::fprintf(stderr, "FAIL: %zu heap allocations over %d requests\n", allocations.load(), REQUESTS);
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        counting.store(false);
+        std::fprintf(stderr, "FAIL: %s\n", e.what());
+        ++failures;
+    }
+
+    if (failures == 0) {
+        std::printf("ok: %d getLiveRatesRaw calls, 0 heap allocations\n", REQUESTS);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+// Walks a CircuitBreaker through closed -> open -> half-open -> closed (and back to
+// open on a failed probe), and checks its counters, slow calls, the disabled state and
+// concurrent recording while closed.
+//
+//   circuit_breaker_test
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "CircuitBreaker.h"
+#include "Check.h"
+
+namespace {
+
+using Admission = CircuitBreaker::Admission;
+using Outcome = CircuitBreaker::Outcome;
+
+const std::chrono::nanoseconds FAST = std::chrono::milliseconds(1);
+const std::chrono::nanoseconds SLOW = std::chrono::milliseconds(500);
+
+CircuitBreakerOptions testOptions() {
+    CircuitBreakerOptions options;
+    options.enabled = true;
+    options.failureRatio = 0.5;
+    options.slowCall = std::chrono::milliseconds(100);
+    options.minimumCalls = 10;
+    options.window = std::chrono::milliseconds(60000);
+    options.openFor = std::chrono::milliseconds(50);
+    options.halfOpenProbes = 2;
+    return options;
+}
+
+void call(CircuitBreaker& breaker, Outcome outcome, std::chrono::nanoseconds latency = FAST) {
+    Admission a = breaker.admit();
+    CHECK(a == Admission::Normal);
+    breaker.record(a, outcome, latency);
+}
+
+void waitOpenFor() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+}
+
+void testStateMachine() {
+    CircuitBreaker breaker(testOptions());
+    CHECK(breaker.state() == CircuitState::Closed);
+
+    // Below minimumCalls the ratio is not checked, even at 100% failures.
+    for (int i = 0; i < 9; ++i) call(breaker, Outcome::Failure);
+    CHECK(breaker.state() == CircuitState::Closed);
+    // Calls that were never sent do not count.
+    Admission a = breaker.admit();
+    breaker.record(a, Outcome::NotSent, FAST);
+    CHECK(breaker.stats().calls == 9 && breaker.stats().windowCalls == 9);
+
+    call(breaker, Outcome::Failure); // 10 calls, all failed
+    CHECK(breaker.state() == CircuitState::Open);
+    CircuitBreakerStats s = breaker.stats();
+    CHECK(s.opened == 1 && s.calls == 10 && s.failures == 10 && s.windowFailureRatio == 1.0);
+
+    // Open: rejected without a call.
+    CHECK(breaker.admit() == Admission::Rejected);
+    CHECK(breaker.admit() == Admission::Rejected);
+    CHECK(breaker.stats().rejected == 2);
+
+    // Half-open after openFor: exactly halfOpenProbes calls go through.
+    waitOpenFor();
+    CHECK(breaker.state() == CircuitState::HalfOpen);
+    Admission p1 = breaker.admit();
+    Admission p2 = breaker.admit();
+    CHECK(p1 == Admission::Probe && p2 == Admission::Probe);
+    CHECK(breaker.admit() == Admission::Rejected);
+    // A probe that was not sent frees its slot.
+    breaker.record(p2, Outcome::NotSent, FAST);
+    p2 = breaker.admit();
+    CHECK(p2 == Admission::Probe);
+
+    // All probes succeed: closed, with a fresh window.
+    breaker.record(p1, Outcome::Success, FAST);
+    CHECK(breaker.state() == CircuitState::HalfOpen);
+    breaker.record(p2, Outcome::Success, FAST);
+    CHECK(breaker.state() == CircuitState::Closed);
+    CHECK(breaker.stats().windowCalls == 0);
+    call(breaker, Outcome::Success);
+
+    // Trip again; a failed probe re-opens the circuit.
+    for (int i = 0; i < 9; ++i) call(breaker, Outcome::Failure); // 9 of 10
+    CHECK(breaker.state() == CircuitState::Open && breaker.stats().opened == 2);
+    waitOpenFor();
+    p1 = breaker.admit();
+    p2 = breaker.admit();
+    breaker.record(p1, Outcome::Failure, FAST);
+    CHECK(breaker.state() == CircuitState::Open && breaker.stats().opened == 3);
+    // The other probe's late result no longer counts towards closing.
+    breaker.record(p2, Outcome::Success, FAST);
+    CHECK(breaker.admit() == Admission::Rejected);
+
+    // A slow probe counts as failed.
+    waitOpenFor();
+    p1 = breaker.admit();
+    CHECK(p1 == Admission::Probe);
+    breaker.record(p1, Outcome::Success, SLOW);
+    CHECK(breaker.state() == CircuitState::Open && breaker.stats().opened == 4);
+}
+
+void testRatios() {
+    // The circuit opens once failures reach failureRatio of the window's calls.
+    CircuitBreaker breaker(testOptions());
+    for (int i = 0; i < 6; ++i) call(breaker, Outcome::Success);
+    for (int i = 0; i < 4; ++i) call(breaker, Outcome::Failure);
+    CHECK(breaker.state() == CircuitState::Closed);
+    call(breaker, Outcome::Failure); // 5 of 11
+    CHECK(breaker.state() == CircuitState::Closed);
+    call(breaker, Outcome::Failure); // 6 of 12
+    CHECK(breaker.state() == CircuitState::Open);
+
+    // Slow successes trip the slow call ratio.
+    CircuitBreakerOptions options = testOptions();
+    options.slowCallRatio = 0.5;
+    breaker.configure(options);
+    CHECK(breaker.state() == CircuitState::Closed && breaker.stats().calls == 0);
+    for (int i = 0; i < 5; ++i) call(breaker, Outcome::Success);
+    for (int i = 0; i < 4; ++i) call(breaker, Outcome::Success, SLOW);
+    CHECK(breaker.state() == CircuitState::Closed);
+    call(breaker, Outcome::Success, SLOW); // 5 of 10
+    CHECK(breaker.state() == CircuitState::Open);
+    CHECK(breaker.stats().slowCalls == 5 && breaker.stats().failures == 0);
+}
+
+void testWindowExpiry() {
+    // Failures older than the window no longer count.
+    CircuitBreakerOptions options = testOptions();
+    options.window = std::chrono::milliseconds(100);
+    CircuitBreaker breaker(options);
+    for (int i = 0; i < 9; ++i) call(breaker, Outcome::Failure);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK(breaker.stats().windowCalls == 0);
+    call(breaker, Outcome::Failure);
+    CHECK(breaker.state() == CircuitState::Closed);
+}
+
+void testDisabled() {
+    CircuitBreaker breaker;
+    CHECK(breaker.admit() == Admission::Disabled);
+    for (int i = 0; i < 100; ++i) breaker.record(Admission::Disabled, Outcome::Failure, SLOW);
+    CHECK(breaker.state() == CircuitState::Closed && breaker.stats().calls == 0);
+
+    // Disabling an open breaker lets calls through again.
+    breaker.configure(testOptions());
+    for (int i = 0; i < 10; ++i) call(breaker, Outcome::Failure);
+    CHECK(breaker.admit() == Admission::Rejected);
+    CircuitBreakerOptions off = testOptions();
+    off.enabled = false;
+    breaker.configure(off);
+    CHECK(breaker.admit() == Admission::Disabled && breaker.state() == CircuitState::Closed);
+}
+
+void testConcurrentClosed() {
+    // Successes recorded from several threads are all counted and never trip.
+    CircuitBreakerOptions options = testOptions();
+    options.window = std::chrono::milliseconds(10); // buckets reused while recording
+    CircuitBreaker breaker(options);
+    const int THREADS = 4;
+    const int CALLS = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < CALLS; ++i) {
+                Admission a = breaker.admit();
+                breaker.record(a, Outcome::Success, FAST);
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    CircuitBreakerStats s = breaker.stats();
+    CHECK(s.calls == static_cast<uint64_t>(THREADS) * CALLS);
+    CHECK(s.state == CircuitState::Closed && s.opened == 0 && s.windowFailureRatio == 0.0);
+}
+
+} // namespace
+
+int main() {
+    testStateMachine();
+    testRatios();
+    testWindowExpiry();
+    testDisabled();
+    testConcurrentClosed();
+
+    if (checkFailures == 0) {
+        std::printf("ok: circuit breaker\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// CurrencyConverter rates from fed quotes: direct, inverse and triangulated, the
+// pivot preference, missing rates and bulk conversion. Given the mock server, also
+// converts a cross /live does not quote through legs fetched via the pivot.
+//
+//   currency_converter_test [<path to tradermade_mock_server>]
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "Check.h"
+#include "CurrencyConverter.h"
+#include "MockServerProcess.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+LiveQuote quote(const std::string& symbol, double mid) {
+    LiveQuote q{};
+    q.setSymbol(symbol);
+    q.bid = mid;
+    q.ask = mid;
+    q.mid = mid;
+    return q;
+}
+
+bool near(double a, double b) {
+    return std::fabs(a - b) <= 1e-12 * std::fabs(b);
+}
+
+void testFedQuotes() {
+    CurrencyConverter fx;
+    CHECK(fx.update({quote("EURUSD", 1.1), quote("GBPUSD", 1.25), quote("USDJPY", 150.0)}) == 3);
+    CHECK(fx.currencyCount() == 4 && fx.pairCount() == 3);
+
+    CHECK(fx.rate("EUR", "USD") == 1.1);              // direct
+    CHECK(near(fx.rate("USD", "EUR"), 1.0 / 1.1));    // inverse
+    CHECK(near(fx.rate("GBP", "JPY"), 1.25 * 150.0)); // GBP -> USD -> JPY
+    CHECK(near(fx.rate("JPY", "GBP"), 1.0 / (1.25 * 150.0)));
+    CHECK(near(fx.rate("EUR", "GBP"), 1.1 / 1.25));   // EUR -> USD -> GBP
+    CHECK(near(fx.convert(1000.0, "GBP", "JPY"), 187500.0));
+    CHECK(fx.rate("JPY", "JPY") == 1.0);
+
+    // A direct pair beats a path through the pivot; new quotes replace old ones.
+    CHECK(fx.update(quote("EURGBP", 0.9)));
+    CHECK(fx.rate("EUR", "GBP") == 0.9);
+    CHECK(fx.update(quote("GBPEUR", 1.0 / 0.8))); // same edge, quoted the other way
+    CHECK(fx.pairCount() == 4 && near(fx.rate("EUR", "GBP"), 0.8));
+
+    // Of two paths with as many hops, the one through the pivot (USD) wins.
+    fx.update({quote("EURCHF", 0.95), quote("CHFJPY", 160.0)});
+    CHECK(near(fx.rate("EUR", "JPY"), 1.1 * 150.0));
+
+    // Unusable quotes are ignored.
+    CHECK(!fx.update(quote("EURUSD", 0.0)) && !fx.update(quote("EURUSD", NAN)));
+    CHECK(!fx.update(quote("UK100", 7000.0)) && !fx.update(quote("USDUSD", 1.0)));
+    CHECK(fx.rate("EUR", "USD") == 1.1);
+
+    // No path: an error result, or an exception from the throwing calls.
+    Result<double> missing = fx.tryRate("AUD", "USD");
+    CHECK(!missing && missing.error().code == ErrorCode::InvalidArgument);
+    CHECK(!fx.tryConvert(1.0, "", "USD"));
+    bool threw = false;
+    try {
+        fx.rate("USD", "AUD");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // /live bodies feed it directly.
+    nlohmann::json body = {{"quotes", {{{"base_currency", "AUD"}, {"quote_currency", "USD"},
+                                        {"bid", 0.65}, {"ask", 0.65}, {"mid", 0.65}}}}};
+    CHECK(fx.updateFromLiveRates(body) == 1);
+    CHECK(near(fx.rate("AUD", "JPY"), 0.65 * 150.0));
+}
+
+void testBulk() {
+    CurrencyConverter fx;
+    fx.update({quote("EURUSD", 1.1), quote("GBPUSD", 1.25), quote("USDJPY", 150.0)});
+    const std::vector<double> amounts = {100.0, 200.0, 300.0, 400.0, 500.0};
+    const std::vector<std::string> from = {"EUR", "GBP", "EUR", "NZD", "USD"};
+    const std::vector<std::string> to = {"USD", "JPY", "USD", "USD", "USD"};
+    std::vector<double> out;
+    CurrencyConverter::BulkResult r = fx.convertBulk(amounts, from, to, out);
+    CHECK(out.size() == amounts.size());
+    CHECK(r.converted == 4 && r.failed == 1 && r.distinctPairs == 4);
+    CHECK(r.missingPairs.size() == 1 && r.missingPairs[0] == "NZD/USD");
+    CHECK(near(out[0], 110.0) && near(out[1], 37500.0) && near(out[2], 330.0));
+    CHECK(std::isnan(out[3]) && out[4] == 500.0);
+
+    // Everything into one reporting currency.
+    std::vector<double> usd(3);
+    r = fx.convertBulk(amounts.data(), from.data(), std::string("USD"), 3, usd.data());
+    CHECK(r.converted == 3 && near(usd[0], 110.0) && near(usd[1], 250.0) && near(usd[2], 330.0));
+}
+
+// /live does not quote GBPJPY: the converter asks for the cross and both USD legs in
+// the same call, and triangulates.
+bool testPivotLegs(const std::string& mockPath) {
+    MockServerProcess server(mockPath, {"--threads=1", "--unquoted=GBPJPY"});
+    if (!server.running()) {
+        std::fprintf(stderr, "cannot start %s\n", mockPath.c_str());
+        return false;
+    }
+    TraderMade tm;
+    tm.setRestApiKey("currency-converter-test");
+    tm.setBaseUrl(server.baseUrl());
+    CurrencyConverter fx(&tm);
+
+    Result<double> gbpjpy = fx.tryRate("GBP", "JPY");
+    CHECK(gbpjpy.ok());
+    CHECK(fx.refreshes() == 1 && fx.pairCount() == 2);
+    if (gbpjpy) {
+        CHECK(near(gbpjpy.value(), fx.rate("GBP", "USD") * fx.rate("USD", "JPY")));
+    }
+    CHECK(fx.refreshes() == 1); // the legs were fresh
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        if (!testPivotLegs(argv[1])) {
+            return 2;
+        }
+    } else {
+        testFedQuotes();
+        testBulk();
+    }
+
+    if (checkFailures == 0) {
+        std::printf("ok: currency converter\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+// Checks that reading the published key pool takes no mutex, also while another
+// thread keeps replacing the keys, and that a warmed-up getLiveRatesRaw call takes
+// none either, with the circuit breakers disabled or closed.
+//
+//   lock_free_test <path to tradermade_mock_server>
+//
+// Counts pthread_mutex_lock calls (interposed below) made by the checking thread.
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "MockServerProcess.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+thread_local bool counting = false;
+std::atomic<size_t> locks{0};
+
+using LockFn = int (*)(pthread_mutex_t*);
+
+LockFn realLock(const char* name) {
+    return reinterpret_cast<LockFn>(::dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    static const LockFn real = realLock("pthread_mutex_lock");
+    if (counting) {
+        locks.fetch_add(1, std::memory_order_relaxed);
+    }
+    return real(mutex);
+}
+
+extern "C" int pthread_mutex_trylock(pthread_mutex_t* mutex) {
+    static const LockFn real = realLock("pthread_mutex_trylock");
+    if (counting) {
+        locks.fetch_add(1, std::memory_order_relaxed);
+    }
+    return real(mutex);
+}
+
+// Locks taken by `requests` getLiveRatesRaw calls after a warm-up call.
+size_t requestLocks(TraderMade& tm, int requests) {
+    const std::string currencies = "EURUSD,GBPUSD,USDJPY";
+    tm.getLiveRatesRaw(currencies);
+    const size_t before = locks.load();
+    counting = true;
+    for (int i = 0; i < requests; ++i) {
+        tm.getLiveRatesRaw(currencies);
+    }
+    counting = false;
+    return locks.load() - before;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <tradermade_mock_server>\n", argv[0]);
+        return 2;
+    }
+    const int READS = 100000;
+    const int REQUESTS = 50;
+    int failures = 0;
+
+    TraderMade tm;
+    tm.setRestApiKey("lock-free-test");
+    tm.getRestApiKey(); // first read on this thread after a change
+
+    counting = true;
+    size_t chars = 0;
+    for (int i = 0; i < READS; ++i) {
+        chars += tm.getBaseUrl().size();
+    }
+    counting = false;
+    if (chars == 0 || locks.load() != 0) {
+        std::fprintf(stderr, "FAIL: %zu mutex locks over %d pool reads\n", locks.load(), READS);
+        ++failures;
+    }
+
+    // Key rotation on another thread: a reader reloads the pool once per change, so
+    // it may lock then, but it must never read a freed pool.
+    std::atomic<bool> stop{false};
+    std::thread rotator([&] {
+        for (int i = 0; !stop.load(); ++i) {
+            tm.setRestApiKey("rotated-" + std::to_string(i % 8));
+        }
+    });
+    size_t rotatedReads = 0;
+    for (int i = 0; i < READS || (rotatedReads == 0 && i < 100 * READS); ++i) {
+        rotatedReads += tm.getRestApiKey().compare(0, 8, "rotated-") == 0;
+    }
+    stop.store(true);
+    rotator.join();
+    if (rotatedReads == 0) {
+        std::fprintf(stderr, "FAIL: reader never saw a rotated key\n");
+        ++failures;
+    }
+
+    MockServerProcess server(argv[1], {"--threads=1"});
+    if (!server.running()) {
+        std::fprintf(stderr, "cannot start %s\n", argv[1]);
+        return 2;
+    }
+    try {
+        tm.setRestApiKey("lock-free-test");
+        tm.setBaseUrl(server.baseUrl());
+        size_t disabled = requestLocks(tm, REQUESTS);
+        CircuitBreakerOptions breaker;
+        breaker.enabled = true;
+        tm.setCircuitBreaker(breaker);
+        size_t closed = requestLocks(tm, REQUESTS);
+        if (disabled != 0 || closed != 0) {
+            std::fprintf(stderr, "FAIL: %zu / %zu mutex locks over %d requests (breakers disabled / closed)\n",
+                         disabled, closed, REQUESTS);
+            ++failures;
+        }
+    } catch (const std::exception& e) {
+        counting = false;
+        std::fprintf(stderr, "FAIL: %s\n", e.what());
+        ++failures;
+    }
+
+    if (failures == 0) {
+        std::printf("ok: %d pool reads and %d getLiveRatesRaw calls, 0 mutex locks\n", READS, 2 * REQUESTS);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// resampleTicks and resampleBars: bucket boundaries, open-time stamps, skipped empty
+// buckets, origins and negative times, checked against a plain per-row reference.
+//
+//   resample_test
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "Check.h"
+#include "Resample.h"
+
+namespace {
+
+const int64_t MINUTE_MS = 60000;
+const int64_t HOUR_MS = 60 * MINUTE_MS;
+
+bool sameBars(const BarSeries& a, const BarSeries& b) {
+    return a.timestampMs == b.timestampMs && a.open == b.open && a.high == b.high && a.low == b.low &&
+           a.close == b.close;
+}
+
+// One row at a time, with floor division written out.
+BarSeries referenceBars(const BarSeries& rows, int64_t intervalMs, int64_t originMs) {
+    BarSeries out;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        int64_t d = rows.timestampMs[i] - originMs;
+        int64_t q = d / intervalMs - (d % intervalMs < 0 ? 1 : 0);
+        int64_t bucket = originMs + q * intervalMs;
+        if (out.empty() || out.timestampMs.back() != bucket) {
+            out.push_back(bucket, rows.open[i], rows.high[i], rows.low[i], rows.close[i]);
+        } else {
+            out.high.back() = std::max(out.high.back(), rows.high[i]);
+            out.low.back() = std::min(out.low.back(), rows.low[i]);
+            out.close.back() = rows.close[i];
+        }
+    }
+    return out;
+}
+
+BarSeries asBars(const std::vector<int64_t>& t, const std::vector<double>& price) {
+    BarSeries rows;
+    for (size_t i = 0; i < t.size(); ++i) rows.push_back(t[i], price[i], price[i], price[i], price[i]);
+    return rows;
+}
+
+void testBoundaries() {
+    // A tick exactly on a boundary opens the next bar; the last millisecond does not.
+    const int64_t T = 1767866400000LL; // an hour boundary
+    TickSeries ticks;
+    ticks.push_back(T, 1.0, 1.1, 1.05);
+    ticks.push_back(T + 30000, 3.0, 3.1, 3.05);
+    ticks.push_back(T + MINUTE_MS - 1, 2.0, 2.1, 2.05);
+    ticks.push_back(T + MINUTE_MS, 4.0, 4.1, 4.05);
+    ticks.push_back(T + 5 * MINUTE_MS + 1, 5.0, 5.1, 5.05); // minutes 2-4 are empty
+
+    BarSeries m1;
+    m1.push_back(1, 1, 1, 1, 1); // results are appended
+    CHECK(resampleTicks(ticks, PriceField::Bid, MINUTE_MS, m1) == 3);
+    CHECK(m1.size() == 4 && m1.timestampMs[0] == 1);
+    CHECK(m1.timestampMs[1] == T && m1.open[1] == 1.0 && m1.high[1] == 3.0 && m1.low[1] == 1.0 &&
+          m1.close[1] == 2.0);
+    CHECK(m1.timestampMs[2] == T + MINUTE_MS && m1.open[2] == 4.0 && m1.close[2] == 4.0);
+    CHECK(m1.timestampMs[3] == T + 5 * MINUTE_MS && m1.open[3] == 5.0);
+
+    BarSeries asks;
+    resampleTicks(ticks, PriceField::Ask, MINUTE_MS, asks);
+    CHECK(asks.size() == 3 && asks.high[0] == 3.1 && asks.close[0] == 2.1);
+
+    // Coarser bars from the finer ones.
+    BarSeries minutes;
+    resampleTicks(ticks, PriceField::Mid, MINUTE_MS, minutes);
+    BarSeries m5;
+    CHECK(resampleBars(minutes, 5 * MINUTE_MS, m5) == 2);
+    CHECK(m5.timestampMs[0] == T && m5.open[0] == 1.05 && m5.high[0] == 4.05 && m5.low[0] == 1.05 &&
+          m5.close[0] == 4.05);
+    CHECK(m5.timestampMs[1] == T + 5 * MINUTE_MS && m5.open[1] == 5.05);
+
+    // A 15 minute origin shifts hourly bars to :15.
+    BarSeries shifted;
+    CHECK(resampleTicks(ticks, PriceField::Bid, HOUR_MS, shifted, 15 * MINUTE_MS) == 1);
+    CHECK(shifted.timestampMs[0] == T - 45 * MINUTE_MS);
+
+    CHECK(bucketStart(T + MINUTE_MS - 1, MINUTE_MS) == T);
+    CHECK(bucketStart(T + MINUTE_MS, MINUTE_MS) == T + MINUTE_MS);
+    CHECK(bucketStart(-1, MINUTE_MS) == -MINUTE_MS);
+    CHECK(bucketStart(-MINUTE_MS, MINUTE_MS) == -MINUTE_MS);
+    CHECK(bucketStart(5, 10, 7) == -3);
+
+    // Empty input, bad intervals and unsorted rows.
+    BarSeries none;
+    CHECK(resampleTicks(TickSeries(), PriceField::Mid, MINUTE_MS, none) == 0 && none.empty());
+    bool threw = false;
+    try {
+        resampleTicks(ticks, PriceField::Mid, 0, none);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    TickSeries unsorted;
+    unsorted.push_back(T + 10, 1, 1, 1);
+    unsorted.push_back(T + 5, 1, 1, 1);
+    threw = false;
+    try {
+        resampleTicks(unsorted, PriceField::Mid, MINUTE_MS, none);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testAgainstReference() {
+    // Random irregular ticks around the epoch (negative times included), long enough
+    // that buckets exercise the vectorized min/max.
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<int64_t> gap(0, 4000);
+    std::uniform_real_distribution<double> price(1.0, 2.0);
+    std::vector<int64_t> t;
+    std::vector<double> p;
+    for (int64_t now = -3 * HOUR_MS; t.size() < 20000; now += gap(rng)) {
+        t.push_back(now);
+        p.push_back(price(rng));
+    }
+    const BarSeries rows = asBars(t, p);
+
+    for (int64_t interval : {int64_t(1000), MINUTE_MS, 7 * MINUTE_MS, HOUR_MS}) {
+        for (int64_t origin : {int64_t(0), int64_t(250), -MINUTE_MS / 2}) {
+            BarSeries fromTicks;
+            resampleTicks(t.data(), p.data(), t.size(), interval, fromTicks, origin);
+            CHECK(sameBars(fromTicks, referenceBars(rows, interval, origin)));
+
+            BarSeries fromBars;
+            resampleBars(rows, interval, fromBars, origin);
+            CHECK(sameBars(fromBars, fromTicks));
+        }
+    }
+
+    // Resampling 1 s bars to minutes matches resampling the ticks to minutes directly.
+    BarSeries seconds;
+    resampleTicks(t.data(), p.data(), t.size(), 1000, seconds);
+    BarSeries viaSeconds;
+    BarSeries direct;
+    resampleBars(seconds, MINUTE_MS, viaSeconds);
+    resampleTicks(t.data(), p.data(), t.size(), MINUTE_MS, direct);
+    CHECK(sameBars(viaSeconds, direct));
+}
+
+} // namespace
+
+int main() {
+    testBoundaries();
+    testAgainstReference();
+
+    if (checkFailures == 0) {
+        std::printf("ok: resampling\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
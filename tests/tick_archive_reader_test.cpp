@@ -0,0 +1,168 @@
+// Reads hourly-partitioned archives back through TickArchiveReader: read(), range()
+// and seek() across partition and block boundaries, zero-copy Raw blocks, and the
+// partitioning taken from (or checked against) the archive's manifest.
+//
+//   tick_archive_reader_test
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "Check.h"
+#include "TickArchive.h"
+#include "TickArchiveReader.h"
+
+namespace {
+
+const int64_t HOUR_MS = 3600000;
+const int64_t DAY_MS = 24 * HOUR_MS;
+const int64_t T0 = 1767830400000LL; // 2026-01-08 00:00 UTC
+
+// Ticks every 7 s from the start of hours 0, 1 and 3 of T0's day (none in hour 2),
+// so each partition with data begins with a tick exactly on its boundary.
+TickSeries sampleTicks() {
+    TickSeries ticks;
+    for (int64_t hour : {0, 1, 3}) {
+        for (int64_t t = T0 + hour * HOUR_MS; t < T0 + (hour + 1) * HOUR_MS; t += 7000) {
+            double bid = 1.1 + static_cast<double>((t - T0) / 7000 % 500) * 1e-5;
+            ticks.push_back(t, bid, bid + 0.0002, bid + 0.0001);
+        }
+    }
+    return ticks;
+}
+
+TickSeries expected(const TickSeries& ticks, int64_t fromMs, int64_t toMs) {
+    TickSeries out;
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        if (ticks.timestampMs[i] >= fromMs && ticks.timestampMs[i] < toMs) {
+            out.push_back(ticks.timestampMs[i], ticks.bid[i], ticks.ask[i], ticks.mid[i]);
+        }
+    }
+    return out;
+}
+
+bool same(const TickSeries& a, const TickSeries& b) {
+    return a.timestampMs == b.timestampMs && a.bid == b.bid && a.ask == b.ask && a.mid == b.mid;
+}
+
+void write(const std::string& root, const TickSeries& ticks, int64_t partitionMs, TickCodec codec) {
+    TickArchiveWriter::Options options;
+    options.partitionMs = partitionMs;
+    options.blockTicks = 100;
+    options.codec = codec;
+    TickArchiveWriter writer(root, options);
+    CHECK(writer.append("EURUSD", ticks) == ticks.size());
+}
+
+void testReads(const std::string& root, TickCodec codec) {
+    const TickSeries all = sampleTicks();
+    write(root, all, HOUR_MS, codec);
+
+    TickArchiveReader reader(root); // partitioning from the manifest
+    CHECK(reader.open("EURUSD", T0, T0 + DAY_MS) > 0);
+    CHECK(reader.partitionCount() == 3); // hour 2 has no file
+    CHECK(reader.tickCount() == all.size());
+    CHECK(reader.firstTimestamp() == T0 && reader.lastTimestamp() == all.timestampMs.back());
+
+    // Windows on, just before and just after partition boundaries, and inside a block.
+    const int64_t bounds[][2] = {
+        {T0, T0 + DAY_MS},
+        {T0 + HOUR_MS - 1, T0 + HOUR_MS + 1},
+        {T0 + HOUR_MS, T0 + 3 * HOUR_MS + 1},
+        {T0 + 2 * HOUR_MS, T0 + 3 * HOUR_MS},   // the empty hour
+        {T0 + 1234567, T0 + 1234567 + 70000},
+        {T0 - HOUR_MS, T0},                     // before the data
+    };
+    for (const auto& w : bounds) {
+        TickSeries read;
+        CHECK(reader.read(w[0], w[1], read) == read.size());
+        CHECK(same(read, expected(all, w[0], w[1])));
+
+        TickSeries iterated;
+        for (const TickArchiveReader::Tick& t : reader.range(w[0], w[1])) {
+            iterated.push_back(t.timestampMs, t.bid, t.ask, t.mid);
+        }
+        CHECK(same(iterated, read));
+    }
+
+    // seek() lands on the block holding the first tick at or after the time.
+    for (int64_t t : {T0, T0 + HOUR_MS, T0 + 2 * HOUR_MS, T0 + 3 * HOUR_MS + 7, T0 + DAY_MS}) {
+        size_t i = reader.seek(t);
+        TickSeries after = expected(all, t, T0 + DAY_MS);
+        if (after.empty()) {
+            CHECK(i == reader.blockCount());
+            continue;
+        }
+        CHECK(i < reader.blockCount());
+        CHECK(reader.block(i).lastTs >= after.timestampMs[0]);
+        CHECK(i == 0 || reader.block(i - 1).lastTs < after.timestampMs[0]);
+    }
+
+    // Raw blocks are spans into the mapping; compressed ones have to be decoded.
+    TickArchiveReader::BlockView first = reader.block(0);
+    CHECK(first.codec == codec && first.count == 100);
+    if (codec == TickCodec::Raw) {
+        CHECK(first.timestampMs.size == 100 && first.bid.size == 100 && first.ask.size == 100);
+        CHECK(first.timestampMs[99] == all.timestampMs[99] && first.bid[99] == all.bid[99]);
+        CHECK(first.mid.empty() || first.mid[99] == all.mid[99]);
+    } else {
+        CHECK(first.timestampMs.empty() && first.bid.empty());
+    }
+    TickSeries decoded;
+    CHECK(reader.decode(0, decoded) && decoded.size() == 100 && decoded.timestampMs[0] == T0);
+
+    // Only the partitions overlapping the requested range are mapped.
+    CHECK(reader.open("EURUSD", T0 + HOUR_MS + 5, T0 + HOUR_MS + 10) > 0);
+    CHECK(reader.partitionCount() == 1);
+    CHECK(reader.open("GBPUSD", T0, T0 + DAY_MS) == 0 && reader.tickCount() == 0);
+
+    // An explicit partitioning has to agree with the manifest.
+    TickArchiveReader::Options daily;
+    daily.partitionMs = DAY_MS;
+    TickArchiveReader wrong(root, daily);
+    bool rejected = false;
+    try {
+        wrong.open("EURUSD", T0, T0 + DAY_MS);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+    TickArchiveReader::Options hourly;
+    hourly.partitionMs = HOUR_MS;
+    TickArchiveReader right(root, hourly);
+    CHECK(right.open("EURUSD", T0, T0 + DAY_MS) == reader.open("EURUSD", T0, T0 + DAY_MS));
+}
+
+// Archives written before the manifest existed are read with daily partitions.
+void testNoManifest(const std::string& root) {
+    const TickSeries ticks = sampleTicks();
+    write(root, ticks, DAY_MS, TickCodec::Gorilla);
+    CHECK(std::remove((root + "/MANIFEST").c_str()) == 0);
+    CHECK(readTickArchivePartitionMs(root) == 0);
+
+    TickArchiveReader reader(root);
+    CHECK(reader.open("EURUSD", T0, T0 + DAY_MS) > 0);
+    CHECK(reader.partitionCount() == 1 && reader.tickCount() == ticks.size());
+}
+
+} // namespace
+
+int main() {
+    char dir[] = "/tmp/tick_archive_reader_test.XXXXXX";
+    if (!::mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    testReads(std::string(dir) + "/gorilla", TickCodec::Gorilla);
+    testReads(std::string(dir) + "/raw", TickCodec::Raw);
+    testNoManifest(std::string(dir) + "/legacy");
+    std::system((std::string("rm -rf ") + dir).c_str());
+
+    if (checkFailures == 0) {
+        std::printf("ok: tick archive reader\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+// Round trips of the tick block codecs (Gorilla and Raw) and of TickArchiveWriter's
+// time partitioning.
+//
+//   tick_codec_test
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "TickArchive.h"
+
+namespace {
+
+const int64_t HOUR_MS = 3600000;
+const int64_t T0 = 1767866400000LL; // 2026-01-08 10:00 UTC, an hour boundary
+
+uint64_t bitsOf(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+// Bit-exact comparison, so NaN payloads and -0.0 count.
+bool sameTicks(const TickSeries& a, const TickSeries& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a.timestampMs[i] != b.timestampMs[i] || bitsOf(a.bid[i]) != bitsOf(b.bid[i]) ||
+            bitsOf(a.ask[i]) != bitsOf(b.ask[i]) || bitsOf(a.mid[i]) != bitsOf(b.mid[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool roundTrips(const TickSeries& ticks, TickCodec codec, bool expectDerivedMid) {
+    std::vector<uint8_t> payload;
+    TickBlockHeader h = encodeTickBlock(ticks, 0, ticks.size(), codec, payload);
+    CHECK(h.count == ticks.size());
+    CHECK(h.payloadBytes == payload.size() && payload.size() % 8 == 0);
+    CHECK(h.checksum == tickPayloadChecksum(payload.data(), payload.size()));
+    CHECK(((h.flags & TICK_BLOCK_DERIVED_MID) != 0) == expectDerivedMid);
+    TickSeries out;
+    out.push_back(1, 2, 3, 4); // decode appends
+    if (!decodeTickBlock(h, payload.data(), out)) return false;
+    TickSeries tail;
+    for (size_t i = 1; i < out.size(); ++i) {
+        tail.push_back(out.timestampMs[i], out.bid[i], out.ask[i], out.mid[i]);
+    }
+    return out.timestampMs[0] == 1 && sameTicks(tail, ticks);
+}
+
+// A random walk with irregular spacing: gaps from 0 ms (same timestamp) to hours,
+// which exercises every delta-of-delta width, including negative ones.
+TickSeries randomTicks(size_t n, bool derivedMid) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> gapKind(0, 9);
+    std::uniform_int_distribution<int> pip(-3, 3);
+    TickSeries ticks;
+    int64_t t = T0;
+    double bid = 1.10000;
+    for (size_t i = 0; i < n; ++i) {
+        int kind = gapKind(rng);
+        t += kind < 2 ? 0 : kind < 6 ? 37 * kind : kind < 8 ? 1500 * kind : kind < 9 ? 700000 : 5 * HOUR_MS;
+        bid = std::round((bid + pip(rng) * 0.00001) * 100000.0) / 100000.0;
+        double ask = bid + 0.00012;
+        double mid = derivedMid ? (bid + ask) / 2.0 : bid + 0.00005;
+        ticks.push_back(t, bid, ask, mid);
+    }
+    return ticks;
+}
+
+void testCodecs() {
+    for (TickCodec codec : {TickCodec::Gorilla, TickCodec::Raw}) {
+        CHECK(roundTrips(randomTicks(5000, true), codec, true));
+        CHECK(roundTrips(randomTicks(5000, false), codec, false));
+        CHECK(roundTrips(randomTicks(1, true), codec, true));
+
+        // Extremes: huge and negative timestamp steps, special and denormal values.
+        TickSeries odd;
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+        const double tiny = std::numeric_limits<double>::denorm_min();
+        odd.push_back(0, 0.0, -0.0, 1.0);
+        odd.push_back(INT64_C(1) << 40, -1.5, 1.5, nan);
+        odd.push_back(-(INT64_C(1) << 40), inf, -inf, tiny);
+        odd.push_back(-(INT64_C(1) << 40), 1e300, -1e-300, 0.0);
+        odd.push_back(INT64_C(9007199254740992), std::numeric_limits<double>::max(), tiny, -tiny);
+        CHECK(roundTrips(odd, codec, false));
+    }
+
+    // Gorilla stays within the documented 12-16 bytes per FX-like tick (raw: 24).
+    TickSeries ticks = randomTicks(4096, true);
+    std::vector<uint8_t> gorilla;
+    std::vector<uint8_t> raw;
+    encodeTickBlock(ticks, 0, ticks.size(), TickCodec::Gorilla, gorilla);
+    encodeTickBlock(ticks, 0, ticks.size(), TickCodec::Raw, raw);
+    CHECK(raw.size() == ticks.size() * 24);
+    CHECK(gorilla.size() <= ticks.size() * 16);
+
+    // A sub-range encodes only those ticks.
+    std::vector<uint8_t> payload;
+    TickBlockHeader h = encodeTickBlock(ticks, 100, 50, TickCodec::Gorilla, payload);
+    TickSeries out;
+    CHECK(decodeTickBlock(h, payload.data(), out));
+    CHECK(out.size() == 50 && out.timestampMs[0] == ticks.timestampMs[100] && out.bid[49] == ticks.bid[149]);
+
+    // A truncated or unknown payload fails and leaves the output untouched.
+    TickBlockHeader shortHeader = encodeTickBlock(ticks, 0, ticks.size(), TickCodec::Gorilla, payload);
+    shortHeader.payloadBytes = 64;
+    TickSeries untouched;
+    untouched.push_back(1, 2, 3, 4);
+    CHECK(!decodeTickBlock(shortHeader, payload.data(), untouched));
+    CHECK(untouched.size() == 1);
+    TickBlockHeader badCodec = h;
+    badCodec.codec = 9;
+    CHECK(!decodeTickBlock(badCodec, payload.data(), untouched));
+    CHECK(untouched.size() == 1);
+}
+
+// Ticks of one partition file, decoded block by block through its index.
+TickSeries readPartition(const std::string& base, int64_t& partitionStart) {
+    TickSeries out;
+    partitionStart = -1;
+    std::FILE* data = std::fopen((base + ".ticks").c_str(), "rb");
+    std::FILE* index = std::fopen((base + ".tidx").c_str(), "rb");
+    TickFileHeader header;
+    if (data && index && std::fread(&header, sizeof(header), 1, data) == 1 &&
+        std::memcmp(header.magic, TICK_FILE_MAGIC, 8) == 0) {
+        partitionStart = header.partitionStart;
+        TickIndexEntry e;
+        while (std::fread(&e, sizeof(e), 1, index) == 1) {
+            TickBlockHeader block;
+            std::vector<uint8_t> payload(e.payloadBytes);
+            std::fseek(data, static_cast<long>(e.offset), SEEK_SET);
+            if (std::fread(&block, sizeof(block), 1, data) != 1 ||
+                std::fread(payload.data(), 1, payload.size(), data) != payload.size() ||
+                !decodeTickBlock(block, payload.data(), out)) {
+                CHECK(!"unreadable block");
+                break;
+            }
+            CHECK(block.firstTs == e.firstTs && block.lastTs == e.lastTs && block.count == e.count);
+        }
+    }
+    if (data) std::fclose(data);
+    if (index) std::fclose(index);
+    return out;
+}
+
+void testPartitions(const std::string& root) {
+    // Hourly partitions, small blocks: ticks up to the last millisecond of 10:00,
+    // one exactly at 11:00, then some in 12:00 (11:00 holds just that tick).
+    TickSeries ticks;
+    for (int i = 0; i < 100; ++i) {
+        ticks.push_back(T0 + HOUR_MS - 100 + i, 1.1 + i * 1e-5, 1.1002 + i * 1e-5, 1.1001 + i * 1e-5);
+    }
+    ticks.push_back(T0 + HOUR_MS, 1.2, 1.2002, 1.2001);
+    for (int i = 0; i < 30; ++i) ticks.push_back(T0 + 2 * HOUR_MS + i * 1000, 1.3, 1.3002, 1.3001);
+
+    TickArchiveWriter::Options options;
+    options.partitionMs = HOUR_MS;
+    options.blockTicks = 16;
+    {
+        TickArchiveWriter writer(root, options);
+        CHECK(writer.append("EURUSD", ticks) == ticks.size());
+        TickSeries older;
+        older.push_back(T0, 1.0, 1.0, 1.0); // before the last archived tick: dropped
+        CHECK(writer.append("EURUSD", older) == 0);
+        CHECK(writer.ticksDropped() == 1);
+    }
+    CHECK(readTickArchivePartitionMs(root) == HOUR_MS);
+
+    TickSeries all;
+    for (int64_t p = T0; p < T0 + 3 * HOUR_MS; p += HOUR_MS) {
+        int64_t start = 0;
+        TickSeries part = readPartition(TickArchiveWriter::partitionPath(root, "EURUSD", p, HOUR_MS), start);
+        CHECK(start == p);
+        for (size_t i = 0; i < part.size(); ++i) {
+            CHECK(part.timestampMs[i] >= p && part.timestampMs[i] < p + HOUR_MS);
+            all.push_back(part.timestampMs[i], part.bid[i], part.ask[i], part.mid[i]);
+        }
+        CHECK(part.size() == (p == T0 ? 100u : p == T0 + HOUR_MS ? 1u : 30u));
+    }
+    CHECK(sameTicks(all, ticks));
+
+    // Reopening appends after what the partition already holds.
+    {
+        TickArchiveWriter writer(root, options);
+        TickSeries more;
+        more.push_back(T0 + 2 * HOUR_MS + 29000, 1.4, 1.4002, 1.4001); // equal to the last: kept
+        more.push_back(T0 + 2 * HOUR_MS + 28000, 1.4, 1.4002, 1.4001); // older: dropped
+        CHECK(writer.append("EURUSD", more) == 1);
+    }
+    int64_t start = 0;
+    const std::string last = TickArchiveWriter::partitionPath(root, "EURUSD", T0 + 2 * HOUR_MS, HOUR_MS);
+    CHECK(readPartition(last, start).size() == 31);
+
+    // The manifest pins the partitioning.
+    bool rejected = false;
+    try {
+        TickArchiveWriter daily(root);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    CHECK(rejected);
+}
+
+} // namespace
+
+int main() {
+    char dir[] = "/tmp/tick_codec_test.XXXXXX";
+    if (!::mkdtemp(dir)) {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    testCodecs();
+    testPartitions(std::string(dir) + "/archive");
+    std::system((std::string("rm -rf ") + dir).c_str());
+
+    if (checkFailures == 0) {
+        std::printf("ok: tick codecs and partitions\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
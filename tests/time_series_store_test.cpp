@@ -0,0 +1,149 @@
+// TimeSeriesStore gap computation and merging: held ranges that touch or overlap
+// merge, queries list only what is not held, and inserted bars replace the ones in
+// their range. Given the mock server, also checks that get() fetches only the gaps,
+// split at the per-request limit, and returns what a single fetch would.
+//
+//   time_series_store_test [<path to tradermade_mock_server>]
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "MockServerProcess.h"
+#include "TimeSeriesStore.h"
+#include "TraderMadeSDK.h"
+
+namespace {
+
+using Range = TimeSeriesStore::Range;
+
+const int64_t DAY_MS = 86400000;
+const int64_t JAN1 = 1735689600000LL; // 2025-01-01 00:00 UTC
+const TimeSeriesInterval DAILY = TimeSeriesInterval::Daily;
+
+int64_t day(int n) {
+    return JAN1 + (n - 1) * DAY_MS; // day(1) is Jan 1, day(32) Feb 1
+}
+
+// One daily bar per day in [first, last], all prices `price`.
+BarSeries dailyBars(int first, int last, double price) {
+    BarSeries bars;
+    for (int d = first; d <= last; ++d) bars.push_back(day(d), price, price, price, price);
+    return bars;
+}
+
+bool sameBars(const BarSeries& a, const BarSeries& b) {
+    return a.timestampMs == b.timestampMs && a.open == b.open && a.high == b.high && a.low == b.low &&
+           a.close == b.close;
+}
+
+void testGaps() {
+    TraderMade tm; // never called: every get() below is served from the store
+    TimeSeriesStore store(tm);
+    CHECK(store.missing("EURUSD", DAILY, 1, day(1), day(10)) == std::vector<Range>{Range(day(1), day(11))});
+
+    store.insert("EURUSD", DAILY, 1, dailyBars(1, 10, 1.0), day(1), day(11));
+    store.insert("EURUSD", DAILY, 1, dailyBars(20, 25, 2.0), day(20), day(26));
+    // Inclusive of the bar starting at endMs; a start inside a bar rounds down to it.
+    CHECK(store.missing("EURUSD", DAILY, 1, day(5), day(15)) == std::vector<Range>{Range(day(11), day(16))});
+    CHECK(store.missing("EURUSD", DAILY, 1, day(1) + 3600000, day(10)).empty());
+    CHECK((store.missing("EURUSD", DAILY, 1, day(1), day(31)) ==
+           std::vector<Range>{Range(day(11), day(20)), Range(day(26), day(32))}));
+
+    // Filling the hole between two held ranges merges all three.
+    store.insert("EURUSD", DAILY, 1, dailyBars(11, 19, 3.0), day(11), day(20));
+    CHECK(store.missing("EURUSD", DAILY, 1, day(1), day(25)).empty());
+    CHECK(store.barCount() == 25);
+    // An overlapping range merges too.
+    store.insert("EURUSD", DAILY, 1, dailyBars(24, 28, 4.0), day(24), day(29));
+    CHECK((store.missing("EURUSD", DAILY, 1, day(1), day(31)) == std::vector<Range>{Range(day(29), day(32))}));
+    CHECK(store.barCount() == 28);
+
+    // Cached queries need no request.
+    Result<BarSeries> bars = store.get("EURUSD", DAILY, 1, day(9), day(12));
+    CHECK(bars.ok() && bars.value().size() == 4);
+    if (bars) {
+        CHECK(bars.value().timestampMs.front() == day(9) && bars.value().timestampMs.back() == day(12));
+        CHECK(bars.value().close[1] == 1.0 && bars.value().close[2] == 3.0);
+    }
+    Result<BarSeries> byDate = store.get("EURUSD", DAILY, 1, "2025-01-20", "2025-01-28");
+    CHECK(byDate.ok() && byDate.value().size() == 9 && byDate.value().close[4] == 4.0);
+    CHECK(!store.get("EURUSD", DAILY, 1, "2025-01-20", "yesterday").ok());
+    CHECK(store.requests() == 0);
+
+    // Inserted bars replace the ones in their range, bars outside it stay.
+    BarSeries fix = dailyBars(5, 6, 9.0);
+    fix.push_back(day(30), 9.0, 9.0, 9.0, 9.0); // outside the covered range: ignored
+    store.insert("EURUSD", DAILY, 1, fix, day(4), day(8));
+    bars = store.get("EURUSD", DAILY, 1, day(3), day(8));
+    CHECK(bars.ok() && bars.value().size() == 4); // days 4 and 7 are gone
+    if (bars) {
+        CHECK(bars.value().timestampMs[1] == day(5) && bars.value().close[1] == 9.0);
+        CHECK(bars.value().timestampMs[3] == day(8) && bars.value().close[3] == 1.0);
+    }
+    CHECK(store.barCount() == 26);
+
+    // Series are kept apart by interval and period; clear() forgets one.
+    CHECK(store.missing("EURUSD", TimeSeriesInterval::Hourly, 1, day(2), day(2)).size() == 1);
+    CHECK(store.missing("GBPUSD", DAILY, 1, day(2), day(2)).size() == 1);
+    store.clear("EURUSD", DAILY, 1);
+    CHECK(store.barCount() == 0 && store.missing("EURUSD", DAILY, 1, day(2), day(2)).size() == 1);
+}
+
+void testFetch(const std::string& baseUrl) {
+    TraderMade tm;
+    tm.setRestApiKey("time-series-store-test");
+    tm.setBaseUrl(baseUrl);
+
+    // Only the gap after what is held is requested.
+    TimeSeriesStore store(tm);
+    Result<BarSeries> q1 = store.get("EURUSD", DAILY, 1, "2025-01-01", "2025-03-31");
+    CHECK(q1.ok() && store.requests() == 1);
+    CHECK(store.missing("EURUSD", DAILY, 1, day(1), day(90)).empty());
+    Result<BarSeries> q2 = store.get("EURUSD", DAILY, 1, "2025-02-01", "2025-04-30");
+    CHECK(q2.ok() && store.requests() == 2);
+    Result<BarSeries> q3 = store.get("EURUSD", DAILY, 1, "2025-01-15", "2025-04-15");
+    CHECK(q3.ok() && store.requests() == 2);
+
+    // What the pieces add up to matches one fetch of the whole range.
+    TimeSeriesStore fresh(tm);
+    Result<BarSeries> whole = fresh.get("EURUSD", DAILY, 1, "2025-01-01", "2025-04-30");
+    Result<BarSeries> pieced = store.get("EURUSD", DAILY, 1, "2025-01-01", "2025-04-30");
+    CHECK(whole.ok() && pieced.ok() && !whole.value().empty());
+    if (whole && pieced) {
+        CHECK(sameBars(whole.value(), pieced.value()));
+        CHECK(store.barCount() == whole.value().size());
+        CHECK(store.barsDownloaded() == whole.value().size());
+    }
+
+    // A gap longer than the per-request limit is split: 5 days of minutes, 2 per call.
+    Result<BarSeries> minutes = store.get("EURUSD", TimeSeriesInterval::Minute, 15, "2025-01-06 00:00",
+                                          "2025-01-10 23:45");
+    CHECK(minutes.ok() && store.requests() == 5);
+    if (minutes) {
+        const std::vector<int64_t>& t = minutes.value().timestampMs;
+        for (size_t i = 1; i < t.size(); ++i) CHECK(t[i] > t[i - 1] && t[i] % (15 * 60000) == 0);
+        CHECK(!t.empty() && t.front() >= day(6) && t.back() < day(11));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        MockServerProcess server(argv[1], {"--threads=1"});
+        if (!server.running()) {
+            std::fprintf(stderr, "cannot start %s\n", argv[1]);
+            return 2;
+        }
+        testFetch(server.baseUrl());
+    } else {
+        testGaps();
+    }
+
+    if (checkFailures == 0) {
+        std::printf("ok: time series store\n");
+    }
+    return checkFailures == 0 ? 0 : 1;
+}
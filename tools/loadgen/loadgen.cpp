@@ -0,0 +1,336 @@
+// tradermade_loadgen
+//
+// Drives a configurable mix of SDK calls from N threads against a base URL
+// (usually tradermade_mock_server) and reports throughput, latency
+// percentiles, CPU time per request and peak RSS.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "TraderMadeSDK.h"
+
+#include <sys/resource.h>
+#include <sys/time.h>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (true) {
+        size_t pos = s.find(sep, start);
+        out.push_back(s.substr(start, pos - start));
+        if (pos == std::string::npos) break;
+        start = pos + 1;
+    }
+    return out;
+}
+
+const std::vector<std::string> OPERATIONS = {
+    "live", "timeseries", "historical", "hourly", "minute", "tick", "convert",
+    "market_status", "market_timing", "live_list", "streaming_list", "crypto_list", "cfd_list", "pandas"
+};
+
+struct Options {
+    std::string baseUrl = "http://127.0.0.1:8080/api/v1";
+    std::string apiKey;
+    int threads = 4;
+    double duration = 10.0;     // seconds, ignored when requests > 0
+    long requests = 0;          // total requests across all threads
+    double rate = 0.0;          // target total requests per second, 0 = closed loop
+    std::vector<std::pair<std::string, int>> mix = {{"live", 1}};
+    std::vector<std::string> symbols = {"EURUSD", "GBPUSD", "USDJPY", "AUDUSD"};
+    std::string date = "2024-01-08";
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: tradermade_loadgen [options]\n"
+        "  --base-url=URL      API base URL (default http://127.0.0.1:8080/api/v1)\n"
+        "  --api-key=KEY       API key (default: $TRADERMADE_API_KEY, or \"loadgen\")\n"
+        "  --threads=N         concurrent worker threads (default 4)\n"
+        "  --duration=SECONDS  run time (default 10)\n"
+        "  --requests=N        stop after N requests instead of a duration\n"
+        "  --rate=N            open-loop target requests/second across all threads\n"
+        "  --mix=OP:W,...      weighted call mix (default live:1). Operations:\n"
+        "                      live, timeseries, historical, hourly, minute, tick, convert,\n"
+        "                      market_status, market_timing, live_list, streaming_list,\n"
+        "                      crypto_list, cfd_list, pandas\n"
+        "  --symbols=LIST      comma separated symbols to rotate through\n"
+        "  --date=YYYY-MM-DD   anchor date for historical calls (default 2024-01-08)\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options o;
+    const char* envKey = std::getenv("TRADERMADE_API_KEY");
+    o.apiKey = envKey ? envKey : "loadgen";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (name == "--help" || name == "-h") {
+            printUsage();
+            std::exit(0);
+        } else if (name == "--base-url") {
+            o.baseUrl = value;
+        } else if (name == "--api-key") {
+            o.apiKey = value;
+        } else if (name == "--threads") {
+            o.threads = std::max(1, std::stoi(value));
+        } else if (name == "--duration") {
+            o.duration = std::stod(value);
+        } else if (name == "--requests") {
+            o.requests = std::stol(value);
+        } else if (name == "--rate") {
+            o.rate = std::stod(value);
+        } else if (name == "--mix") {
+            o.mix.clear();
+            for (const std::string& item : split(value, ',')) {
+                size_t colon = item.find(':');
+                std::string op = item.substr(0, colon);
+                int weight = colon == std::string::npos ? 1 : std::stoi(item.substr(colon + 1));
+                if (std::find(OPERATIONS.begin(), OPERATIONS.end(), op) == OPERATIONS.end()) {
+                    throw std::invalid_argument("Unknown operation in mix: " + op);
+                }
+                if (weight > 0) o.mix.emplace_back(op, weight);
+            }
+            if (o.mix.empty()) throw std::invalid_argument("--mix needs at least one weighted operation.");
+        } else if (name == "--symbols") {
+            o.symbols = split(value, ',');
+        } else if (name == "--date") {
+            o.date = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    return o;
+}
+
+// Issues one SDK call for the given operation through the non-throwing API.
+Result<nlohmann::json> invoke(TraderMade& tm, const std::string& op, const std::string& symbol, const std::string& date) {
+    if (op == "live") {
+        return tm.tryGetLiveRates(symbol);
+    } else if (op == "timeseries") {
+        return tm.tryGetTimeSeriesData(symbol, date, date + " 23:00", "hourly", "1", "records");
+    } else if (op == "historical") {
+        return tm.tryGetHistoricalRates(date, symbol);
+    } else if (op == "hourly") {
+        return tm.tryGetHourlyHistoricalData(date + "-10:00", symbol);
+    } else if (op == "minute") {
+        return tm.tryGetMinuteHistoricalData(date + "-10:30", symbol);
+    } else if (op == "tick") {
+        return tm.tryGetTickHistoricalData(symbol, date + " 10:00", date + " 10:05", "json");
+    } else if (op == "convert") {
+        return tm.tryGetCurrencyConversion(symbol.substr(0, 3), symbol.substr(3, 3), 1000.0);
+    } else if (op == "market_status") {
+        return tm.tryGetOpenMarketStatus();
+    } else if (op == "market_timing") {
+        return tm.tryGetMarketOpenTiming();
+    } else if (op == "live_list") {
+        return tm.tryGetLiveCurrencyList();
+    } else if (op == "streaming_list") {
+        return tm.tryGetStreamingCurrencyList();
+    } else if (op == "crypto_list") {
+        return tm.tryGetCryptoList();
+    } else if (op == "cfd_list") {
+        return tm.tryGetCfdList();
+    } else if (op == "pandas") {
+        return tm.tryGetDataAsPandasDataFrame(symbol, date, date, "records", "ohlc");
+    }
+    return RequestError{ErrorCode::InvalidArgument, 0, "Unknown operation " + op};
+}
+
+const char* errorName(ErrorCode code) {
+    switch (code) {
+    case ErrorCode::InvalidArgument: return "invalid_argument";
+    case ErrorCode::NotConfigured: return "not_configured";
+    case ErrorCode::Transport: return "transport";
+    case ErrorCode::HttpStatus: return "http_status";
+    case ErrorCode::ApiError: return "api_error";
+    case ErrorCode::Parse: return "parse";
+    case ErrorCode::QuotaExhausted: return "quota_exhausted";
+    case ErrorCode::CircuitOpen: return "circuit_open";
+    case ErrorCode::Cancelled: return "cancelled";
+    }
+    return "other";
+}
+
+struct OpStats {
+    std::vector<double> latencies; // microseconds
+    long errors = 0;
+};
+
+struct ThreadResult {
+    std::map<std::string, OpStats> ops;
+    std::map<std::string, long> errorKinds;
+};
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+double cpuSeconds(const rusage& ru) {
+    return static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+void printLatencyRow(const std::string& label, std::vector<double>& lat, long errors, double elapsed) {
+    std::sort(lat.begin(), lat.end());
+    double mean = 0.0;
+    for (double v : lat) mean += v;
+    if (!lat.empty()) mean /= static_cast<double>(lat.size());
+    std::cout << std::left << std::setw(16) << label << std::right
+              << std::setw(10) << lat.size()
+              << std::setw(8) << errors
+              << std::setw(11) << std::fixed << std::setprecision(1) << static_cast<double>(lat.size()) / elapsed
+              << std::setw(10) << std::setprecision(2) << mean / 1000.0
+              << std::setw(10) << percentile(lat, 50) / 1000.0
+              << std::setw(10) << percentile(lat, 90) / 1000.0
+              << std::setw(10) << percentile(lat, 99) / 1000.0
+              << std::setw(10) << percentile(lat, 99.9) / 1000.0
+              << std::setw(10) << (lat.empty() ? 0.0 : lat.back() / 1000.0) << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        opts = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    std::vector<std::string> weighted;
+    for (const auto& m : opts.mix) {
+        for (int i = 0; i < m.second; ++i) weighted.push_back(m.first);
+    }
+
+    std::atomic<long> issued{0};
+    std::atomic<bool> stop{false};
+    std::vector<ThreadResult> results(static_cast<size_t>(opts.threads));
+    std::vector<std::thread> threads;
+
+    rusage before{};
+    rusage childrenBefore{};
+    getrusage(RUSAGE_SELF, &before);
+    getrusage(RUSAGE_CHILDREN, &childrenBefore);
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::microseconds(static_cast<int64_t>(opts.duration * 1e6));
+
+    for (int t = 0; t < opts.threads; ++t) {
+        threads.emplace_back([&, t] {
+            ThreadResult& result = results[static_cast<size_t>(t)];
+            TraderMade tm;
+            tm.setBaseUrl(opts.baseUrl);
+            tm.setRestApiKey(opts.apiKey);
+            std::mt19937_64 rng(static_cast<uint64_t>(t) * 7919 + 1);
+            std::uniform_int_distribution<size_t> pickOp(0, weighted.size() - 1);
+            std::uniform_int_distribution<size_t> pickSymbol(0, opts.symbols.size() - 1);
+            // Open-loop pacing: each thread owns an equal share of the target rate.
+            std::chrono::nanoseconds interval(0);
+            if (opts.rate > 0.0) {
+                interval = std::chrono::nanoseconds(static_cast<int64_t>(1e9 * opts.threads / opts.rate));
+            }
+            Clock::time_point next = start + interval * t / opts.threads;
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (opts.requests > 0) {
+                    if (issued.fetch_add(1, std::memory_order_relaxed) >= opts.requests) break;
+                } else if (Clock::now() >= deadline) {
+                    break;
+                }
+                if (interval.count() > 0) {
+                    std::this_thread::sleep_until(next);
+                    next += interval;
+                }
+                const std::string& op = weighted[pickOp(rng)];
+                const std::string& symbol = opts.symbols[pickSymbol(rng)];
+                // Latency is measured from the scheduled send time in open-loop mode to
+                // avoid coordinated omission.
+                Clock::time_point begin = interval.count() > 0 ? next - interval : Clock::now();
+                OpStats& os = result.ops[op];
+                Result<nlohmann::json> r = invoke(tm, op, symbol, opts.date);
+                if (!r) {
+                    ++os.errors;
+                    ++result.errorKinds[errorName(r.error().code)];
+                }
+                os.latencies.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    rusage after{};
+    rusage childrenAfter{};
+    getrusage(RUSAGE_SELF, &after);
+    getrusage(RUSAGE_CHILDREN, &childrenAfter);
+
+    std::map<std::string, OpStats> merged;
+    std::map<std::string, long> errorKinds;
+    for (ThreadResult& r : results) {
+        for (auto& kv : r.ops) {
+            OpStats& m = merged[kv.first];
+            m.latencies.insert(m.latencies.end(), kv.second.latencies.begin(), kv.second.latencies.end());
+            m.errors += kv.second.errors;
+        }
+        for (auto& kv : r.errorKinds) errorKinds[kv.first] += kv.second;
+    }
+
+    std::vector<double> all;
+    long totalErrors = 0;
+    for (auto& kv : merged) {
+        all.insert(all.end(), kv.second.latencies.begin(), kv.second.latencies.end());
+        totalErrors += kv.second.errors;
+    }
+    const double total = static_cast<double>(all.size());
+
+    std::cout << "base url: " << opts.baseUrl << ", threads: " << opts.threads
+              << ", elapsed: " << std::fixed << std::setprecision(2) << elapsed << " s\n\n";
+    std::cout << std::left << std::setw(16) << "operation" << std::right
+              << std::setw(10) << "requests" << std::setw(8) << "errors" << std::setw(11) << "req/s"
+              << std::setw(10) << "mean ms" << std::setw(10) << "p50" << std::setw(10) << "p90"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+    for (auto& kv : merged) {
+        printLatencyRow(kv.first, kv.second.latencies, kv.second.errors, elapsed);
+    }
+    printLatencyRow("total", all, totalErrors, elapsed);
+
+    double selfCpu = cpuSeconds(after) - cpuSeconds(before);
+    double childCpu = cpuSeconds(childrenAfter) - cpuSeconds(childrenBefore);
+    std::cout << "\nCPU time per request: " << std::setprecision(1)
+              << (total > 0 ? selfCpu / total * 1e6 : 0.0) << " us in-process, "
+              << (total > 0 ? childCpu / total * 1e6 : 0.0) << " us in child processes\n";
+    // ru_maxrss is reported in kilobytes on Linux and bytes on macOS.
+#ifdef __APPLE__
+    std::cout << "Peak RSS: " << after.ru_maxrss / (1024 * 1024) << " MiB\n";
+#else
+    std::cout << "Peak RSS: " << after.ru_maxrss / 1024 << " MiB\n";
+#endif
+    if (!errorKinds.empty()) {
+        std::cout << "Errors:";
+        for (auto& kv : errorKinds) std::cout << " " << kv.first << "=" << kv.second;
+        std::cout << "\n";
+    }
+    return totalErrors == 0 ? 0 : 2;
+}
@@ -0,0 +1,1645 @@
+// tradermade_mock_server
+//
+// Standalone HTTP/1.1 stand-in for the TraderMade REST API. Implements every
+// endpoint the SDK calls with synthetic (but deterministic and internally
+// consistent) market data, plus configurable latency, rate limits and error
+// injection, so services can be load tested without spending API quota.
+//
+// Point the SDK at it with:
+//     tm.setBaseUrl("http://127.0.0.1:8080/api/v1");
+// and a StreamingClient at ws://127.0.0.1:8080/feedadv.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <queue>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <csignal>
+#include <stdexcept>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "WebSocketProtocol.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<bool> stopRequested{false};
+
+void onSignal(int) {
+    stopRequested.store(true);
+}
+
+// --- Options ---
+
+struct LatencyModel {
+    enum Kind { NONE, FIXED, UNIFORM, NORMAL, EXPONENTIAL, LOGNORMAL };
+    Kind kind = NONE;
+    double a = 0.0; // milliseconds (or sigma for lognormal)
+    double b = 0.0;
+
+    double sample(std::mt19937_64& rng) const {
+        double ms = 0.0;
+        switch (kind) {
+        case NONE:
+            return 0.0;
+        case FIXED:
+            ms = a;
+            break;
+        case UNIFORM:
+            ms = std::uniform_real_distribution<double>(a, b)(rng);
+            break;
+        case NORMAL:
+            ms = std::normal_distribution<double>(a, b)(rng);
+            break;
+        case EXPONENTIAL:
+            ms = std::exponential_distribution<double>(1.0 / a)(rng);
+            break;
+        case LOGNORMAL:
+            ms = std::lognormal_distribution<double>(std::log(a), b)(rng);
+            break;
+        }
+        return std::max(0.0, ms);
+    }
+};
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (true) {
+        size_t pos = s.find(sep, start);
+        out.push_back(s.substr(start, pos - start));
+        if (pos == std::string::npos) break;
+        start = pos + 1;
+    }
+    return out;
+}
+
+LatencyModel parseLatency(const std::string& spec) {
+    LatencyModel m;
+    std::vector<std::string> p = split(spec, ':');
+    auto num = [&](size_t i) {
+        if (i >= p.size()) {
+            throw std::invalid_argument("Invalid latency spec: " + spec);
+        }
+        return std::stod(p[i]);
+    };
+    if (p[0] == "none") {
+        m.kind = LatencyModel::NONE;
+    } else if (p[0] == "fixed") {
+        m.kind = LatencyModel::FIXED;
+        m.a = num(1);
+    } else if (p[0] == "uniform") {
+        m.kind = LatencyModel::UNIFORM;
+        m.a = num(1);
+        m.b = num(2);
+    } else if (p[0] == "normal") {
+        m.kind = LatencyModel::NORMAL;
+        m.a = num(1);
+        m.b = num(2);
+    } else if (p[0] == "exp") {
+        m.kind = LatencyModel::EXPONENTIAL;
+        m.a = num(1);
+    } else if (p[0] == "lognormal") {
+        m.kind = LatencyModel::LOGNORMAL;
+        m.a = num(1);
+        m.b = num(2);
+    } else {
+        throw std::invalid_argument("Invalid latency spec: " + spec);
+    }
+    return m;
+}
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    LatencyModel latency;
+    double rateLimit = 0.0;      // requests per second per api key, 0 = unlimited
+    double burst = 0.0;          // bucket size, defaults to rateLimit
+    double errorRate = 0.0;      // probability of injecting an error
+    std::vector<std::string> errorKinds = {"500"};
+    int maxTickMinutes = 60;
+    bool requireKey = true;
+    int statsInterval = 0;       // seconds, 0 = only on exit
+    int streamIntervalMs = 100;  // WebSocket quote period
+    int streamDisconnectAfter = 0; // close each stream after N quotes, 0 = never
+    uint64_t seed = 42;
+    std::vector<std::string> unquoted; // /live rejects these symbols
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: tradermade_mock_server [options]\n"
+        "  --host=ADDR             listen address (default 127.0.0.1)\n"
+        "  --port=N                listen port (default 8080)\n"
+        "  --threads=N             worker threads (default: hardware concurrency)\n"
+        "  --latency=SPEC          none | fixed:MS | uniform:MIN:MAX | normal:MEAN:SD |\n"
+        "                          exp:MEAN | lognormal:MEDIAN:SIGMA\n"
+        "  --rate-limit=N          requests per second per api key (0 = unlimited)\n"
+        "  --burst=N               token bucket size (default = rate limit)\n"
+        "  --error-rate=P          probability [0,1] of injecting an error\n"
+        "  --error-kinds=LIST      comma separated: 400,401,403,429,500,502,503,api,malformed,reset\n"
+        "  --max-tick-minutes=N    maximum tick_historical range (default 60)\n"
+        "  --no-auth               accept requests without api_key\n"
+        "  --stats=SECONDS         print counters periodically\n"
+        "  --stream-interval=MS    /feedadv WebSocket quote period (default 100)\n"
+        "  --stream-disconnect-after=N  close each stream after N quotes (0 = never)\n"
+        "  --seed=N                RNG seed for latency and error injection\n"
+        "  --unquoted=LIST         comma separated symbols /live rejects (e.g. an exotic cross)\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string name = arg;
+        std::string value;
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            name = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+        }
+        if (name == "--help" || name == "-h") {
+            printUsage();
+            std::exit(0);
+        } else if (name == "--host") {
+            o.host = value;
+        } else if (name == "--port") {
+            o.port = std::stoi(value);
+        } else if (name == "--threads") {
+            o.threads = std::max(1, std::stoi(value));
+        } else if (name == "--latency") {
+            o.latency = parseLatency(value);
+        } else if (name == "--rate-limit") {
+            o.rateLimit = std::stod(value);
+        } else if (name == "--burst") {
+            o.burst = std::stod(value);
+        } else if (name == "--error-rate") {
+            o.errorRate = std::stod(value);
+        } else if (name == "--error-kinds") {
+            o.errorKinds = split(value, ',');
+        } else if (name == "--max-tick-minutes") {
+            o.maxTickMinutes = std::stoi(value);
+        } else if (name == "--no-auth") {
+            o.requireKey = false;
+        } else if (name == "--stats") {
+            o.statsInterval = std::stoi(value);
+        } else if (name == "--stream-interval") {
+            o.streamIntervalMs = std::max(1, std::stoi(value));
+        } else if (name == "--stream-disconnect-after") {
+            o.streamDisconnectAfter = std::max(0, std::stoi(value));
+        } else if (name == "--seed") {
+            o.seed = std::stoull(value);
+        } else if (name == "--unquoted") {
+            o.unquoted = split(value, ',');
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (o.burst <= 0.0) {
+        o.burst = std::max(1.0, o.rateLimit);
+    }
+    return o;
+}
+
+// --- Counters ---
+
+struct Stats {
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> ok{0};
+    std::atomic<uint64_t> clientErrors{0};
+    std::atomic<uint64_t> serverErrors{0};
+    std::atomic<uint64_t> rateLimited{0};
+    std::atomic<uint64_t> injected{0};
+    std::atomic<uint64_t> connections{0};
+    std::atomic<uint64_t> streams{0};
+    std::atomic<uint64_t> streamQuotes{0};
+};
+
+Stats stats;
+
+// --- Rate limiting (token bucket per api key) ---
+
+class RateLimiter {
+public:
+    RateLimiter(double rate, double burst) : rate(rate), burst(burst) {}
+
+    bool allow(const std::string& key, Clock::time_point now) {
+        if (rate <= 0.0) return true;
+        Stripe& s = stripes[std::hash<std::string>()(key) % stripes.size()];
+        std::lock_guard<std::mutex> lock(s.m);
+        auto it = s.buckets.find(key);
+        if (it == s.buckets.end()) {
+            it = s.buckets.emplace(key, Bucket{burst, now}).first;
+        }
+        Bucket& b = it->second;
+        double elapsed = std::chrono::duration<double>(now - b.last).count();
+        b.tokens = std::min(burst, b.tokens + elapsed * rate);
+        b.last = now;
+        if (b.tokens < 1.0) return false;
+        b.tokens -= 1.0;
+        return true;
+    }
+
+private:
+    struct Bucket {
+        double tokens;
+        Clock::time_point last;
+    };
+    struct Stripe {
+        std::mutex m;
+        std::unordered_map<std::string, Bucket> buckets;
+    };
+
+    double rate;
+    double burst;
+    std::array<Stripe, 32> stripes;
+};
+
+// --- Calendar helpers (UTC, proleptic Gregorian) ---
+
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+const int64_t MS_PER_MINUTE = 60000;
+const int64_t MS_PER_HOUR = 3600000;
+const int64_t MS_PER_DAY = 86400000;
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Accepts "YYYY-MM-DD", "YYYY-MM-DD HH:MM[:SS[.mmm]]", "YYYY-MM-DD-HH:MM" and "YYYY-MM-DDTHH:MM".
+bool parseDateTime(const std::string& s, int64_t& ms) {
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, sec = 0, milli = 0;
+    if (s.size() < 10 || std::sscanf(s.c_str(), "%4d-%2d-%2d", &y, &mo, &d) != 3) {
+        return false;
+    }
+    if (mo < 1 || mo > 12 || d < 1 || d > 31) return false;
+    if (s.size() > 10) {
+        const char* rest = s.c_str() + 11;
+        int n = std::sscanf(rest, "%2d:%2d:%2d.%3d", &h, &mi, &sec, &milli);
+        if (n < 2 || h > 24 || mi > 59 || sec > 60) return false;
+    }
+    ms = daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * MS_PER_DAY +
+         h * MS_PER_HOUR + mi * MS_PER_MINUTE + sec * 1000 + milli;
+    return true;
+}
+
+std::string formatTime(int64_t ms, bool withTime, bool withSeconds, bool withMillis) {
+    int64_t days = floorDiv(ms, MS_PER_DAY);
+    int64_t rem = ms - days * MS_PER_DAY;
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    char buf[48];
+    int n = std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", static_cast<int>(y), m, d);
+    if (withTime) {
+        n += std::snprintf(buf + n, sizeof(buf) - n, " %02d:%02d",
+                           static_cast<int>(rem / MS_PER_HOUR), static_cast<int>(rem / MS_PER_MINUTE % 60));
+        if (withSeconds) {
+            n += std::snprintf(buf + n, sizeof(buf) - n, ":%02d", static_cast<int>(rem / 1000 % 60));
+        }
+        if (withMillis) {
+            std::snprintf(buf + n, sizeof(buf) - n, ".%03d", static_cast<int>(rem % 1000));
+        }
+    }
+    return buf;
+}
+
+// 0 = Sunday ... 6 = Saturday
+int weekday(int64_t ms) {
+    int64_t days = floorDiv(ms, MS_PER_DAY);
+    return static_cast<int>(((days % 7) + 11) % 7);
+}
+
+std::string httpDate(int64_t ms) {
+    static const char* DAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static const char* MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int64_t days = floorDiv(ms, MS_PER_DAY);
+    int64_t rem = ms - days * MS_PER_DAY;
+    int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%s, %02u %s %04d %02d:%02d:%02d GMT",
+                  DAYS[weekday(ms)], d, MONTHS[m - 1], static_cast<int>(y),
+                  static_cast<int>(rem / MS_PER_HOUR), static_cast<int>(rem / MS_PER_MINUTE % 60),
+                  static_cast<int>(rem / 1000 % 60));
+    return buf;
+}
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// --- Synthetic market data ---
+
+uint64_t fnv1a(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+double unit(uint64_t x) {
+    return static_cast<double>(mix(x) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+struct CurrencyInfo {
+    const char* code;
+    const char* name;
+    double usdValue;
+    bool crypto;
+};
+
+const CurrencyInfo CURRENCIES[] = {
+    {"USD", "US Dollar", 1.0, false},
+    {"EUR", "Euro", 1.085, false},
+    {"GBP", "British Pound", 1.27, false},
+    {"JPY", "Japanese Yen", 0.0067, false},
+    {"CHF", "Swiss Franc", 1.12, false},
+    {"AUD", "Australian Dollar", 0.66, false},
+    {"CAD", "Canadian Dollar", 0.74, false},
+    {"NZD", "New Zealand Dollar", 0.61, false},
+    {"SEK", "Swedish Krona", 0.095, false},
+    {"NOK", "Norwegian Krone", 0.094, false},
+    {"DKK", "Danish Krone", 0.1455, false},
+    {"PLN", "Polish Zloty", 0.25, false},
+    {"CZK", "Czech Koruna", 0.043, false},
+    {"HUF", "Hungarian Forint", 0.0028, false},
+    {"TRY", "Turkish Lira", 0.031, false},
+    {"ZAR", "South African Rand", 0.054, false},
+    {"MXN", "Mexican Peso", 0.059, false},
+    {"BRL", "Brazilian Real", 0.2, false},
+    {"CNH", "Chinese Yuan Offshore", 0.138, false},
+    {"HKD", "Hong Kong Dollar", 0.128, false},
+    {"SGD", "Singapore Dollar", 0.74, false},
+    {"INR", "Indian Rupee", 0.012, false},
+    {"AED", "UAE Dirham", 0.2723, false},
+    {"SAR", "Saudi Riyal", 0.2667, false},
+    {"XAU", "Gold", 2350.0, false},
+    {"XAG", "Silver", 28.0, false},
+    {"BTC", "Bitcoin", 64000.0, true},
+    {"ETH", "Ethereum", 3100.0, true},
+    {"LTC", "Litecoin", 82.0, true},
+    {"XRP", "Ripple", 0.52, true},
+    {"SOL", "Solana", 145.0, true},
+    {"ADA", "Cardano", 0.45, true},
+};
+
+struct CfdInfo {
+    const char* code;
+    const char* name;
+    double price;
+};
+
+const CfdInfo CFDS[] = {
+    {"UK100", "UK 100 Index", 8150.0},
+    {"US30", "Wall Street 30", 39000.0},
+    {"SPX500", "US 500 Index", 5200.0},
+    {"NAS100", "US Tech 100", 18200.0},
+    {"GER30", "Germany 30 Index", 18100.0},
+    {"FRA40", "France 40 Index", 8000.0},
+    {"JPN225", "Japan 225 Index", 38500.0},
+    {"AUS200", "Australia 200 Index", 7700.0},
+    {"HKG33", "Hong Kong 33 Index", 17800.0},
+    {"OIL", "US Crude Oil", 78.0},
+    {"UKOIL", "Brent Crude Oil", 82.0},
+    {"NATGAS", "Natural Gas", 2.4},
+};
+
+const std::vector<std::string> STREAMING_PAIRS = {
+    "EURUSD", "GBPUSD", "USDJPY", "USDCHF", "AUDUSD", "USDCAD", "NZDUSD", "EURGBP",
+    "EURJPY", "GBPJPY", "EURCHF", "AUDJPY", "XAUUSD", "XAGUSD", "BTCUSD", "ETHUSD"
+};
+
+const CurrencyInfo* findCurrency(const std::string& code) {
+    for (const CurrencyInfo& c : CURRENCIES) {
+        if (code == c.code) return &c;
+    }
+    return nullptr;
+}
+
+const CfdInfo* findCfd(const std::string& code) {
+    for (const CfdInfo& c : CFDS) {
+        if (code == c.code) return &c;
+    }
+    return nullptr;
+}
+
+struct Instrument {
+    std::string symbol;
+    std::string base;
+    std::string quote;
+    double price = 0.0;
+    double spread = 0.0; // relative
+    bool pair = false;
+    bool alwaysOpen = false;
+};
+
+bool resolveInstrument(const std::string& symbol, Instrument& out) {
+    out.symbol = symbol;
+    if (const CfdInfo* cfd = findCfd(symbol)) {
+        out.pair = false;
+        out.price = cfd->price;
+        out.spread = 0.0002;
+        return true;
+    }
+    if (symbol.size() != 6) return false;
+    const CurrencyInfo* base = findCurrency(symbol.substr(0, 3));
+    const CurrencyInfo* quote = findCurrency(symbol.substr(3, 3));
+    if (!base || !quote || base == quote) return false;
+    out.pair = true;
+    out.base = base->code;
+    out.quote = quote->code;
+    out.price = base->usdValue / quote->usdValue;
+    out.alwaysOpen = base->crypto || quote->crypto;
+    out.spread = out.alwaysOpen ? 0.0008 : 0.00006;
+    return true;
+}
+
+// FX and CFD markets close from Friday 22:00 to Sunday 22:00 UTC.
+bool isWeekendClosed(int64_t ms) {
+    int wd = weekday(ms);
+    int64_t tod = ms - floorDiv(ms, MS_PER_DAY) * MS_PER_DAY;
+    if (wd == 6) return true;
+    if (wd == 5 && tod >= 22 * MS_PER_HOUR) return true;
+    if (wd == 0 && tod < 22 * MS_PER_HOUR) return true;
+    return false;
+}
+
+// Deterministic mid price: a few slow waves plus per-250ms jitter. Cross rates stay
+// consistent because every currency follows its own USD curve.
+double usdCurve(const std::string& code, double usdValue, int64_t ms) {
+    if (code == "USD") return 1.0;
+    uint64_t h = fnv1a(code);
+    double x = static_cast<double>(ms) / 1000.0;
+    const double TAU = 6.283185307179586;
+    double drift = 0.012 * std::sin(TAU * x / (86400.0 * 29) + unit(h) * TAU) +
+                   0.004 * std::sin(TAU * x / 86400.0 + unit(h + 1) * TAU) +
+                   0.0009 * std::sin(TAU * x / 3600.0 + unit(h + 2) * TAU) +
+                   0.00025 * std::sin(TAU * x / 300.0 + unit(h + 3) * TAU) +
+                   0.00006 * (unit(h ^ static_cast<uint64_t>(floorDiv(ms, 250))) - 0.5);
+    return usdValue * (1.0 + drift);
+}
+
+double midAt(const Instrument& inst, int64_t ms) {
+    if (!inst.pair) {
+        return usdCurve(inst.symbol, inst.price, ms);
+    }
+    const CurrencyInfo* b = findCurrency(inst.base);
+    const CurrencyInfo* q = findCurrency(inst.quote);
+    return usdCurve(inst.base, b->usdValue, ms) / usdCurve(inst.quote, q->usdValue, ms);
+}
+
+struct Bar {
+    double open, high, low, close;
+};
+
+Bar barAt(const Instrument& inst, int64_t startMs, int64_t endMs) {
+    Bar bar;
+    bar.open = midAt(inst, startMs);
+    bar.close = midAt(inst, endMs - 1);
+    bar.high = std::max(bar.open, bar.close);
+    bar.low = std::min(bar.open, bar.close);
+    const int SAMPLES = 24;
+    int64_t step = std::max<int64_t>(1, (endMs - startMs) / SAMPLES);
+    for (int64_t t = startMs + step; t < endMs - 1; t += step) {
+        double p = midAt(inst, t);
+        bar.high = std::max(bar.high, p);
+        bar.low = std::min(bar.low, p);
+    }
+    return bar;
+}
+
+double decimalsFor(double price) {
+    if (price >= 1000.0) return 100.0;
+    if (price >= 20.0) return 1000.0;
+    return 100000.0;
+}
+
+double roundPrice(double price) {
+    double scale = decimalsFor(price);
+    return std::round(price * scale) / scale;
+}
+
+void addPairFields(json& j, const Instrument& inst) {
+    if (inst.pair) {
+        j["base_currency"] = inst.base;
+        j["quote_currency"] = inst.quote;
+    } else {
+        j["instrument"] = inst.symbol;
+    }
+}
+
+// --- HTTP plumbing ---
+
+struct Request {
+    std::string method;
+    std::string path;
+    std::map<std::string, std::string> query;
+    bool keepAlive = true;
+    std::string webSocketKey; // set when the request asks for a WebSocket upgrade
+};
+
+struct Response {
+    int status = 200;
+    std::string body;
+    std::string contentType = "application/json";
+    bool reset = false;
+};
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string urlDecode(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '%' && i + 2 < s.size() && hexValue(s[i + 1]) >= 0 && hexValue(s[i + 2]) >= 0) {
+            out += static_cast<char>(hexValue(s[i + 1]) * 16 + hexValue(s[i + 2]));
+            i += 2;
+        } else if (s[i] == '+') {
+            out += ' ';
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
+
+Response errorResponse(int status, const std::string& message) {
+    Response r;
+    r.status = status;
+    r.body = json{{"error", status}, {"message", message}}.dump();
+    return r;
+}
+
+std::string param(const Request& req, const char* name) {
+    auto it = req.query.find(name);
+    return it == req.query.end() ? std::string() : it->second;
+}
+
+// --- Endpoint handlers ---
+
+class Api {
+public:
+    explicit Api(const Options& opts) : opts(opts) {}
+
+    Response handle(const Request& req) const {
+        const std::string prefix = "/api/v1";
+        std::string path = req.path;
+        if (path.compare(0, prefix.size(), prefix) == 0) {
+            path = path.substr(prefix.size());
+        }
+        if (opts.requireKey && param(req, "api_key").empty()) {
+            return errorResponse(401, "api_key is required");
+        }
+
+        if (path == "/live") return live(req);
+        if (path == "/live_currencies_list") return currencyList(false);
+        if (path == "/live_crypto_list") return currencyList(true);
+        if (path == "/historical_currencies_list") return currencyList(false);
+        if (path == "/streaming_currencies_list") return streamingList();
+        if (path == "/cfd_list") return cfdList();
+        if (path == "/historical") return historical(req);
+        if (path == "/hour_historical") return intradayHistorical(req, "hour_historical", MS_PER_HOUR);
+        if (path == "/minute_historical") return intradayHistorical(req, "minute_historical", MS_PER_MINUTE);
+        if (path == "/timeseries") return timeseries(req);
+        if (path == "/market_open_status") return marketOpenStatus();
+        if (path == "/market_opening_times") return marketOpeningTimes();
+        if (path == "/convert") return convert(req);
+        if (path == "/pandasDF") return pandasDF(req);
+        if (path.compare(0, 24, "/tick_historical_sample/") == 0) return ticks(req, path.substr(24), true);
+        if (path.compare(0, 17, "/tick_historical/") == 0) return ticks(req, path.substr(17), false);
+        return errorResponse(404, "Unknown endpoint " + req.path);
+    }
+
+private:
+    const Options& opts;
+
+    static Response ok(json body) {
+        Response r;
+        r.body = body.dump();
+        return r;
+    }
+
+    Response live(const Request& req) const {
+        std::string currency = param(req, "currency");
+        if (currency.empty()) return errorResponse(400, "currency is required");
+        int64_t now = nowMs();
+        json quotes = json::array();
+        for (const std::string& symbol : split(currency, ',')) {
+            Instrument inst;
+            if (!resolveInstrument(symbol, inst) ||
+                std::find(opts.unquoted.begin(), opts.unquoted.end(), symbol) != opts.unquoted.end()) {
+                quotes.push_back({{"error", 400}, {"instrument", symbol}, {"message", "Invalid currency code"}});
+                continue;
+            }
+            double mid = midAt(inst, now);
+            json q;
+            addPairFields(q, inst);
+            q["bid"] = roundPrice(mid * (1.0 - inst.spread / 2));
+            q["ask"] = roundPrice(mid * (1.0 + inst.spread / 2));
+            q["mid"] = roundPrice(mid);
+            quotes.push_back(q);
+        }
+        return ok({{"endpoint", "live"},
+                   {"quotes", quotes},
+                   {"requested_time", httpDate(now)},
+                   {"timestamp", now / 1000}});
+    }
+
+    Response currencyList(bool crypto) const {
+        json available = json::object();
+        for (const CurrencyInfo& c : CURRENCIES) {
+            if (c.crypto == crypto) available[c.code] = c.name;
+        }
+        return ok({{"available_currencies", available},
+                   {"endpoint", crypto ? "live_crypto_list" : "live_currencies_list"}});
+    }
+
+    Response streamingList() const {
+        json available = json::object();
+        for (const std::string& s : STREAMING_PAIRS) {
+            const CurrencyInfo* b = findCurrency(s.substr(0, 3));
+            const CurrencyInfo* q = findCurrency(s.substr(3, 3));
+            available[s] = std::string(b->name) + " " + q->name;
+        }
+        return ok({{"available_currencies", available}, {"endpoint", "streaming_currencies_list"}});
+    }
+
+    Response cfdList() const {
+        json instruments = json::array();
+        for (const CfdInfo& c : CFDS) {
+            instruments.push_back({{"instrument", c.code}, {"name", c.name}});
+        }
+        return ok({{"endpoint", "cfd_list"}, {"instruments", instruments}});
+    }
+
+    Response historical(const Request& req) const {
+        std::string date = param(req, "date");
+        std::string currency = param(req, "currency");
+        int64_t day = 0;
+        if (currency.empty() || !parseDateTime(date, day)) {
+            return errorResponse(400, "currency and a valid date (YYYY-MM-DD) are required");
+        }
+        day = floorDiv(day, MS_PER_DAY) * MS_PER_DAY;
+        return ok({{"date", formatTime(day, false, false, false)},
+                   {"endpoint", "historical"},
+                   {"quotes", ohlcQuotes(currency, day, day + MS_PER_DAY)},
+                   {"request_time", httpDate(nowMs())}});
+    }
+
+    Response intradayHistorical(const Request& req, const char* endpoint, int64_t width) const {
+        std::string dateTime = param(req, "date_time");
+        std::string currency = param(req, "currency");
+        int64_t t = 0;
+        if (currency.empty() || !parseDateTime(dateTime, t)) {
+            return errorResponse(400, "currency and a valid date_time (YYYY-MM-DD-HH:MM) are required");
+        }
+        t = floorDiv(t, width) * width;
+        std::string stamp = formatTime(t, false, false, false) + "-" + formatTime(t, true, false, false).substr(11);
+        return ok({{"date_time", stamp},
+                   {"endpoint", endpoint},
+                   {"quotes", ohlcQuotes(currency, t, t + width)},
+                   {"request_time", httpDate(nowMs())}});
+    }
+
+    static json ohlcQuotes(const std::string& currency, int64_t start, int64_t end) {
+        json quotes = json::array();
+        for (const std::string& symbol : split(currency, ',')) {
+            Instrument inst;
+            if (!resolveInstrument(symbol, inst)) {
+                quotes.push_back({{"error", 400}, {"instrument", symbol}, {"message", "Invalid currency code"}});
+                continue;
+            }
+            Bar bar = barAt(inst, start, end);
+            json q;
+            addPairFields(q, inst);
+            q["open"] = roundPrice(bar.open);
+            q["high"] = roundPrice(bar.high);
+            q["low"] = roundPrice(bar.low);
+            q["close"] = roundPrice(bar.close);
+            quotes.push_back(q);
+        }
+        return quotes;
+    }
+
+    struct Series {
+        std::vector<int64_t> times;
+        std::vector<Bar> bars;
+    };
+
+    static bool validPeriod(const std::string& interval, int period) {
+        static const std::map<std::string, std::vector<int>> PERIODS = {
+            {"daily", {1}}, {"hourly", {1, 2, 4, 6, 8, 24}}, {"minute", {1, 5, 10, 15, 30}}};
+        auto it = PERIODS.find(interval);
+        return it != PERIODS.end() &&
+               std::find(it->second.begin(), it->second.end(), period) != it->second.end();
+    }
+
+    static Series buildSeries(const Instrument& inst, int64_t start, int64_t end, int64_t width) {
+        Series s;
+        start = floorDiv(start, width) * width;
+        for (int64_t t = start; t <= end; t += width) {
+            if (!inst.alwaysOpen && width < MS_PER_DAY && isWeekendClosed(t)) continue;
+            if (!inst.alwaysOpen && width >= MS_PER_DAY && (weekday(t) == 0 || weekday(t) == 6)) continue;
+            s.times.push_back(t);
+            s.bars.push_back(barAt(inst, t, t + width));
+        }
+        return s;
+    }
+
+    // Renders rows in one of the pandas orientations the API supports.
+    static Response renderFrame(const std::vector<std::string>& dates,
+                                const std::vector<std::string>& columns,
+                                const std::vector<std::vector<double>>& rows,
+                                const std::string& format,
+                                json envelope) {
+        if (format == "csv") {
+            Response r;
+            r.contentType = "text/csv";
+            r.body = "date";
+            for (const std::string& c : columns) r.body += "," + c;
+            r.body += "\n";
+            char buf[64];
+            for (size_t i = 0; i < rows.size(); ++i) {
+                r.body += dates[i];
+                for (double v : rows[i]) {
+                    std::snprintf(buf, sizeof(buf), ",%.10g", v);
+                    r.body += buf;
+                }
+                r.body += "\n";
+            }
+            return r;
+        }
+        json data;
+        if (format == "records") {
+            data = json::array();
+            for (size_t i = 0; i < rows.size(); ++i) {
+                json row = {{"date", dates[i]}};
+                for (size_t c = 0; c < columns.size(); ++c) row[columns[c]] = rows[i][c];
+                data.push_back(row);
+            }
+        } else if (format == "index") {
+            data = json::object();
+            for (size_t i = 0; i < rows.size(); ++i) {
+                json row = json::object();
+                for (size_t c = 0; c < columns.size(); ++c) row[columns[c]] = rows[i][c];
+                data[dates[i]] = row;
+            }
+        } else if (format == "columns") {
+            data = json::object();
+            for (size_t c = 0; c < columns.size(); ++c) {
+                json col = json::object();
+                for (size_t i = 0; i < rows.size(); ++i) col[dates[i]] = rows[i][c];
+                data[columns[c]] = col;
+            }
+        } else if (format == "split") {
+            data = {{"columns", columns}, {"index", dates}, {"data", rows}};
+        } else {
+            return errorResponse(400, "Invalid format " + format);
+        }
+        if (envelope.is_null()) {
+            return ok(data);
+        }
+        envelope["quotes"] = data;
+        return ok(envelope);
+    }
+
+    Response timeseries(const Request& req) const {
+        std::string currency = param(req, "currency");
+        std::string interval = param(req, "interval");
+        std::string format = param(req, "format");
+        std::string periodText = param(req, "period");
+        if (interval.empty()) interval = "daily";
+        if (format.empty()) format = "records";
+        int period = periodText.empty() ? 1 : std::atoi(periodText.c_str());
+        int64_t start = 0, end = 0;
+        Instrument inst;
+        if (!resolveInstrument(currency, inst)) return errorResponse(400, "Invalid currency " + currency);
+        if (!parseDateTime(param(req, "start_date"), start) || !parseDateTime(param(req, "end_date"), end) ||
+            end < start) {
+            return errorResponse(400, "Invalid start_date/end_date");
+        }
+        if (!validPeriod(interval, period)) return errorResponse(400, "Invalid interval/period");
+
+        int64_t width = interval == "daily" ? MS_PER_DAY
+                      : interval == "hourly" ? period * MS_PER_HOUR
+                      : period * MS_PER_MINUTE;
+        int64_t maxRange = interval == "daily" ? 365 * MS_PER_DAY
+                         : interval == "hourly" ? 60 * MS_PER_DAY
+                         : 2 * MS_PER_DAY;
+        if (end - start > maxRange) return errorResponse(400, "Requested range too large for interval");
+
+        Series s = buildSeries(inst, start, end, width);
+        std::vector<std::string> dates;
+        std::vector<std::vector<double>> rows;
+        for (size_t i = 0; i < s.times.size(); ++i) {
+            dates.push_back(formatTime(s.times[i], width < MS_PER_DAY, false, false));
+            const Bar& b = s.bars[i];
+            rows.push_back({roundPrice(b.open), roundPrice(b.high), roundPrice(b.low), roundPrice(b.close)});
+        }
+        json envelope = {{"endpoint", "timeseries"},
+                         {"start_date", param(req, "start_date")},
+                         {"end_date", param(req, "end_date")},
+                         {"request_time", httpDate(nowMs())}};
+        addPairFields(envelope, inst);
+        return renderFrame(dates, {"open", "high", "low", "close"}, rows, format, envelope);
+    }
+
+    Response pandasDF(const Request& req) const {
+        std::string currency = param(req, "currency");
+        std::string format = param(req, "format");
+        std::string fields = param(req, "fields");
+        int64_t start = 0, end = 0;
+        Instrument inst;
+        if (!resolveInstrument(currency, inst)) return errorResponse(400, "Invalid currency " + currency);
+        if (!parseDateTime(param(req, "start_date"), start) || !parseDateTime(param(req, "end_date"), end) ||
+            end < start) {
+            return errorResponse(400, "Invalid start_date/end_date");
+        }
+        if (fields != "close" && fields != "ohlc") return errorResponse(400, "Invalid fields");
+        if (format == "csv") return errorResponse(400, "Invalid format");
+
+        Series s = buildSeries(inst, start, end, MS_PER_DAY);
+        std::vector<std::string> dates;
+        std::vector<std::vector<double>> rows;
+        for (size_t i = 0; i < s.times.size(); ++i) {
+            dates.push_back(formatTime(s.times[i], false, false, false));
+            const Bar& b = s.bars[i];
+            if (fields == "close") {
+                rows.push_back({roundPrice(b.close)});
+            } else {
+                rows.push_back({roundPrice(b.open), roundPrice(b.high), roundPrice(b.low), roundPrice(b.close)});
+            }
+        }
+        std::vector<std::string> columns = fields == "close"
+            ? std::vector<std::string>{"close"}
+            : std::vector<std::string>{"open", "high", "low", "close"};
+        return renderFrame(dates, columns, rows, format, json());
+    }
+
+    Response ticks(const Request& req, const std::string& rest, bool sample) const {
+        // rest = SYMBOL/START/END (START/END already url-decoded by the parser)
+        std::vector<std::string> parts = split(rest, '/');
+        if (parts.size() != 3) return errorResponse(400, "Expected /SYMBOL/START/END");
+        Instrument inst;
+        if (!resolveInstrument(parts[0], inst)) return errorResponse(400, "Invalid currency " + parts[0]);
+        int64_t start = 0, end = 0;
+        if (!parseDateTime(parts[1], start) || !parseDateTime(parts[2], end) || end <= start) {
+            return errorResponse(400, "Invalid start/end date");
+        }
+        if (end - start > opts.maxTickMinutes * MS_PER_MINUTE) {
+            return errorResponse(400, "Maximum tick range is " + std::to_string(opts.maxTickMinutes) + " minutes");
+        }
+        std::string format = param(req, "format");
+        if (format.empty()) format = "csv";
+        if (format != "csv" && format != "json") return errorResponse(400, "Invalid format " + format);
+
+        uint64_t h = fnv1a(inst.symbol);
+        int64_t maxGap = sample ? 20000 : 900;
+        std::vector<int64_t> times;
+        for (int64_t t = start; t < end;) {
+            if (inst.alwaysOpen || !isWeekendClosed(t)) times.push_back(t);
+            t += 50 + static_cast<int64_t>(unit(h ^ static_cast<uint64_t>(t)) * maxGap);
+        }
+
+        if (format == "csv") {
+            Response r;
+            r.contentType = "text/csv";
+            r.body = "date,bid,ask,mid\n";
+            char buf[160];
+            for (int64_t t : times) {
+                double mid = midAt(inst, t);
+                std::snprintf(buf, sizeof(buf), "%s,%.10g,%.10g,%.10g\n",
+                              formatTime(t, true, true, true).c_str(),
+                              roundPrice(mid * (1.0 - inst.spread / 2)),
+                              roundPrice(mid * (1.0 + inst.spread / 2)),
+                              roundPrice(mid));
+                r.body += buf;
+            }
+            return r;
+        }
+        json quotes = json::array();
+        for (int64_t t : times) {
+            double mid = midAt(inst, t);
+            quotes.push_back({{"date", formatTime(t, true, true, true)},
+                              {"bid", roundPrice(mid * (1.0 - inst.spread / 2))},
+                              {"ask", roundPrice(mid * (1.0 + inst.spread / 2))},
+                              {"mid", roundPrice(mid)}});
+        }
+        json body = {{"endpoint", sample ? "tick_historical_sample" : "tick_historical"},
+                     {"start_date", parts[1]},
+                     {"end_date", parts[2]},
+                     {"quotes", quotes},
+                     {"request_time", httpDate(nowMs())}};
+        addPairFields(body, inst);
+        return ok(body);
+    }
+
+    Response convert(const Request& req) const {
+        std::string from = param(req, "from");
+        std::string to = param(req, "to");
+        std::string amountText = param(req, "amount");
+        const CurrencyInfo* f = findCurrency(from);
+        const CurrencyInfo* t = findCurrency(to);
+        if (!f || !t) return errorResponse(400, "Invalid from/to currency");
+        char* endPtr = nullptr;
+        double amount = std::strtod(amountText.c_str(), &endPtr);
+        if (amountText.empty() || *endPtr != '\0') return errorResponse(400, "Invalid amount");
+        int64_t now = nowMs();
+        double rate = usdCurve(from, f->usdValue, now) / usdCurve(to, t->usdValue, now);
+        return ok({{"base_currency", from},
+                   {"endpoint", "convert"},
+                   {"quote", roundPrice(rate)},
+                   {"quote_currency", to},
+                   {"requested_time", httpDate(now)},
+                   {"timestamp", now / 1000},
+                   {"total", amount * roundPrice(rate)}});
+    }
+
+    // Weekly trading sessions in UTC; day 0 = Sunday.
+    struct Session {
+        int openDay, openMinute, closeDay, closeMinute;
+    };
+
+    struct Market {
+        const char* name;
+        std::vector<Session> sessions;
+    };
+
+    static const std::vector<Market>& markets() {
+        static const std::vector<Market> MARKETS = [] {
+            std::vector<Market> m;
+            m.push_back({"Forex", {{0, 22 * 60, 5, 22 * 60}}});
+            m.push_back({"Crypto", {{0, 0, 6, 24 * 60}}});
+            Market sydney{"Sydney", {}}, tokyo{"Tokyo", {}}, london{"London", {}}, newYork{"New York", {}};
+            for (int d = 0; d < 5; ++d) sydney.sessions.push_back({d, 21 * 60, d + 1, 6 * 60});
+            for (int d = 1; d <= 5; ++d) {
+                tokyo.sessions.push_back({d, 0, d, 9 * 60});
+                london.sessions.push_back({d, 8 * 60, d, 16 * 60 + 30});
+                newYork.sessions.push_back({d, 13 * 60 + 30, d, 20 * 60});
+            }
+            m.push_back(sydney);
+            m.push_back(tokyo);
+            m.push_back(london);
+            m.push_back(newYork);
+            return m;
+        }();
+        return MARKETS;
+    }
+
+    static std::string dayName(int d) {
+        static const char* NAMES[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+        return NAMES[((d % 7) + 7) % 7];
+    }
+
+    static std::string hhmm(int minute) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%02d:%02d", minute / 60, minute % 60);
+        return buf;
+    }
+
+    static bool isOpen(const Market& m, int64_t ms) {
+        const int64_t WEEK = 7 * 1440;
+        int64_t minuteOfWeek = weekday(ms) * 1440 + (ms - floorDiv(ms, MS_PER_DAY) * MS_PER_DAY) / MS_PER_MINUTE;
+        for (const Session& s : m.sessions) {
+            int64_t open = s.openDay * 1440 + s.openMinute;
+            int64_t close = s.closeDay * 1440 + s.closeMinute;
+            for (int64_t shift = -WEEK; shift <= 0; shift += WEEK) {
+                if (minuteOfWeek >= open + shift && minuteOfWeek < close + shift) return true;
+            }
+        }
+        return false;
+    }
+
+    Response marketOpeningTimes() const {
+        json list = json::array();
+        for (const Market& m : markets()) {
+            json sessions = json::array();
+            for (const Session& s : m.sessions) {
+                sessions.push_back({{"open_day", dayName(s.openDay)},
+                                    {"open_time", hhmm(s.openMinute)},
+                                    {"close_day", dayName(s.closeDay)},
+                                    {"close_time", hhmm(s.closeMinute)}});
+            }
+            list.push_back({{"market", m.name}, {"timezone", "UTC"}, {"sessions", sessions}});
+        }
+        return ok({{"endpoint", "market_opening_times"}, {"markets", list}});
+    }
+
+    Response marketOpenStatus() const {
+        int64_t now = nowMs();
+        json list = json::array();
+        for (const Market& m : markets()) {
+            list.push_back({{"market", m.name}, {"status", isOpen(m, now) ? "Open" : "Closed"}});
+        }
+        return ok({{"endpoint", "market_open_status"}, {"markets", list}, {"requested_time", httpDate(now)}});
+    }
+};
+
+// --- Event loop ---
+
+struct Pending {
+    Clock::time_point due;
+    std::string bytes;
+    bool close;
+    bool reset;
+};
+
+struct Connection {
+    int fd = -1;
+    uint64_t generation = 0;
+    std::string in;
+    std::string out;
+    size_t outOffset = 0;
+    std::deque<Pending> queued;
+    bool closeAfterFlush = false;
+    bool writable = true;
+    bool webSocket = false;
+    std::vector<Instrument> streamSymbols;
+    uint64_t streamQuotes = 0;
+};
+
+struct Timer {
+    Clock::time_point due;
+    int fd;
+    uint64_t generation;
+    bool operator>(const Timer& o) const { return due > o.due; }
+};
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+int openListener(const Options& opts) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("socket() failed");
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#ifdef SO_REUSEPORT
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+#endif
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(opts.port));
+    if (inet_pton(AF_INET, opts.host.c_str(), &addr.sin_addr) != 1) {
+        ::close(fd);
+        throw std::invalid_argument("Invalid host address: " + opts.host);
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        throw std::runtime_error("bind() failed: " + std::string(std::strerror(errno)));
+    }
+    if (listen(fd, 4096) != 0) {
+        ::close(fd);
+        throw std::runtime_error("listen() failed");
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+class Worker {
+public:
+    Worker(const Options& opts, const Api& api, RateLimiter& limiter, uint64_t seed)
+        : opts(opts), api(api), limiter(limiter), rng(seed) {}
+
+    void run() {
+        listenFd = openListener(opts);
+        epollFd = epoll_create1(0);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+        std::array<epoll_event, 256> events;
+        while (!stopRequested.load(std::memory_order_relaxed)) {
+            int timeout = 100;
+            if (!streams.empty()) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextStreamTick - Clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(timeout, wait.count())));
+            }
+            if (!timers.empty()) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(timers.top().due - Clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(timeout, wait.count())));
+            }
+            int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeout);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                auto it = conns.find(fd);
+                if (it == conns.end()) continue;
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    closeConnection(fd);
+                    continue;
+                }
+                if (events[i].events & EPOLLIN) onReadable(it->second);
+                it = conns.find(fd);
+                if (it != conns.end() && (events[i].events & EPOLLOUT)) flush(it->second);
+            }
+            fireTimers();
+            fireStreams();
+        }
+        for (auto& kv : conns) ::close(kv.first);
+        ::close(epollFd);
+        ::close(listenFd);
+    }
+
+private:
+    const Options& opts;
+    const Api& api;
+    RateLimiter& limiter;
+    std::mt19937_64 rng;
+    int listenFd = -1;
+    int epollFd = -1;
+    uint64_t nextGeneration = 1;
+    std::unordered_map<int, Connection> conns;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::vector<int> streams; // WebSocket connections
+    Clock::time_point nextStreamTick;
+
+    void acceptAll() {
+        while (true) {
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            setNonBlocking(fd);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            Connection& c = conns[fd];
+            c = Connection();
+            c.fd = fd;
+            c.generation = nextGeneration++;
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            stats.connections.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void closeConnection(int fd) {
+        streams.erase(std::remove(streams.begin(), streams.end(), fd), streams.end());
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        conns.erase(fd);
+    }
+
+    void onReadable(Connection& c) {
+        char buf[16384];
+        while (true) {
+            ssize_t r = ::recv(c.fd, buf, sizeof(buf), 0);
+            if (r > 0) {
+                c.in.append(buf, static_cast<size_t>(r));
+                continue;
+            }
+            if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                closeConnection(c.fd);
+                return;
+            }
+            break;
+        }
+        int fd = c.fd;
+        if (c.webSocket) {
+            processFrames(c);
+            return;
+        }
+        processRequests(c);
+        auto it = conns.find(fd);
+        if (it != conns.end()) promoteReady(it->second);
+    }
+
+    void processRequests(Connection& c) {
+        size_t consumed = 0;
+        while (true) {
+            size_t end = c.in.find("\r\n\r\n", consumed);
+            if (end == std::string::npos) break;
+            Request req;
+            if (!parseRequest(c.in, consumed, end, req)) {
+                enqueue(c, errorResponse(400, "Malformed request"), false, 0.0);
+                c.in.clear();
+                return;
+            }
+            consumed = end + 4;
+            if (!req.webSocketKey.empty() && req.path == "/feedadv") {
+                c.in.erase(0, consumed);
+                upgrade(c, req.webSocketKey);
+                return;
+            }
+            respond(c, req);
+        }
+        c.in.erase(0, consumed);
+        if (c.in.size() > 65536) closeConnection(c.fd);
+    }
+
+    static bool parseRequest(const std::string& buf, size_t begin, size_t end, Request& req) {
+        size_t lineEnd = buf.find("\r\n", begin);
+        std::string line = buf.substr(begin, lineEnd - begin);
+        size_t sp1 = line.find(' ');
+        size_t sp2 = line.rfind(' ');
+        if (sp1 == std::string::npos || sp2 == sp1) return false;
+        req.method = line.substr(0, sp1);
+        std::string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        bool http10 = line.compare(sp2 + 1, std::string::npos, "HTTP/1.0") == 0;
+        req.keepAlive = !http10;
+
+        size_t q = target.find('?');
+        req.path = urlDecode(target.substr(0, q));
+        if (q != std::string::npos) {
+            for (const std::string& kv : split(target.substr(q + 1), '&')) {
+                if (kv.empty()) continue;
+                size_t eq = kv.find('=');
+                req.query[urlDecode(kv.substr(0, eq))] =
+                    eq == std::string::npos ? std::string() : urlDecode(kv.substr(eq + 1));
+            }
+        }
+
+        for (size_t pos = lineEnd + 2; pos < end;) {
+            size_t next = buf.find("\r\n", pos);
+            if (next == std::string::npos || next > end) next = end;
+            std::string header = buf.substr(pos, next - pos);
+            std::transform(header.begin(), header.end(), header.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            if (header.compare(0, 11, "connection:") == 0) {
+                if (header.find("close") != std::string::npos) req.keepAlive = false;
+                if (header.find("keep-alive") != std::string::npos) req.keepAlive = true;
+            } else if (header.compare(0, 18, "sec-websocket-key:") == 0) {
+                // Keys are case sensitive, so take the value from the original buffer.
+                std::string value = buf.substr(pos + 18, next - pos - 18);
+                value.erase(0, value.find_first_not_of(' '));
+                value.erase(value.find_last_not_of(' ') + 1);
+                req.webSocketKey = value;
+            }
+            pos = next + 2;
+        }
+        return true;
+    }
+
+    Response injectedError(const std::string& kind) {
+        stats.injected.fetch_add(1, std::memory_order_relaxed);
+        if (kind == "api") {
+            Response r;
+            r.body = json{{"error", 400}, {"message", "Injected API error"}}.dump();
+            return r;
+        }
+        if (kind == "malformed") {
+            Response r;
+            r.body = "{\"endpoint\": \"live\", \"quotes\": [{\"bid\": 1.0";
+            return r;
+        }
+        if (kind == "reset") {
+            Response r;
+            r.reset = true;
+            return r;
+        }
+        int status = std::atoi(kind.c_str());
+        return errorResponse(status >= 400 ? status : 500, "Injected error");
+    }
+
+    void respond(Connection& c, const Request& req) {
+        stats.requests.fetch_add(1, std::memory_order_relaxed);
+        Response resp;
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        if (req.method != "GET") {
+            resp = errorResponse(400, "Only GET is supported");
+        } else if (!limiter.allow(param(req, "api_key"), Clock::now())) {
+            stats.rateLimited.fetch_add(1, std::memory_order_relaxed);
+            resp = errorResponse(429, "Rate limit exceeded");
+        } else if (opts.errorRate > 0.0 && coin(rng) < opts.errorRate) {
+            std::uniform_int_distribution<size_t> pick(0, opts.errorKinds.size() - 1);
+            resp = injectedError(opts.errorKinds[pick(rng)]);
+        } else {
+            resp = api.handle(req);
+        }
+        if (resp.status >= 500) {
+            stats.serverErrors.fetch_add(1, std::memory_order_relaxed);
+        } else if (resp.status >= 400) {
+            stats.clientErrors.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            stats.ok.fetch_add(1, std::memory_order_relaxed);
+        }
+        enqueue(c, resp, !req.keepAlive, opts.latency.sample(rng));
+    }
+
+    void enqueue(Connection& c, const Response& resp, bool close, double delayMs) {
+        Pending p;
+        p.due = Clock::now() + std::chrono::microseconds(static_cast<int64_t>(delayMs * 1000.0));
+        // Keep pipelined responses in order.
+        if (!c.queued.empty() && c.queued.back().due > p.due) p.due = c.queued.back().due;
+        p.close = close;
+        p.reset = resp.reset;
+        if (!resp.reset) {
+            char head[256];
+            int n = std::snprintf(head, sizeof(head),
+                                  "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n",
+                                  resp.status, reasonPhrase(resp.status), resp.contentType.c_str(),
+                                  resp.body.size(), close ? "close" : "keep-alive");
+            p.bytes.reserve(static_cast<size_t>(n) + resp.body.size());
+            p.bytes.append(head, static_cast<size_t>(n));
+            p.bytes.append(resp.body);
+        }
+        if (delayMs > 0.0) timers.push(Timer{p.due, c.fd, c.generation});
+        c.queued.push_back(std::move(p));
+    }
+
+    void promoteReady(Connection& c) {
+        Clock::time_point now = Clock::now();
+        while (!c.queued.empty() && c.queued.front().due <= now) {
+            Pending& p = c.queued.front();
+            if (p.reset) {
+                linger lg{1, 0};
+                setsockopt(c.fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+                closeConnection(c.fd);
+                return;
+            }
+            c.out.append(p.bytes);
+            if (p.close) c.closeAfterFlush = true;
+            c.queued.pop_front();
+            if (c.closeAfterFlush) {
+                c.queued.clear();
+                break;
+            }
+        }
+        flush(c);
+    }
+
+    void flush(Connection& c) {
+        while (c.outOffset < c.out.size()) {
+            ssize_t w = ::send(c.fd, c.out.data() + c.outOffset, c.out.size() - c.outOffset, MSG_NOSIGNAL);
+            if (w > 0) {
+                c.outOffset += static_cast<size_t>(w);
+                continue;
+            }
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            closeConnection(c.fd);
+            return;
+        }
+        c.out.clear();
+        c.outOffset = 0;
+        if (c.closeAfterFlush) closeConnection(c.fd);
+    }
+
+    // --- WebSocket streaming (/feedadv) ---
+    //
+    // Mirrors the TraderMade feed: "Connected" on open, the client sends
+    // {"userKey":"...","symbol":"EURUSD,GBPUSD"}, then the server pushes
+    // {"symbol","ts","bid","ask","mid"} for each subscribed symbol every tick.
+
+    void upgrade(Connection& c, const std::string& key) {
+        // Earlier pipelined HTTP responses still waiting on latency are dropped.
+        c.queued.clear();
+        std::string head = "HTTP/1.1 101 Switching Protocols\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Accept: " + WebSocket::acceptKey(key) + "\r\n\r\n";
+        c.out.append(head);
+        WebSocket::appendFrame(c.out, WebSocket::TEXT, "Connected", 9, false);
+        c.webSocket = true;
+        if (streams.empty()) nextStreamTick = Clock::now();
+        streams.push_back(c.fd);
+        stats.streams.fetch_add(1, std::memory_order_relaxed);
+        int fd = c.fd;
+        flush(c);
+        auto it = conns.find(fd);
+        if (it != conns.end() && !it->second.in.empty()) processFrames(it->second);
+    }
+
+    void processFrames(Connection& c) {
+        int fd = c.fd;
+        size_t offset = 0;
+        while (true) {
+            WebSocket::Frame frame;
+            long n = WebSocket::parseFrame(&c.in[offset], c.in.size() - offset, frame, 65536);
+            if (n < 0) {
+                closeConnection(fd);
+                return;
+            }
+            if (n == 0) break;
+            offset += static_cast<size_t>(n);
+            if (frame.opcode == WebSocket::PING) {
+                WebSocket::appendFrame(c.out, WebSocket::PONG, frame.payload, frame.length, false);
+            } else if (frame.opcode == WebSocket::CLOSE) {
+                WebSocket::appendFrame(c.out, WebSocket::CLOSE, frame.payload, std::min<size_t>(frame.length, 2), false);
+                c.closeAfterFlush = true;
+                break;
+            } else if (frame.opcode == WebSocket::TEXT) {
+                subscribe(c, std::string(frame.payload, frame.length));
+            }
+        }
+        c.in.erase(0, offset);
+        flush(c);
+    }
+
+    void subscribe(Connection& c, const std::string& text) {
+        json msg = json::parse(text, nullptr, false);
+        if (msg.is_discarded() || !msg.is_object()) return;
+        if (opts.requireKey && msg.value("userKey", std::string()).empty()) {
+            const char reason[] = "\x03\xf0userKey is required"; // 1008 policy violation
+            WebSocket::appendFrame(c.out, WebSocket::CLOSE, reason, sizeof(reason) - 1, false);
+            c.closeAfterFlush = true;
+            return;
+        }
+        c.streamSymbols.clear();
+        for (const std::string& symbol : split(msg.value("symbol", std::string()), ',')) {
+            Instrument inst;
+            if (resolveInstrument(symbol, inst)) c.streamSymbols.push_back(inst);
+        }
+    }
+
+    void fireStreams() {
+        if (streams.empty()) return;
+        Clock::time_point now = Clock::now();
+        if (now < nextStreamTick) return;
+        nextStreamTick = now + std::chrono::milliseconds(opts.streamIntervalMs);
+        int64_t ms = nowMs();
+        std::vector<int> fds = streams;
+        for (int fd : fds) {
+            auto it = conns.find(fd);
+            if (it == conns.end()) continue;
+            Connection& c = it->second;
+            if (c.closeAfterFlush) continue;
+            for (const Instrument& inst : c.streamSymbols) {
+                double mid = midAt(inst, ms);
+                char payload[160];
+                int n = std::snprintf(payload, sizeof(payload),
+                                      "{\"symbol\":\"%s\",\"ts\":\"%lld\",\"bid\":%.10g,\"ask\":%.10g,\"mid\":%.10g}",
+                                      inst.symbol.c_str(), static_cast<long long>(ms),
+                                      roundPrice(mid * (1.0 - inst.spread / 2)),
+                                      roundPrice(mid * (1.0 + inst.spread / 2)), roundPrice(mid));
+                WebSocket::appendFrame(c.out, WebSocket::TEXT, payload, static_cast<size_t>(n), false);
+                ++c.streamQuotes;
+                stats.streamQuotes.fetch_add(1, std::memory_order_relaxed);
+                if (opts.streamDisconnectAfter > 0 && c.streamQuotes >= static_cast<uint64_t>(opts.streamDisconnectAfter)) {
+                    WebSocket::appendFrame(c.out, WebSocket::CLOSE, "\x03\xe9", 2, false); // 1001 going away
+                    c.closeAfterFlush = true;
+                    break;
+                }
+            }
+            flush(c);
+        }
+    }
+
+    void fireTimers() {
+        Clock::time_point now = Clock::now();
+        while (!timers.empty() && timers.top().due <= now) {
+            Timer t = timers.top();
+            timers.pop();
+            auto it = conns.find(t.fd);
+            if (it != conns.end() && it->second.generation == t.generation) promoteReady(it->second);
+        }
+    }
+};
+
+void printStats() {
+    std::cout << "requests=" << stats.requests.load()
+              << " ok=" << stats.ok.load()
+              << " 4xx=" << stats.clientErrors.load()
+              << " 5xx=" << stats.serverErrors.load()
+              << " rate_limited=" << stats.rateLimited.load()
+              << " injected=" << stats.injected.load()
+              << " connections=" << stats.connections.load()
+              << " streams=" << stats.streams.load()
+              << " stream_quotes=" << stats.streamQuotes.load() << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        opts = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Api api(opts);
+    RateLimiter limiter(opts.rateLimit, opts.burst);
+
+    // Bind once up front so configuration errors are reported before threads start.
+    try {
+        ::close(openListener(opts));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < opts.threads; ++i) {
+        workers.push_back(std::make_unique<Worker>(opts, api, limiter, opts.seed + static_cast<uint64_t>(i)));
+    }
+    for (auto& w : workers) {
+        Worker* worker = w.get();
+        threads.emplace_back([worker] {
+            try {
+                worker->run();
+            } catch (const std::exception& e) {
+                std::cerr << "worker failed: " << e.what() << std::endl;
+                stopRequested.store(true);
+            }
+        });
+    }
+
+    std::cout << "TraderMade mock server listening on http://" << opts.host << ":" << opts.port
+              << "/api/v1 with " << opts.threads << " thread(s)" << std::endl;
+
+    int elapsed = 0;
+    while (!stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        elapsed += 200;
+        if (opts.statsInterval > 0 && elapsed >= opts.statsInterval * 1000) {
+            elapsed = 0;
+            printStats();
+        }
+    }
+    for (auto& t : threads) t.join();
+    printStats();
+    return 0;
+}
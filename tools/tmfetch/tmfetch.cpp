@@ -0,0 +1,537 @@
+// tmfetch
+//
+// Bulk downloader built on the SDK: ticks, time series or daily historical rates for
+// many symbols and a date range, fetched in parallel (BackfillEngine) and written as
+// CSV, a columnar tick archive or Arrow IPC files. Prints throughput and request
+// latency when done. Ctrl-C aborts the transfers in flight and saves the checkpoint.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "TraderMadeSDK.h"
+#include "TraderMadeDecode.h"
+#include "BackfillEngine.h"
+#include "TickArchive.h"
+#include "ArrowIpcWriter.h"
+
+#include <sys/stat.h>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (true) {
+        size_t pos = s.find(sep, start);
+        out.push_back(s.substr(start, pos - start));
+        if (pos == std::string::npos) break;
+        start = pos + 1;
+    }
+    return out;
+}
+
+struct Options {
+    std::string baseUrl;
+    std::string apiKey;
+    std::string kind = "ticks";      // ticks | timeseries | historical
+    std::vector<std::string> symbols;
+    std::string start;
+    std::string end;
+    std::string interval = "daily";
+    int period = 1;
+    std::string format = "csv";      // csv | archive | arrow
+    std::string out = "tmfetch_out";
+    int threads = 8;
+    double rate = 0.0;
+    int attempts = 4;
+    std::string checkpoint;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: tmfetch --symbols=LIST --start=DATE --end=DATE [options]\n"
+        "  --kind=KIND         ticks | timeseries | historical (default ticks)\n"
+        "  --symbols=LIST      comma separated symbols, e.g. EURUSD,GBPUSD\n"
+        "  --start=DATE        YYYY-MM-DD or \"YYYY-MM-DD HH:MM\" (UTC, inclusive)\n"
+        "  --end=DATE          same format, exclusive\n"
+        "  --interval=NAME     timeseries: daily | hourly | minute (default daily)\n"
+        "  --period=N          timeseries period (default 1)\n"
+        "  --format=FORMAT     csv | archive | arrow (default csv; archive is ticks only)\n"
+        "  --out=DIR           output directory (default tmfetch_out)\n"
+        "  --threads=N         parallel requests (default 8)\n"
+        "  --rate=N            maximum requests per second (default unlimited)\n"
+        "  --attempts=N        tries per request for 429/5xx/transport errors (default 4)\n"
+        "  --checkpoint=FILE   resume file (ticks, timeseries); rerunning the same command\n"
+        "                      continues from it\n"
+        "  --base-url=URL      API base URL (default: the SDK's)\n"
+        "  --api-key=KEY       API key (default: $TRADERMADE_API_KEY)\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options o;
+    const char* envKey = std::getenv("TRADERMADE_API_KEY");
+    o.apiKey = envKey ? envKey : "";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (name == "--help" || name == "-h") {
+            printUsage();
+            std::exit(0);
+        } else if (name == "--base-url") {
+            o.baseUrl = value;
+        } else if (name == "--api-key") {
+            o.apiKey = value;
+        } else if (name == "--kind") {
+            o.kind = value;
+        } else if (name == "--symbols") {
+            o.symbols = split(value, ',');
+        } else if (name == "--start") {
+            o.start = value;
+        } else if (name == "--end") {
+            o.end = value;
+        } else if (name == "--interval") {
+            o.interval = value;
+        } else if (name == "--period") {
+            o.period = std::stoi(value);
+        } else if (name == "--format") {
+            o.format = value;
+        } else if (name == "--out") {
+            o.out = value;
+        } else if (name == "--threads") {
+            o.threads = std::max(1, std::stoi(value));
+        } else if (name == "--rate") {
+            o.rate = std::stod(value);
+        } else if (name == "--attempts") {
+            o.attempts = std::max(1, std::stoi(value));
+        } else if (name == "--checkpoint") {
+            o.checkpoint = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    if (o.kind != "ticks" && o.kind != "timeseries" && o.kind != "historical") {
+        throw std::invalid_argument("--kind must be ticks, timeseries or historical.");
+    }
+    if (o.format != "csv" && o.format != "archive" && o.format != "arrow") {
+        throw std::invalid_argument("--format must be csv, archive or arrow.");
+    }
+    if (o.format == "archive" && o.kind != "ticks") {
+        throw std::invalid_argument("--format=archive stores ticks only.");
+    }
+    o.symbols.erase(std::remove(o.symbols.begin(), o.symbols.end(), std::string()), o.symbols.end());
+    if (o.symbols.empty() || o.start.empty() || o.end.empty()) {
+        throw std::invalid_argument("--symbols, --start and --end are required.");
+    }
+    if (o.apiKey.empty()) {
+        throw std::invalid_argument("No API key: pass --api-key or set TRADERMADE_API_KEY.");
+    }
+    return o;
+}
+
+TimeSeriesInterval parseInterval(const std::string& name) {
+    if (name == "daily") return TimeSeriesInterval::Daily;
+    if (name == "hourly") return TimeSeriesInterval::Hourly;
+    if (name == "minute") return TimeSeriesInterval::Minute;
+    throw std::invalid_argument("--interval must be daily, hourly or minute.");
+}
+
+int64_t parseTime(const std::string& text, const char* option) {
+    int64_t ms = 0;
+    if (!parseApiTime(text, ms)) {
+        throw std::invalid_argument(std::string(option) + " is not YYYY-MM-DD[ HH:MM]: " + text);
+    }
+    return ms;
+}
+
+// Like mkdir -p.
+void makeDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos && slash > 0) makeDirectory(path.substr(0, slash));
+    if (::mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Cannot create directory " + path + ": " + std::strerror(errno));
+    }
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm" (ticks), "YYYY-MM-DD HH:MM" (intraday bars) or "YYYY-MM-DD".
+std::string formatTimestamp(int64_t ms, bool ticks, bool withTime) {
+    if (!ticks) {
+        return formatApiTime(ms, withTime);
+    }
+    int64_t minute = ms - ((ms % 60000) + 60000) % 60000;
+    char tail[16];
+    std::snprintf(tail, sizeof(tail), ":%02d.%03d", static_cast<int>((ms - minute) / 1000),
+                  static_cast<int>((ms - minute) % 1000));
+    return formatApiTime(minute, true) + tail;
+}
+
+// --- Outputs. Calls are serialized by the engine (or the historical loop). ---
+
+class Output {
+public:
+    virtual ~Output() = default;
+    virtual void ticks(const std::string& symbol, const TickSeries& ticks) = 0;
+    virtual void bars(const std::string& symbol, const BarSeries& bars) = 0;
+    virtual void flush() {}
+    virtual void close() {}
+    virtual uint64_t bytes() const = 0;
+};
+
+class CsvOutput : public Output {
+public:
+    CsvOutput(const std::string& dir, const std::string& suffix, bool withTime)
+        : dir(dir), suffix(suffix), withTime(withTime) {}
+    ~CsvOutput() override { close(); }
+
+    void ticks(const std::string& symbol, const TickSeries& t) override {
+        std::FILE* f = file(symbol, "date,bid,ask,mid\n");
+        char line[160];
+        for (size_t i = 0; i < t.size(); ++i) {
+            int n = std::snprintf(line, sizeof(line), "%s,%.10g,%.10g,%.10g\n",
+                                  formatTimestamp(t.timestampMs[i], true, true).c_str(), t.bid[i], t.ask[i], t.mid[i]);
+            write(f, line, static_cast<size_t>(n));
+        }
+    }
+
+    void bars(const std::string& symbol, const BarSeries& b) override {
+        std::FILE* f = file(symbol, "date,open,high,low,close\n");
+        char line[192];
+        for (size_t i = 0; i < b.size(); ++i) {
+            int n = std::snprintf(line, sizeof(line), "%s,%.10g,%.10g,%.10g,%.10g\n",
+                                  formatTimestamp(b.timestampMs[i], false, withTime).c_str(), b.open[i], b.high[i],
+                                  b.low[i], b.close[i]);
+            write(f, line, static_cast<size_t>(n));
+        }
+    }
+
+    void flush() override {
+        for (auto& kv : files) std::fflush(kv.second);
+    }
+
+    void close() override {
+        for (auto& kv : files) std::fclose(kv.second);
+        files.clear();
+    }
+
+    uint64_t bytes() const override { return written; }
+
+private:
+    std::string dir;
+    std::string suffix;
+    bool withTime;
+    std::map<std::string, std::FILE*> files;
+    uint64_t written = 0;
+
+    // Appends when resuming from a checkpoint, so earlier rows are kept.
+    std::FILE* file(const std::string& symbol, const char* header) {
+        auto it = files.find(symbol);
+        if (it != files.end()) return it->second;
+        std::string path = dir + "/" + symbol + suffix + ".csv";
+        std::FILE* f = std::fopen(path.c_str(), "ab");
+        if (!f) throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+        std::fseek(f, 0, SEEK_END);
+        if (std::ftell(f) == 0) write(f, header, std::strlen(header));
+        files[symbol] = f;
+        return f;
+    }
+
+    void write(std::FILE* f, const char* data, size_t size) {
+        if (std::fwrite(data, 1, size, f) != size) throw std::runtime_error("CSV write failed.");
+        written += size;
+    }
+};
+
+class ArchiveOutput : public Output {
+public:
+    explicit ArchiveOutput(const std::string& dir) : archive(dir) {}
+    void ticks(const std::string& symbol, const TickSeries& t) override { archive.append(symbol, t); }
+    void bars(const std::string&, const BarSeries&) override {
+        throw std::logic_error("The tick archive stores ticks only.");
+    }
+    void flush() override { archive.flush(); }
+    void close() override { archive.flush(); }
+    uint64_t bytes() const override { return archive.bytesWritten(); }
+
+private:
+    TickArchiveWriter archive;
+};
+
+// One Arrow file per symbol. Arrow files cannot be appended to, so a resumed run
+// writes "<SYMBOL>_<kind>.<n>.arrow" next to the earlier parts.
+class ArrowOutput : public Output {
+public:
+    ArrowOutput(const std::string& dir, const std::string& suffix, ArrowFileWriter::Layout layout)
+        : dir(dir), suffix(suffix), layout(layout) {}
+
+    void ticks(const std::string& symbol, const TickSeries& t) override { writer(symbol).write(t); }
+    void bars(const std::string& symbol, const BarSeries& b) override { writer(symbol).write(b); }
+
+    void close() override {
+        for (auto& kv : writers) {
+            kv.second->close();
+            closedBytes += kv.second->bytesWritten();
+        }
+        writers.clear();
+    }
+
+    uint64_t bytes() const override {
+        uint64_t n = closedBytes;
+        for (const auto& kv : writers) n += kv.second->bytesWritten();
+        return n;
+    }
+
+private:
+    std::string dir;
+    std::string suffix;
+    ArrowFileWriter::Layout layout;
+    std::map<std::string, std::unique_ptr<ArrowFileWriter>> writers;
+    uint64_t closedBytes = 0;
+
+    ArrowFileWriter& writer(const std::string& symbol) {
+        auto it = writers.find(symbol);
+        if (it != writers.end()) return *it->second;
+        std::string base = dir + "/" + symbol + suffix;
+        std::string path = base + ".arrow";
+        for (int part = 1; std::FILE* existing = std::fopen(path.c_str(), "rb"); ++part) {
+            std::fclose(existing);
+            path = base + "." + std::to_string(part) + ".arrow";
+        }
+        std::unique_ptr<ArrowFileWriter> w(new ArrowFileWriter(path, layout));
+        ArrowFileWriter& ref = *w;
+        writers[symbol] = std::move(w);
+        return ref;
+    }
+};
+
+// --- Daily historical rates: one /historical call per day covers every symbol. ---
+
+BackfillEngine::Report fetchHistorical(TraderMade& tm, const Options& o, int64_t start, int64_t end, Output& out,
+                                       const CancellationToken& cancelled) {
+    const int64_t DAY = 86400000;
+    std::vector<int64_t> days;
+    for (int64_t d = start - ((start % DAY) + DAY) % DAY; d < end; d += DAY) days.push_back(d);
+
+    std::string currency;
+    for (const std::string& s : o.symbols) currency += (currency.empty() ? "" : ",") + s;
+
+    BackfillEngine::Report report;
+    report.tasks = days.size();
+    std::vector<std::map<std::string, BarSeries>> results(days.size());
+    std::vector<char> finished(days.size(), 0);
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    size_t delivered = 0;
+    const auto spacing = o.rate > 0 ? std::chrono::duration<double>(1.0 / o.rate) : std::chrono::duration<double>(0);
+    Clock::time_point slot = Clock::now();
+    const Clock::time_point started = Clock::now();
+
+    auto worker = [&] {
+        CancellationScope scope(cancelled);
+        for (size_t i; !cancelled.cancelled() && (i = next.fetch_add(1)) < days.size();) {
+            Result<nlohmann::json> body = RequestError{ErrorCode::Cancelled, 0, ""};
+            for (int attempt = 1; attempt <= o.attempts && !cancelled.cancelled(); ++attempt) {
+                if (o.rate > 0) {
+                    Clock::time_point at;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        slot = std::max(slot, Clock::now());
+                        at = slot;
+                        slot += std::chrono::duration_cast<Clock::duration>(spacing);
+                    }
+                    if (cancelled.waitFor(at - std::min(at, Clock::now()))) break;
+                }
+                Clock::time_point sent = Clock::now();
+                body = tm.tryGetHistoricalRates(formatApiTime(days[i], false), currency);
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - sent).count();
+                std::lock_guard<std::mutex> lock(mutex);
+                report.requestMs.push_back(ms);
+                if (body) break;
+                const RequestError& e = body.error();
+                bool retry = e.code == ErrorCode::Transport ||
+                             (e.code == ErrorCode::HttpStatus && (e.status == 429 || e.status >= 500));
+                if (!retry || attempt == o.attempts) break;
+                ++report.retries;
+            }
+            if (cancelled.cancelled()) break; // the day stays undelivered
+            std::map<std::string, BarSeries> bars;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!body) {
+                report.errors.push_back(formatApiTime(days[i], false) + ": " + body.error().message);
+                finished[i] = 2;
+            } else {
+                const nlohmann::json& quotes = body.value().value("quotes", nlohmann::json::array());
+                for (const nlohmann::json& q : quotes) {
+                    if (!q.is_object() || q.contains("error")) continue;
+                    std::string symbol = q.value("instrument", q.value("base_currency", std::string()) +
+                                                                   q.value("quote_currency", std::string()));
+                    double close = q.value("close", 0.0);
+                    bars[symbol].push_back(days[i], q.value("open", close), q.value("high", close),
+                                           q.value("low", close), close);
+                }
+                results[i] = std::move(bars);
+                finished[i] = 1;
+            }
+            // Deliver in date order, like BackfillEngine does per symbol.
+            while (delivered < days.size() && finished[delivered]) {
+                if (finished[delivered] == 1) {
+                    for (const auto& kv : results[delivered]) {
+                        out.bars(kv.first, kv.second);
+                        report.rows += kv.second.size();
+                    }
+                    ++report.completed;
+                }
+                results[delivered].clear();
+                ++delivered;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < std::min<int>(o.threads, static_cast<int>(days.size())); ++t) threads.emplace_back(worker);
+    for (std::thread& t : threads) t.join();
+    report.failed = report.tasks - report.completed;
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started);
+    return report;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void printReport(const Options& o, const BackfillEngine::Report& r, uint64_t bytes) {
+    std::vector<double> latency = r.requestMs;
+    std::sort(latency.begin(), latency.end());
+    double seconds = std::max(1e-9, r.elapsed.count() / 1000.0);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "tmfetch " << o.kind << " -> " << o.format << " (" << o.out << ")\n";
+    std::cout << "  symbols      " << o.symbols.size() << "\n";
+    std::cout << "  chunks       " << r.tasks << " scheduled, " << r.completed << " done, " << r.failed << " failed, "
+              << r.skippedClosed << " closed, " << r.resumed << " resumed\n";
+    std::cout << "  requests     " << latency.size() << " (" << r.retries << " retries, " << r.steals << " steals)\n";
+    std::cout << "  rows         " << r.rows << "\n";
+    std::cout << "  elapsed      " << seconds << " s\n";
+    std::cout << "  throughput   " << latency.size() / seconds << " req/s, " << r.rows / seconds << " rows/s, "
+              << bytes / seconds / (1024.0 * 1024.0) << " MiB/s written (" << bytes / (1024.0 * 1024.0)
+              << " MiB)\n";
+    std::cout << std::setprecision(2);
+    std::cout << "  latency ms   p50 " << percentile(latency, 0.50) << "  p90 " << percentile(latency, 0.90)
+              << "  p99 " << percentile(latency, 0.99) << "  max " << (latency.empty() ? 0.0 : latency.back())
+              << "\n";
+    for (const std::string& s : r.failedSymbols) std::cout << "  failed       " << s << "\n";
+    for (size_t i = 0; i < r.errors.size() && i < 10; ++i) std::cout << "  error        " << r.errors[i] << "\n";
+    if (r.errors.size() > 10) std::cout << "  ...          " << r.errors.size() - 10 << " more errors\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    int64_t start = 0;
+    int64_t end = 0;
+    try {
+        o = parseOptions(argc, argv);
+        start = parseTime(o.start, "--start");
+        end = parseTime(o.end, "--end");
+        if (end <= start) throw std::invalid_argument("--end must be after --start.");
+        if (o.kind == "timeseries" && !isValidTimeSeriesPeriod(parseInterval(o.interval), o.period)) {
+            throw std::invalid_argument("--period is not valid for --interval=" + o.interval + ".");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "tmfetch: " << e.what() << "\n\n";
+        printUsage();
+        return 2;
+    }
+
+    try {
+        TraderMade tm;
+        if (!o.baseUrl.empty()) tm.setBaseUrl(o.baseUrl);
+        tm.setRestApiKey(o.apiKey);
+
+        makeDirectory(o.out);
+        const bool ticks = o.kind == "ticks";
+        const bool intraday = o.kind == "timeseries" && o.interval != "daily";
+        std::string suffix = ticks ? "_ticks" : o.kind == "historical" ? "_historical"
+                                                                       : "_" + o.interval + std::to_string(o.period);
+        std::unique_ptr<Output> out;
+        if (o.format == "csv") {
+            out.reset(new CsvOutput(o.out, suffix, intraday));
+        } else if (o.format == "archive") {
+            out.reset(new ArchiveOutput(o.out));
+        } else {
+            out.reset(new ArrowOutput(o.out, suffix, ticks ? ArrowFileWriter::Layout::Ticks : ArrowFileWriter::Layout::Bars));
+        }
+
+        // Signals go to a thread that cancels the download (cancelling is not
+        // async-signal-safe). A second Ctrl-C exits at once.
+        CancellationToken cancelled;
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        std::thread([signals, cancelled] {
+            int signal = 0;
+            sigwait(&signals, &signal);
+            cancelled.cancel();
+            sigwait(&signals, &signal);
+            std::_Exit(130);
+        }).detach();
+
+        BackfillEngine::Report report;
+        if (o.kind == "historical") {
+            report = fetchHistorical(tm, o, start, end, *out, cancelled);
+        } else {
+            BackfillEngine::Options options;
+            options.threads = static_cast<size_t>(o.threads);
+            options.requestsPerSecond = o.rate;
+            options.maxAttempts = o.attempts;
+            options.checkpointPath = o.checkpoint;
+            Output* sink = out.get();
+            options.beforeCheckpoint = [sink] { sink->flush(); };
+            BackfillEngine engine(tm, options);
+            BackfillEngine::Job job{o.symbols, start, end};
+            if (ticks) {
+                report = engine.runTicks(job, [sink](const std::string& s, const TickSeries& t) { sink->ticks(s, t); },
+                                        cancelled);
+            } else {
+                job.interval = parseInterval(o.interval);
+                job.period = o.period;
+                report = engine.runBars(job, [sink](const std::string& s, const BarSeries& b) { sink->bars(s, b); },
+                                       cancelled);
+            }
+        }
+        out->close();
+        printReport(o, report, out->bytes());
+        if (cancelled.cancelled()) {
+            std::cerr << "tmfetch: interrupted" << (o.checkpoint.empty() ? "" : "; rerun to resume") << "\n";
+            return 130;
+        }
+        return report.failed == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "tmfetch: " << e.what() << "\n";
+        return 1;
+    }
+}